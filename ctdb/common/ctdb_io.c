@@ -269,6 +269,32 @@ static void queue_dead(struct tevent_context *ev, struct tevent_immediate *im,
 }
 
 
+/*
+  maximum number of queued packets handed to a single writev()
+*/
+#define CTDB_QUEUE_MAX_IOV MIN(IOV_MAX, 64)
+
+/*
+  write as many queued packets as possible with a single writev(),
+  returning the number of bytes written
+*/
+static ssize_t queue_io_writev(struct ctdb_queue *queue)
+{
+	struct iovec iov[CTDB_QUEUE_MAX_IOV];
+	struct ctdb_queue_pkt *pkt;
+	int count = 0;
+
+	for (pkt = queue->out_queue;
+	     pkt != NULL && count < CTDB_QUEUE_MAX_IOV;
+	     pkt = pkt->next) {
+		iov[count].iov_base = pkt->data;
+		iov[count].iov_len = pkt->length;
+		count += 1;
+	}
+
+	return writev(queue->fd, iov, count);
+}
+
 /*
   called when an incoming connection is writeable
 */
@@ -280,7 +306,7 @@ static void queue_io_write(struct ctdb_queue *queue)
 		if (queue->ctdb->flags & CTDB_FLAG_TORTURE) {
 			n = write(queue->fd, pkt->data, 1);
 		} else {
-			n = write(queue->fd, pkt->data, pkt->length);
+			n = queue_io_writev(queue);
 		}
 
 		if (n == -1 && errno != EAGAIN && errno != EWOULDBLOCK) {
@@ -297,16 +323,35 @@ static void queue_io_write(struct ctdb_queue *queue)
 			return;
 		}
 		if (n <= 0) return;
-		
-		if (n != pkt->length) {
+
+		/* release all packets that were completely written */
+		while (n >= pkt->length) {
+			n -= pkt->length;
+			DLIST_REMOVE(queue->out_queue, pkt);
+			queue->out_queue_length--;
+			talloc_free(pkt);
+
+			pkt = queue->out_queue;
+			if (pkt == NULL) {
+				break;
+			}
+		}
+
+		if (n > 0) {
 			pkt->length -= n;
 			pkt->data += n;
 			return;
 		}
-
-		DLIST_REMOVE(queue->out_queue, pkt);
-		queue->out_queue_length--;
-		talloc_free(pkt);
+		if (pkt != NULL) {
+			/*
+			 * Everything written ended on a packet
+			 * boundary, but packets are still queued:
+			 * either the write was short or there were
+			 * more than CTDB_QUEUE_MAX_IOV packets.  Send
+			 * the rest when the fd is writeable again.
+			 */
+			return;
+		}
 	}
 
 	TEVENT_FD_NOT_WRITEABLE(queue->fde);
@@ -148,6 +148,37 @@ int hash_count_increment(struct hash_count_context *hcount, TDB_DATA key)
 	return ret;
 }
 
+int hash_count_get(struct hash_count_context *hcount, TDB_DATA key,
+		   uint64_t *counter)
+{
+	struct hash_count_value value;
+	struct timeval current_time = timeval_current();
+	struct timeval tmp_t;
+	int ret;
+
+	if (hcount == NULL || counter == NULL) {
+		return EINVAL;
+	}
+
+	ret = hash_count_fetch(hcount, key, &value);
+	if (ret == ENOENT) {
+		*counter = 0;
+		return 0;
+	}
+	if (ret != 0) {
+		return ret;
+	}
+
+	tmp_t = timeval_sum(&value.update_time, &hcount->update_interval);
+	if (timeval_compare(&current_time, &tmp_t) < 0) {
+		*counter = value.counter;
+	} else {
+		*counter = 0;
+	}
+
+	return 0;
+}
+
 static struct timeval timeval_subtract(const struct timeval *tv1,
 				       const struct timeval *tv2)
 {
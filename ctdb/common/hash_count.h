@@ -80,6 +80,20 @@ int hash_count_init(TALLOC_CTX *mem_ctx, struct timeval count_interval,
  */
 int hash_count_increment(struct hash_count_context *hcount, TDB_DATA key);
 
+/**
+ * @brief Get the current counter for a key
+ *
+ * If there have been no events for the key during the current
+ * count_interval, the counter is 0.
+ *
+ * @param[in] hcount The hash count context
+ * @param[in] key The key for which counter is fetched
+ * @param[out] counter The number of events in the current count interval
+ * @return 0 on success, errno on failure
+ */
+int hash_count_get(struct hash_count_context *hcount, TDB_DATA key,
+		   uint64_t *counter);
+
 /**
  * @brief Remove keys for which count interval has elapsed
  *
@@ -162,6 +162,10 @@ static struct {
 		offsetof(struct ctdb_tunable_list, ip_alloc_algorithm) },
 	{ "AllowMixedVersions", 0, false,
 		offsetof(struct ctdb_tunable_list, allow_mixed_versions) },
+	{ "MigrationsMakeReadOnly", 0, false,
+		offsetof(struct ctdb_tunable_list, migrations_make_readonly) },
+	{ "VacuumFastPathLimit", 0, false,
+		offsetof(struct ctdb_tunable_list, vacuum_fast_path_limit) },
 	{ .obsolete = true, }
 };
 
@@ -530,6 +530,9 @@ int ctdb_add_revoke_deferred_call(struct ctdb_context *ctdb,
 
 int ctdb_migration_init(struct ctdb_db_context *ctdb_db);
 
+bool ctdb_db_readonly_hot_record(struct ctdb_db_context *ctdb_db,
+				 TDB_DATA key);
+
 /* from server/ctdb_control.c */
 
 int32_t ctdb_dump_memory(struct ctdb_context *ctdb, TDB_DATA *outdata);
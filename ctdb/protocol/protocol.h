@@ -664,6 +664,8 @@ struct ctdb_tunable_list {
 	uint32_t queue_buffer_size;
 	uint32_t ip_alloc_algorithm;
 	uint32_t allow_mixed_versions;
+	uint32_t migrations_make_readonly;
+	uint32_t vacuum_fast_path_limit;
 };
 
 struct ctdb_tickle_list {
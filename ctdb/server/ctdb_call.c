@@ -986,7 +986,8 @@ void ctdb_request_call(struct ctdb_context *ctdb, struct ctdb_req_header *hdr)
 	}
 
 	/* Dont do READONLY if we don't have a tracking database */
-	if ((c->flags & CTDB_WANT_READONLY) && !ctdb_db_readonly(ctdb_db)) {
+	if ((c->flags & CTDB_WANT_READONLY) &&
+	    !ctdb_db_readonly_hot_record(ctdb_db, call->key)) {
 		c->flags &= ~CTDB_WANT_READONLY;
 	}
 
@@ -2051,6 +2052,72 @@ static void ctdb_migration_cleandb_event(struct tevent_context *ev,
 	}
 }
 
+/*
+ * Check if read-only delegations can be used for a record.  If the
+ * database does not support them yet, but the record is being migrated
+ * often enough to be considered hot, then enable them.
+ */
+bool ctdb_db_readonly_hot_record(struct ctdb_db_context *ctdb_db,
+				 TDB_DATA key)
+{
+	struct ctdb_context *ctdb = ctdb_db->ctdb;
+	uint64_t count = 0;
+	TDB_DATA indata;
+	int ret;
+
+	if (ctdb_db_readonly(ctdb_db)) {
+		return true;
+	}
+
+	if (ctdb->tunable.migrations_make_readonly == 0 ||
+	    ctdb_db->migratedb == NULL) {
+		return false;
+	}
+
+	ret = hash_count_get(ctdb_db->migratedb, key, &count);
+	if (ret != 0) {
+		return false;
+	}
+
+	if (count < ctdb->tunable.migrations_make_readonly) {
+		return false;
+	}
+
+	D_NOTICE("Record in %s migrated %"PRIu64" times in a second, "
+		 "enabling readonly records\n",
+		 ctdb_db->db_name,
+		 count);
+
+	ret = ctdb_set_db_readonly(ctdb, ctdb_db);
+	if (ret != 0) {
+		return false;
+	}
+
+	/*
+	 * Like "ctdb setdbreadonly", enable it on all the nodes, so
+	 * the record can be delegated wherever it is hosted next
+	 */
+	indata.dptr = (uint8_t *)&ctdb_db->db_id;
+	indata.dsize = sizeof(ctdb_db->db_id);
+
+	ret = ctdb_daemon_send_control(ctdb,
+				       CTDB_BROADCAST_CONNECTED,
+				       0,
+				       CTDB_CONTROL_SET_DB_READONLY,
+				       0,
+				       CTDB_CTRL_FLAG_NOREPLY,
+				       indata,
+				       NULL,
+				       NULL);
+	if (ret != 0) {
+		D_ERR("Failed to enable readonly records for %s "
+		      "on the other nodes\n",
+		      ctdb_db->db_name);
+	}
+
+	return true;
+}
+
 int ctdb_migration_init(struct ctdb_db_context *ctdb_db)
 {
 	struct timeval one_second = { 1, 0 };
@@ -805,7 +805,8 @@ static void daemon_request_call_from_client(struct ctdb_client *client,
 	}
 
 	/* Dont do READONLY if we don't have a tracking database */
-	if ((c->flags & CTDB_WANT_READONLY) && !ctdb_db_readonly(ctdb_db)) {
+	if ((c->flags & CTDB_WANT_READONLY) &&
+	    !ctdb_db_readonly_hot_record(ctdb_db, key)) {
 		c->flags &= ~CTDB_WANT_READONLY;
 	}
 
@@ -41,6 +41,8 @@
  * 1. Create a child process to do blocking locks.
  * 2. Once the locks are obtained, signal parent process via fd.
  * 3. Invoke registered callback routine with locking status.
+ *    Other requests for the same record do not get their own child,
+ *    their callbacks are invoked while the lock is still held.
  * 4. If the child process cannot get locks within certain time,
  *    execute an external script to debug.
  *
@@ -235,6 +237,79 @@ static int ctdb_lock_request_destructor(struct lock_request *lock_request)
 	return 0;
 }
 
+static void ctdb_lock_update_stats(struct lock_context *lock_ctx,
+				   bool locked);
+
+/*
+ * Check if two lock contexts are for the same record
+ */
+static bool lock_context_same_key(struct lock_context *a,
+				  struct lock_context *b)
+{
+	if (a->key_hash != b->key_hash) {
+		return false;
+	}
+	if (a->key.dsize != b->key.dsize) {
+		return false;
+	}
+	if (a->key.dsize == 0) {
+		return true;
+	}
+	return (memcmp(a->key.dptr, b->key.dptr, a->key.dsize) == 0);
+}
+
+/*
+ * While a record lock is held, also run the callbacks for other
+ * requests queued on the same record, so a single lock helper serves
+ * every client waiting for a contended record.
+ */
+static void process_record_waiters(struct lock_context *lock_ctx)
+{
+	struct ctdb_db_context *ctdb_db = lock_ctx->ctdb_db;
+	struct lock_context *waiter;
+	uint32_t max_waiters = 0;
+
+	/*
+	 * Callbacks may queue new lock requests, so only serve as
+	 * many as were waiting when the lock was obtained
+	 */
+	for (waiter = ctdb_db->lock_pending; waiter != NULL;
+	     waiter = waiter->next) {
+		max_waiters++;
+	}
+
+	while (max_waiters > 0) {
+		struct lock_request *request;
+
+		/*
+		 * The callback may change the pending queue, so always
+		 * search from the head
+		 */
+		for (waiter = ctdb_db->lock_pending; waiter != NULL;
+		     waiter = waiter->next) {
+			if (waiter->request != NULL &&
+			    waiter->auto_mark &&
+			    lock_context_same_key(lock_ctx, waiter)) {
+				break;
+			}
+		}
+		if (waiter == NULL) {
+			break;
+		}
+		max_waiters--;
+
+		ctdb_lock_update_stats(waiter, true);
+
+		request = waiter->request;
+		request->lctx = NULL;
+		waiter->request = NULL;
+
+		request->callback(request->private_data, true);
+
+		talloc_free(waiter);
+	}
+}
+
 /*
  * Process all the callbacks waiting for lock
  *
@@ -277,6 +352,7 @@ static void process_callbacks(struct lock_context *lock_ctx, bool locked)
 	if (locked) {
 		switch (lock_ctx->type) {
 		case LOCK_RECORD:
+			process_record_waiters(lock_ctx);
 			tdb_chainlock_unmark(lock_ctx->ctdb_db->ltdb->tdb, lock_ctx->key);
 			break;
 
@@ -334,17 +410,12 @@ static void ctdb_lock_handler(struct tevent_context *ev,
 	struct lock_context *lock_ctx;
 	char c;
 	bool locked;
-	double t;
-	int id;
 
 	lock_ctx = talloc_get_type_abort(private_data, struct lock_context);
 
 	/* cancel the timeout event */
 	TALLOC_FREE(lock_ctx->ttimer);
 
-	t = timeval_elapsed(&lock_ctx->start_time);
-	id = lock_bucket_id(t);
-
 	/* Read the status from the child process */
 	if (sys_read(lock_ctx->fd[0], &c, 1) != 1) {
 		locked = false;
@@ -352,6 +423,23 @@ static void ctdb_lock_handler(struct tevent_context *ev,
 		locked = (c == 0 ? true : false);
 	}
 
+	ctdb_lock_update_stats(lock_ctx, locked);
+
+	process_callbacks(lock_ctx, locked);
+}
+
+/*
+ * Update lock statistics when a lock request completes
+ */
+static void ctdb_lock_update_stats(struct lock_context *lock_ctx,
+				   bool locked)
+{
+	double t;
+	int id;
+
+	t = timeval_elapsed(&lock_ctx->start_time);
+	id = lock_bucket_id(t);
+
 	/* Update statistics */
 	CTDB_INCREMENT_STAT(lock_ctx->ctdb, locks.num_calls);
 	CTDB_INCREMENT_DB_STAT(lock_ctx->ctdb_db, locks.num_calls);
@@ -368,8 +456,6 @@ static void ctdb_lock_handler(struct tevent_context *ev,
 		CTDB_INCREMENT_STAT(lock_ctx->ctdb, locks.num_failed);
 		CTDB_INCREMENT_DB_STAT(lock_ctx->ctdb_db, locks.num_failed);
 	}
-
-	process_callbacks(lock_ctx, locked);
 }
 
 struct lock_log_entry {
@@ -692,6 +778,23 @@ static bool lock_helper_args(TALLOC_CTX *mem_ctx,
 	return true;
 }
 
+/*
+ * Check if there is already a lock helper waiting for this record
+ */
+static bool lock_context_key_is_current(struct lock_context *lock_ctx)
+{
+	struct lock_context *cur;
+
+	for (cur = lock_ctx->ctdb_db->lock_current; cur != NULL;
+	     cur = cur->next) {
+		if (lock_context_same_key(lock_ctx, cur)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 /*
  * Find a lock request that can be scheduled
  */
@@ -733,6 +836,16 @@ static struct lock_context *ctdb_find_lock_context(struct ctdb_context *ctdb)
 			next_ctx = lock_ctx->next;
 
 			if (lock_ctx->request != NULL) {
+				/*
+				 * Do not start another helper for a
+				 * record that is already being locked,
+				 * it will be served when that lock is
+				 * obtained
+				 */
+				if (lock_ctx->auto_mark &&
+				    lock_context_key_is_current(lock_ctx)) {
+					continue;
+				}
 				return lock_ctx;
 			}
 
@@ -526,6 +526,20 @@ struct recdb_add_traverse_state {
 	uint32_t mypnn;
 };
 
+static int recdb_header_parser(TDB_DATA key, TDB_DATA data,
+			       void *private_data)
+{
+	struct ctdb_ltdb_header *header =
+		(struct ctdb_ltdb_header *)private_data;
+
+	if (data.dsize < sizeof(struct ctdb_ltdb_header)) {
+		return -1;
+	}
+
+	*header = *(struct ctdb_ltdb_header *)data.dptr;
+	return 0;
+}
+
 static int recdb_add_traverse(uint32_t reqid, struct ctdb_ltdb_header *header,
 			      TDB_DATA key, TDB_DATA data,
 			      void *private_data)
@@ -533,7 +547,7 @@ static int recdb_add_traverse(uint32_t reqid, struct ctdb_ltdb_header *header,
 	struct recdb_add_traverse_state *state =
 		(struct recdb_add_traverse_state *)private_data;
 	struct ctdb_ltdb_header *hdr;
-	TDB_DATA prev_data;
+	struct ctdb_ltdb_header prev_hdr;
 	int ret;
 
 	/* header is not marshalled separately in the pulldb control */
@@ -543,14 +557,13 @@ static int recdb_add_traverse(uint32_t reqid, struct ctdb_ltdb_header *header,
 
 	hdr = (struct ctdb_ltdb_header *)data.dptr;
 
-	/* fetch the existing record, if any */
-	prev_data = tdb_fetch(recdb_tdb(state->recdb), key);
-
-	if (prev_data.dptr != NULL) {
-		struct ctdb_ltdb_header prev_hdr;
-
-		prev_hdr = *(struct ctdb_ltdb_header *)prev_data.dptr;
-		free(prev_data.dptr);
+	/*
+	 * Only the header of the existing record, if any, is needed,
+	 * so avoid copying the whole record
+	 */
+	ret = tdb_parse_record(recdb_tdb(state->recdb), key,
+			       recdb_header_parser, &prev_hdr);
+	if (ret == 0) {
 		if (hdr->rsn < prev_hdr.rsn ||
 		    (hdr->rsn == prev_hdr.rsn &&
 		     prev_hdr.dmaster != state->mypnn)) {
@@ -1357,8 +1370,13 @@ struct collect_all_db_state {
 	uint32_t db_id;
 	struct recdb_context *recdb;
 
-	struct ctdb_pulldb pulldb;
-	unsigned int index;
+	unsigned int num_replies;
+	int err;
+};
+
+struct collect_all_db_one_state {
+	struct tevent_req *req;
+	uint32_t pnn;
 };
 
 static void collect_all_db_pulldb_done(struct tevent_req *subreq);
@@ -1373,6 +1391,7 @@ static struct tevent_req *collect_all_db_send(
 {
 	struct tevent_req *req, *subreq;
 	struct collect_all_db_state *state;
+	unsigned int i;
 
 	req = tevent_req_create(mem_ctx, &state,
 				struct collect_all_db_state);
@@ -1385,25 +1404,45 @@ static struct tevent_req *collect_all_db_send(
 	state->nlist = nlist;
 	state->db_id = db_id;
 	state->recdb = recdb;
-	state->index = 0;
+	state->num_replies = 0;
+	state->err = 0;
 
-	subreq = pull_database_send(state,
-				    ev,
-				    client,
-				    nlist->pnn_list[state->index],
-				    recdb);
-	if (tevent_req_nomem(subreq, req)) {
-		return tevent_req_post(req, ev);
+	/*
+	 * Pull from all the nodes at the same time.  The records are
+	 * merged into recdb as each buffer arrives, keeping the copy
+	 * with the highest RSN.
+	 */
+	for (i = 0; i < nlist->count; i++) {
+		struct collect_all_db_one_state *substate;
+
+		substate = talloc_zero(state, struct collect_all_db_one_state);
+		if (tevent_req_nomem(substate, req)) {
+			return tevent_req_post(req, ev);
+		}
+
+		substate->req = req;
+		substate->pnn = nlist->pnn_list[i];
+
+		subreq = pull_database_send(state,
+					    ev,
+					    client,
+					    substate->pnn,
+					    recdb);
+		if (tevent_req_nomem(subreq, req)) {
+			return tevent_req_post(req, ev);
+		}
+		tevent_req_set_callback(subreq, collect_all_db_pulldb_done,
+					substate);
 	}
-	tevent_req_set_callback(subreq, collect_all_db_pulldb_done, req);
 
 	return req;
 }
 
 static void collect_all_db_pulldb_done(struct tevent_req *subreq)
 {
-	struct tevent_req *req = tevent_req_callback_data(
-		subreq, struct tevent_req);
+	struct collect_all_db_one_state *substate = tevent_req_callback_data(
+		subreq, struct collect_all_db_one_state);
+	struct tevent_req *req = substate->req;
 	struct collect_all_db_state *state = tevent_req_data(
 		req, struct collect_all_db_state);
 	int ret;
@@ -1412,27 +1451,29 @@ static void collect_all_db_pulldb_done(struct tevent_req *subreq)
 	status = pull_database_recv(subreq, &ret);
 	TALLOC_FREE(subreq);
 	if (! status) {
-		node_list_ban_credits(state->nlist,
-				      state->nlist->pnn_list[state->index]);
-		tevent_req_error(req, ret);
-		return;
+		node_list_ban_credits(state->nlist, substate->pnn);
+		if (state->err == 0) {
+			state->err = ret;
+		}
 	}
 
-	state->index += 1;
-	if (state->index == state->nlist->count) {
-		tevent_req_done(req);
+	talloc_free(substate);
+
+	/*
+	 * Wait for all the pulls to finish, so no message handler
+	 * is left registered for a freed request
+	 */
+	state->num_replies += 1;
+	if (state->num_replies < state->nlist->count) {
 		return;
 	}
 
-	subreq = pull_database_send(state,
-				    state->ev,
-				    state->client,
-				    state->nlist->pnn_list[state->index],
-				    state->recdb);
-	if (tevent_req_nomem(subreq, req)) {
+	if (state->err != 0) {
+		tevent_req_error(req, state->err);
 		return;
 	}
-	tevent_req_set_callback(subreq, collect_all_db_pulldb_done, req);
+
+	tevent_req_done(req);
 }
 
 static bool collect_all_db_recv(struct tevent_req *req, int *perr)
@@ -76,6 +76,7 @@ struct vacuum_data {
 	struct timeval start;
 	bool traverse_error;
 	bool vacuum;
+	bool delete_queue_limited;
 	struct {
 		struct {
 			uint32_t added_to_vacuum_fetch_list;
@@ -525,6 +526,16 @@ static int delete_queue_traverse(void *param, void *data)
 	struct ctdb_ltdb_header header;
 	uint32_t lmaster;
 	uint32_t hash = ctdb_hash(&(dd->key));
+	uint32_t limit = ctdb->tunable.vacuum_fast_path_limit;
+
+	if (limit != 0 && vdata->count.delete_queue.total >= limit) {
+		/*
+		 * The remaining records are kept in the parent's
+		 * delete queue for the next run.
+		 */
+		vdata->delete_queue_limited = true;
+		return -1;
+	}
 
 	vdata->count.delete_queue.total++;
 
@@ -751,7 +762,7 @@ static void ctdb_process_delete_queue(struct ctdb_db_context *ctdb_db,
 	ret = trbt_traversearray32(ctdb_db->delete_queue, 1,
 				   delete_queue_traverse, vdata);
 
-	if (ret != 0) {
+	if (ret != 0 && !vdata->delete_queue_limited) {
 		DEBUG(DEBUG_ERR, (__location__ " Error traversing "
 		      "the delete queue.\n"));
 	}
@@ -1387,6 +1398,88 @@ static void vacuum_child_handler(struct tevent_context *ev,
 	talloc_free(child_ctx);
 }
 
+struct delete_queue_batch {
+	struct delete_record_data **records;
+	uint32_t count;
+	uint32_t limit;
+};
+
+static int delete_queue_count_traverse(void *param, void *data)
+{
+	uint32_t *count = (uint32_t *)param;
+
+	*count += 1;
+	return 0;
+}
+
+static int delete_queue_batch_traverse(void *param, void *data)
+{
+	struct delete_queue_batch *batch =
+		(struct delete_queue_batch *)param;
+
+	if (batch->count >= batch->limit) {
+		return -1;
+	}
+
+	batch->records[batch->count] =
+		talloc_get_type_abort(data, struct delete_record_data);
+	batch->count += 1;
+	return 0;
+}
+
+/*
+ * Remove the records handed to a vacuum child from the delete queue.
+ *
+ * If VacuumFastPathLimit is set, the child only processes the first
+ * records of the delete queue (in traverse order).  Only those are
+ * removed here, the rest stays queued for the next run.
+ */
+static int delete_queue_remove_batch(struct ctdb_db_context *ctdb_db)
+{
+	struct delete_queue_batch batch = {
+		.limit = ctdb_db->ctdb->tunable.vacuum_fast_path_limit,
+	};
+	uint32_t queued = 0;
+	uint32_t i;
+
+	if (batch.limit != 0) {
+		trbt_traversearray32(ctdb_db->delete_queue, 1,
+				     delete_queue_count_traverse, &queued);
+	}
+
+	if (queued <= batch.limit) {
+		talloc_free(ctdb_db->delete_queue);
+		ctdb_db->delete_queue = trbt_create(ctdb_db, 0);
+		if (ctdb_db->delete_queue == NULL) {
+			return ENOMEM;
+		}
+		return 0;
+	}
+
+	batch.records = talloc_array(ctdb_db,
+				     struct delete_record_data *,
+				     batch.limit);
+	if (batch.records == NULL) {
+		return ENOMEM;
+	}
+
+	trbt_traversearray32(ctdb_db->delete_queue, 1,
+			     delete_queue_batch_traverse, &batch);
+
+	for (i = 0; i < batch.count; i++) {
+		talloc_free(batch.records[i]);
+	}
+	talloc_free(batch.records);
+
+	D_INFO("Vacuuming %"PRIu32" of %"PRIu32" records marked for "
+	       "deletion in %s\n",
+	       batch.count,
+	       queued,
+	       ctdb_db->db_name);
+
+	return 0;
+}
+
 /*
  * this event is called every time we need to start a new vacuum process
  */
@@ -1477,9 +1570,8 @@ static int vacuum_db_child(TALLOC_CTX *mem_ctx,
 	/*
 	 * Clear the fastpath vacuuming list in the parent.
 	 */
-	talloc_free(ctdb_db->delete_queue);
-	ctdb_db->delete_queue = trbt_create(ctdb_db, 0);
-	if (ctdb_db->delete_queue == NULL) {
+	ret = delete_queue_remove_batch(ctdb_db);
+	if (ret != 0) {
 		DBG_ERR("Out of memory when re-creating vacuum tree\n");
 		return ENOMEM;
 	}
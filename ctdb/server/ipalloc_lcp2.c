@@ -68,90 +68,120 @@ static uint32_t ip_distance(ctdb_sock_addr *ip1, ctdb_sock_addr *ip2)
 	return distance;
 }
 
-/* Calculate the IP distance for the given IP relative to IPs on the
-   given node.  The ips argument is generally the all_ips variable
-   used in the main part of the algorithm.
+/*
+ * The LCP2 algorithm repeatedly needs the sum of the squared distances
+ * between an address and all of the addresses on a given node.  These
+ * sums are cached for every address/node combination in a flat array,
+ * indexed by the position of the address in all_ips.  When an address
+ * is assigned to a node (or moved between nodes) only the sums for the
+ * nodes involved need to be updated, instead of recalculating the
+ * sums for each candidate move.
+ *
+ * The distance between an address and itself is never included.  This
+ * allows us to calculate the effect of removing an address from a node
+ * by simply looking up the sum for the node it is on.
  */
-static uint32_t ip_distance_2_sum(ctdb_sock_addr *ip,
-				  struct public_ip_list *ips,
-				  unsigned int pnn)
-{
-	struct public_ip_list *t;
-	uint32_t d;
-
-	uint32_t sum = 0;
-
-	for (t = ips; t != NULL; t = t->next) {
-		if (t->pnn != pnn) {
-			continue;
-		}
-
-		/* Optimisation: We never calculate the distance
-		 * between an address and itself.  This allows us to
-		 * calculate the effect of removing an address from a
-		 * node by simply calculating the distance between
-		 * that address and all of the existing addresses.
-		 * Moreover, we assume that we're only ever dealing
-		 * with addresses from all_ips so we can identify an
-		 * address via a pointer rather than doing a more
-		 * expensive address comparison. */
-		if (&(t->addr) == ip) {
-			continue;
-		}
-
-		d = ip_distance(ip, &(t->addr));
-		sum += d * d;  /* Cheaper than pulling in math.h :-) */
-	}
+struct lcp2_dsums {
+	uint32_t *sum;
+	unsigned int numnodes;
+};
 
-	return sum;
+static uint32_t *lcp2_dsum(struct lcp2_dsums *dsums,
+			   unsigned int ip_index,
+			   unsigned int pnn)
+{
+	return &dsums->sum[ip_index * dsums->numnodes + pnn];
 }
 
-/* Return the LCP2 imbalance metric for addresses currently assigned
-   to the given node.
+/* Update the cached distance sums after moving the given IP from
+ * srcnode to dstnode.  srcnode is CTDB_UNKNOWN_PNN for an IP that was
+ * previously unassigned.
  */
-static uint32_t lcp2_imbalance(struct public_ip_list * all_ips,
-			       unsigned int pnn)
+static void lcp2_dsums_move(struct lcp2_dsums *dsums,
+			    struct public_ip_list *all_ips,
+			    struct public_ip_list *ip,
+			    unsigned int srcnode,
+			    unsigned int dstnode)
 {
 	struct public_ip_list *t;
+	unsigned int i;
+	uint32_t d;
 
-	uint32_t imbalance = 0;
-
-	for (t = all_ips; t != NULL; t = t->next) {
-		if (t->pnn != pnn) {
+	for (t = all_ips, i = 0; t != NULL; t = t->next, i++) {
+		if (t == ip) {
 			continue;
 		}
-		/* Pass the rest of the IPs rather than the whole
-		   all_ips input list.
-		*/
-		imbalance += ip_distance_2_sum(&(t->addr), t->next, pnn);
-	}
 
-	return imbalance;
+		d = ip_distance(&(ip->addr), &(t->addr));
+		if (srcnode != CTDB_UNKNOWN_PNN) {
+			*lcp2_dsum(dsums, i, srcnode) -= d * d;
+		}
+		*lcp2_dsum(dsums, i, dstnode) += d * d;
+	}
 }
 
 static bool lcp2_init(struct ipalloc_state *ipalloc_state,
 		      uint32_t **lcp2_imbalances,
+		      struct lcp2_dsums *dsums,
 		      bool **rebalance_candidates)
 {
-	unsigned int i, numnodes;
-	struct public_ip_list *t;
+	unsigned int i, j, numnodes, numips;
+	struct public_ip_list *t, *u;
+	uint32_t d;
 
 	numnodes = ipalloc_state->num;
 
+	numips = 0;
+	for (t = ipalloc_state->all_ips; t != NULL; t = t->next) {
+		numips++;
+	}
+
 	*rebalance_candidates = talloc_array(ipalloc_state, bool, numnodes);
 	if (*rebalance_candidates == NULL) {
 		DEBUG(DEBUG_ERR, (__location__ " out of memory\n"));
 		return false;
 	}
-	*lcp2_imbalances = talloc_array(ipalloc_state, uint32_t, numnodes);
+	*lcp2_imbalances = talloc_zero_array(ipalloc_state, uint32_t, numnodes);
 	if (*lcp2_imbalances == NULL) {
 		DEBUG(DEBUG_ERR, (__location__ " out of memory\n"));
 		return false;
 	}
+	dsums->numnodes = numnodes;
+	dsums->sum = talloc_zero_array(ipalloc_state,
+				       uint32_t,
+				       numips * numnodes);
+	if (dsums->sum == NULL) {
+		DEBUG(DEBUG_ERR, (__location__ " out of memory\n"));
+		return false;
+	}
+
+	/* Calculate the distance sums and the LCP2 imbalance metric
+	 * for each node.  The imbalance of a node is the sum of the
+	 * squared distances between each pair of addresses on the
+	 * node.
+	 */
+	for (t = ipalloc_state->all_ips, i = 0;
+	     t != NULL;
+	     t = t->next, i++) {
+		for (u = t->next, j = i + 1; u != NULL; u = u->next, j++) {
+			if (t->pnn >= numnodes && u->pnn >= numnodes) {
+				continue;
+			}
+
+			d = ip_distance(&(t->addr), &(u->addr));
+			if (u->pnn < numnodes) {
+				*lcp2_dsum(dsums, i, u->pnn) += d * d;
+			}
+			if (t->pnn < numnodes) {
+				*lcp2_dsum(dsums, j, t->pnn) += d * d;
+			}
+			if (t->pnn < numnodes && t->pnn == u->pnn) {
+				(*lcp2_imbalances)[t->pnn] += d * d;
+			}
+		}
+	}
 
 	for (i=0; i<numnodes; i++) {
-		(*lcp2_imbalances)[i] =
-			lcp2_imbalance(ipalloc_state->all_ips, i);
 		/* First step: assume all nodes are candidates */
 		(*rebalance_candidates)[i] = true;
 	}
@@ -196,10 +226,11 @@ static bool lcp2_init(struct ipalloc_state *ipalloc_state,
  * the IP/node combination that will cost the least.
  */
 static void lcp2_allocate_unassigned(struct ipalloc_state *ipalloc_state,
-				     uint32_t *lcp2_imbalances)
+				     uint32_t *lcp2_imbalances,
+				     struct lcp2_dsums *dsums)
 {
 	struct public_ip_list *t;
-	unsigned int dstnode, numnodes;
+	unsigned int i, dstnode, numnodes;
 
 	unsigned int minnode;
 	uint32_t mindsum, dstdsum, dstimbl;
@@ -222,7 +253,9 @@ static void lcp2_allocate_unassigned(struct ipalloc_state *ipalloc_state,
 		minip = NULL;
 
 		/* loop over each unassigned ip. */
-		for (t = ipalloc_state->all_ips; t != NULL ; t = t->next) {
+		for (t = ipalloc_state->all_ips, i = 0;
+		     t != NULL;
+		     t = t->next, i++) {
 			if (t->pnn != CTDB_UNKNOWN_PNN) {
 				continue;
 			}
@@ -236,9 +269,7 @@ static void lcp2_allocate_unassigned(struct ipalloc_state *ipalloc_state,
 					continue;
 				}
 
-				dstdsum = ip_distance_2_sum(&(t->addr),
-							    ipalloc_state->all_ips,
-							    dstnode);
+				dstdsum = *lcp2_dsum(dsums, i, dstnode);
 				dstimbl = lcp2_imbalances[dstnode] + dstdsum;
 				DEBUG(DEBUG_DEBUG,
 				      (" %s -> %d [+%d]\n",
@@ -266,6 +297,11 @@ static void lcp2_allocate_unassigned(struct ipalloc_state *ipalloc_state,
 		if (minnode != CTDB_UNKNOWN_PNN) {
 			minip->pnn = minnode;
 			lcp2_imbalances[minnode] = minimbl;
+			lcp2_dsums_move(dsums,
+					ipalloc_state->all_ips,
+					minip,
+					CTDB_UNKNOWN_PNN,
+					minnode);
 			DEBUG(DEBUG_INFO,(" %s -> %d [+%d]\n",
 					  ctdb_sock_addr_to_string(
 						  ipalloc_state,
@@ -306,9 +342,10 @@ static void lcp2_allocate_unassigned(struct ipalloc_state *ipalloc_state,
 static bool lcp2_failback_candidate(struct ipalloc_state *ipalloc_state,
 				    unsigned int srcnode,
 				    uint32_t *lcp2_imbalances,
+				    struct lcp2_dsums *dsums,
 				    bool *rebalance_candidates)
 {
-	unsigned int dstnode, mindstnode, numnodes;
+	unsigned int i, dstnode, mindstnode, numnodes;
 	uint32_t srcdsum, dstimbl, dstdsum;
 	uint32_t minsrcimbl, mindstimbl;
 	struct public_ip_list *minip;
@@ -326,7 +363,7 @@ static bool lcp2_failback_candidate(struct ipalloc_state *ipalloc_state,
 	DEBUG(DEBUG_DEBUG,(" CONSIDERING MOVES FROM %d [%d]\n",
 			   srcnode, lcp2_imbalances[srcnode]));
 
-	for (t = ipalloc_state->all_ips; t != NULL; t = t->next) {
+	for (t = ipalloc_state->all_ips, i = 0; t != NULL; t = t->next, i++) {
 		uint32_t srcimbl;
 
 		/* Only consider addresses on srcnode. */
@@ -335,9 +372,7 @@ static bool lcp2_failback_candidate(struct ipalloc_state *ipalloc_state,
 		}
 
 		/* What is this IP address costing the source node? */
-		srcdsum = ip_distance_2_sum(&(t->addr),
-					    ipalloc_state->all_ips,
-					    srcnode);
+		srcdsum = *lcp2_dsum(dsums, i, srcnode);
 		srcimbl = lcp2_imbalances[srcnode] - srcdsum;
 
 		/* Consider this IP address would cost each potential
@@ -358,9 +393,7 @@ static bool lcp2_failback_candidate(struct ipalloc_state *ipalloc_state,
 				continue;
 			}
 
-			dstdsum = ip_distance_2_sum(&(t->addr),
-						    ipalloc_state->all_ips,
-						    dstnode);
+			dstdsum = *lcp2_dsum(dsums, i, dstnode);
 			dstimbl = lcp2_imbalances[dstnode] + dstdsum;
 			DEBUG(DEBUG_DEBUG,(" %d [%d] -> %s -> %d [+%d]\n",
 					   srcnode, -srcdsum,
@@ -396,6 +429,11 @@ static bool lcp2_failback_candidate(struct ipalloc_state *ipalloc_state,
 		lcp2_imbalances[srcnode] = minsrcimbl;
 		lcp2_imbalances[mindstnode] = mindstimbl;
 		minip->pnn = mindstnode;
+		lcp2_dsums_move(dsums,
+				ipalloc_state->all_ips,
+				minip,
+				srcnode,
+				mindstnode);
 
 		return true;
 	}
@@ -428,6 +466,7 @@ static int lcp2_cmp_imbalance_pnn(const void * a, const void * b)
  */
 static void lcp2_failback(struct ipalloc_state *ipalloc_state,
 			  uint32_t *lcp2_imbalances,
+			  struct lcp2_dsums *dsums,
 			  bool *rebalance_candidates)
 {
 	int i, numnodes;
@@ -464,6 +503,7 @@ try_again:
 		if (lcp2_failback_candidate(ipalloc_state,
 					    lips[i].pnn,
 					    lcp2_imbalances,
+					    dsums,
 					    rebalance_candidates)) {
 			again = true;
 			break;
@@ -479,6 +519,7 @@ try_again:
 bool ipalloc_lcp2(struct ipalloc_state *ipalloc_state)
 {
 	uint32_t *lcp2_imbalances;
+	struct lcp2_dsums dsums;
 	bool *rebalance_candidates;
 	int numnodes, i;
 	bool have_rebalance_candidates;
@@ -487,12 +528,12 @@ bool ipalloc_lcp2(struct ipalloc_state *ipalloc_state)
 	unassign_unsuitable_ips(ipalloc_state);
 
 	if (!lcp2_init(ipalloc_state,
-		       &lcp2_imbalances, &rebalance_candidates)) {
+		       &lcp2_imbalances, &dsums, &rebalance_candidates)) {
 		ret = false;
 		goto finished;
 	}
 
-	lcp2_allocate_unassigned(ipalloc_state, lcp2_imbalances);
+	lcp2_allocate_unassigned(ipalloc_state, lcp2_imbalances, &dsums);
 
 	/* If we don't want IPs to fail back then don't rebalance IPs. */
 	if (ipalloc_state->no_ip_failback) {
@@ -518,7 +559,10 @@ bool ipalloc_lcp2(struct ipalloc_state *ipalloc_state)
 	/* Now, try to make sure the ip addresses are evenly distributed
 	   across the nodes.
 	*/
-	lcp2_failback(ipalloc_state, lcp2_imbalances, rebalance_candidates);
+	lcp2_failback(ipalloc_state,
+		      lcp2_imbalances,
+		      &dsums,
+		      rebalance_candidates);
 
 finished:
 	return ret;
@@ -0,0 +1,112 @@
+#!/usr/bin/env bash
+
+# Time how long a storm of requests waiting for the same locked record
+# takes to be served, once the lock is dropped
+#
+# The record is locked on the node that holds it while clients on all
+# other nodes try to read it.  Each read becomes a call to the locked
+# node, where ctdbd waits for the record lock in a lock helper.
+#
+# Set CTDB_TEST_LOCK_STORM_CLIENTS to change the number of clients on
+# each node.
+
+. "${TEST_SCRIPTS_DIR}/integration.bash"
+
+set -e
+
+ctdb_test_init
+
+db="lock_storm.tdb"
+key="key"
+
+num_clients="${CTDB_TEST_LOCK_STORM_CLIENTS:-100}"
+
+ctdb_get_all_pnns
+# $all_pnns is set above
+# shellcheck disable=SC2154
+first=$(echo "$all_pnns" | sed -n -e '1p')
+others=$(echo "$all_pnns" | sed -n -e '2,$p')
+
+if [ -z "$others" ] ; then
+	ctdb_test_skip "This test needs at least 2 nodes"
+fi
+
+num_others=$(echo "$others" | wc -l | tr -d '[:space:]')
+num_waiters=$((num_clients * num_others))
+
+echo "Create/wipe test database ${db}"
+ctdb_onnode "$first" "attach ${db}"
+ctdb_onnode "$first" "wipedb ${db}"
+
+echo "Create a record in ${db} on node ${first}"
+ctdb_onnode "$first" "writekey ${db} ${key} value1"
+
+echo "Do not collapse the reads on the other nodes"
+for pnn in $others ; do
+	ctdb_onnode "$pnn" "setvar FetchCollapse 0"
+done
+
+echo "Lock record on node ${first}"
+testprog_onnode "$first" "ctdb-db-test local-lock ${db} ${key}"
+pid="${out#OK }"
+ctdb_test_cleanup_pid_set "$first" "$pid"
+
+echo
+echo "Start ${num_clients} readers on each of nodes" $others
+storm_out=$(mktemp)
+ctdb_test_exit_hook_add "rm -f ${storm_out}"
+storm_pids=""
+for pnn in $others ; do
+	onnode -q "$pnn" \
+	       "for i in \$(seq 1 ${num_clients}) ; do \
+			{ $CTDB -t 120 readkey ${db} ${key} >/dev/null || \
+				echo FAILED ; } & \
+		done ; \
+		wait" >>"$storm_out" 2>&1 &
+	storm_pids="${storm_pids} $!"
+done
+
+get_lock_stat ()
+{
+	_stat="$1"
+
+	ctdb_onnode "$first" "dbstatistics ${db}"
+	awk -v stat="$_stat" '$1 == stat { print $2 }' "$outfile"
+}
+
+all_waiting ()
+{
+	_current=$(get_lock_stat "num_current")
+	_pending=$(get_lock_stat "num_pending")
+
+	[ $((_current + _pending)) -ge "$num_waiters" ]
+}
+
+echo "Wait for ${num_waiters} lock requests on node ${first}"
+wait_until 60 all_waiting
+
+num_current=$(get_lock_stat "num_current")
+num_pending=$(get_lock_stat "num_pending")
+echo "Lock helpers running: ${num_current}, requests queued: ${num_pending}"
+
+echo
+echo "Kill lock process ${pid} on node ${first}"
+start=$(date '+%s.%N')
+try_command_on_node "$first" "kill ${pid}"
+ctdb_test_cleanup_pid_clear
+
+for p in $storm_pids ; do
+	wait "$p" || true
+done
+end=$(date '+%s.%N')
+
+if grep -q "FAILED" "$storm_out" ; then
+	cat "$storm_out"
+	ctdb_test_fail "BAD: some readers failed"
+fi
+
+elapsed=$(awk -v s="$start" -v e="$end" 'BEGIN { printf "%.3f", e - s }')
+echo "Served ${num_waiters} waiting readers in ${elapsed} seconds"
+
+echo
+ctdb_onnode -v "$first" "dbstatistics ${db}"
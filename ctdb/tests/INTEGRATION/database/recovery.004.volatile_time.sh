@@ -0,0 +1,77 @@
+#!/usr/bin/env bash
+
+# Time the recovery of a volatile database as it grows
+#
+# Every node gets its own copy of each record, with a different RSN,
+# so recovery has to pull and merge the database from all nodes.  For
+# each size the duration of the recovery (the time the databases are
+# frozen) is reported, and the recovered database is checked.
+#
+# Set CTDB_TEST_RECOVERY_SIZES to a list of record counts to change
+# the sizes that are timed.
+
+. "${TEST_SCRIPTS_DIR}/integration.bash"
+
+set -e
+
+ctdb_test_init
+
+TESTDB="recovery_time.tdb"
+
+sizes="${CTDB_TEST_RECOVERY_SIZES:-1000 5000 20000}"
+
+v1="1234567890"
+value="$v1$v1$v1$v1$v1$v1$v1$v1$v1$v1"
+
+ctdb_get_all_pnns
+# $all_pnns is set above
+# shellcheck disable=SC2154
+first=$(echo "$all_pnns" | sed -n -e '1p')
+
+echo "Create test database ${TESTDB}"
+ctdb_onnode "$first" "attach ${TESTDB}"
+
+fill_db ()
+{
+	_pnn="$1"
+	_num="$2"
+
+	_tdb=$(db_get_path "$_pnn" "$TESTDB")
+	_rsn=$((_pnn + 1))
+
+	try_command_on_node "$_pnn" \
+		"for i in \$(seq 1 ${_num}) ; do \
+			$CTDB tstore ${_tdb} record\$i ${value} ${_rsn} || exit 1 ; \
+		done"
+}
+
+time_recovery ()
+{
+	_num="$1"
+
+	echo
+	echo "Wipe ${TESTDB}, then store ${_num} records on each node"
+	ctdb_onnode "$first" "wipedb ${TESTDB}"
+	for _pnn in $all_pnns ; do
+		fill_db "$_pnn" "$_num"
+	done
+
+	echo "Force recovery"
+	ctdb_onnode "$first" "recover"
+	wait_until_node_has_status "$first" recovered 120
+
+	ctdb_onnode "$first" "uptime"
+	_duration=$(sed -n -e 's|^Duration of last recovery/failover: ||p' \
+			"$outfile")
+	echo "Recovery of ${_num} records took ${_duration}"
+
+	_count=$(db_ctdb_cattdb_count_records "$first" "$TESTDB")
+	if [ "$_count" != "$_num" ] ; then
+		ctdb_test_fail "BAD: ${TESTDB} has ${_count} of ${_num} records"
+	fi
+	echo "OK: all ${_num} records were recovered"
+}
+
+for num in $sizes ; do
+	time_recovery "$num"
+done
@@ -0,0 +1,2013 @@
+#!/bin/sh
+
+. "${TEST_SCRIPTS_DIR}/unit.sh"
+
+define_test "1000 IPs, 32 nodes, 32 -> 24 healthy"
+
+export CTDB_TEST_LOGLEVEL=ERR
+
+required_result <<EOF
+10.0.13.250 8
+10.0.13.249 9
+10.0.13.248 10
+10.0.13.247 11
+10.0.13.246 12
+10.0.13.245 13
+10.0.13.244 14
+10.0.13.243 15
+10.0.13.242 31
+10.0.13.241 30
+10.0.13.240 29
+10.0.13.239 28
+10.0.13.238 27
+10.0.13.237 26
+10.0.13.236 25
+10.0.13.235 24
+10.0.13.234 23
+10.0.13.233 22
+10.0.13.232 21
+10.0.13.231 20
+10.0.13.230 19
+10.0.13.229 18
+10.0.13.228 17
+10.0.13.227 16
+10.0.13.226 15
+10.0.13.225 14
+10.0.13.224 13
+10.0.13.223 12
+10.0.13.222 11
+10.0.13.221 10
+10.0.13.220 9
+10.0.13.219 8
+10.0.13.218 16
+10.0.13.217 17
+10.0.13.216 18
+10.0.13.215 19
+10.0.13.214 20
+10.0.13.213 21
+10.0.13.212 22
+10.0.13.211 23
+10.0.13.210 31
+10.0.13.209 30
+10.0.13.208 29
+10.0.13.207 28
+10.0.13.206 27
+10.0.13.205 26
+10.0.13.204 25
+10.0.13.203 24
+10.0.13.202 23
+10.0.13.201 22
+10.0.13.200 21
+10.0.13.199 20
+10.0.13.198 19
+10.0.13.197 18
+10.0.13.196 17
+10.0.13.195 16
+10.0.13.194 15
+10.0.13.193 14
+10.0.13.192 13
+10.0.13.191 12
+10.0.13.190 11
+10.0.13.189 10
+10.0.13.188 9
+10.0.13.187 8
+10.0.13.186 24
+10.0.13.185 25
+10.0.13.184 26
+10.0.13.183 27
+10.0.13.182 28
+10.0.13.181 8
+10.0.13.180 9
+10.0.13.179 10
+10.0.13.178 31
+10.0.13.177 30
+10.0.13.176 29
+10.0.13.175 28
+10.0.13.174 27
+10.0.13.173 26
+10.0.13.172 25
+10.0.13.171 24
+10.0.13.170 23
+10.0.13.169 22
+10.0.13.168 21
+10.0.13.167 20
+10.0.13.166 19
+10.0.13.165 18
+10.0.13.164 17
+10.0.13.163 16
+10.0.13.162 15
+10.0.13.161 14
+10.0.13.160 13
+10.0.13.159 12
+10.0.13.158 11
+10.0.13.157 10
+10.0.13.156 9
+10.0.13.155 8
+10.0.13.154 29
+10.0.13.153 30
+10.0.13.152 31
+10.0.13.151 11
+10.0.13.150 12
+10.0.13.149 13
+10.0.13.148 14
+10.0.13.147 15
+10.0.13.146 31
+10.0.13.145 30
+10.0.13.144 29
+10.0.13.143 28
+10.0.13.142 27
+10.0.13.141 26
+10.0.13.140 25
+10.0.13.139 24
+10.0.13.138 23
+10.0.13.137 22
+10.0.13.136 21
+10.0.13.135 20
+10.0.13.134 19
+10.0.13.133 18
+10.0.13.132 17
+10.0.13.131 16
+10.0.13.130 15
+10.0.13.129 14
+10.0.13.128 13
+10.0.13.127 12
+10.0.13.126 11
+10.0.13.125 10
+10.0.13.124 9
+10.0.13.123 8
+10.0.13.122 13
+10.0.13.121 14
+10.0.13.120 15
+10.0.13.119 16
+10.0.13.118 17
+10.0.13.117 18
+10.0.13.116 19
+10.0.13.115 20
+10.0.13.114 31
+10.0.13.113 30
+10.0.13.112 29
+10.0.13.111 28
+10.0.13.110 27
+10.0.13.109 26
+10.0.13.108 25
+10.0.13.107 24
+10.0.13.106 23
+10.0.13.105 22
+10.0.13.104 21
+10.0.13.103 20
+10.0.13.102 19
+10.0.13.101 18
+10.0.13.100 17
+10.0.13.99 16
+10.0.13.98 15
+10.0.13.97 14
+10.0.13.96 13
+10.0.13.95 12
+10.0.13.94 11
+10.0.13.93 10
+10.0.13.92 9
+10.0.13.91 8
+10.0.13.90 21
+10.0.13.89 22
+10.0.13.88 23
+10.0.13.87 24
+10.0.13.86 25
+10.0.13.85 26
+10.0.13.84 27
+10.0.13.83 28
+10.0.13.82 31
+10.0.13.81 30
+10.0.13.80 29
+10.0.13.79 28
+10.0.13.78 27
+10.0.13.77 26
+10.0.13.76 25
+10.0.13.75 24
+10.0.13.74 23
+10.0.13.73 22
+10.0.13.72 21
+10.0.13.71 20
+10.0.13.70 19
+10.0.13.69 18
+10.0.13.68 17
+10.0.13.67 16
+10.0.13.66 15
+10.0.13.65 14
+10.0.13.64 13
+10.0.13.63 12
+10.0.13.62 11
+10.0.13.61 10
+10.0.13.60 9
+10.0.13.59 8
+10.0.13.58 29
+10.0.13.57 30
+10.0.13.56 31
+10.0.13.55 8
+10.0.13.54 9
+10.0.13.53 10
+10.0.13.52 11
+10.0.13.51 12
+10.0.13.50 31
+10.0.13.49 30
+10.0.13.48 29
+10.0.13.47 28
+10.0.13.46 27
+10.0.13.45 26
+10.0.13.44 25
+10.0.13.43 24
+10.0.13.42 23
+10.0.13.41 22
+10.0.13.40 21
+10.0.13.39 20
+10.0.13.38 19
+10.0.13.37 18
+10.0.13.36 17
+10.0.13.35 16
+10.0.13.34 15
+10.0.13.33 14
+10.0.13.32 13
+10.0.13.31 12
+10.0.13.30 11
+10.0.13.29 10
+10.0.13.28 9
+10.0.13.27 8
+10.0.13.26 13
+10.0.13.25 16
+10.0.13.24 17
+10.0.13.23 18
+10.0.13.22 19
+10.0.13.21 20
+10.0.13.20 21
+10.0.13.19 22
+10.0.13.18 31
+10.0.13.17 30
+10.0.13.16 29
+10.0.13.15 28
+10.0.13.14 27
+10.0.13.13 26
+10.0.13.12 25
+10.0.13.11 24
+10.0.13.10 23
+10.0.13.9 22
+10.0.13.8 21
+10.0.13.7 20
+10.0.13.6 19
+10.0.13.5 18
+10.0.13.4 17
+10.0.13.3 16
+10.0.13.2 15
+10.0.13.1 14
+10.0.12.250 13
+10.0.12.249 12
+10.0.12.248 11
+10.0.12.247 10
+10.0.12.246 9
+10.0.12.245 8
+10.0.12.244 14
+10.0.12.243 15
+10.0.12.242 16
+10.0.12.241 17
+10.0.12.240 18
+10.0.12.239 8
+10.0.12.238 9
+10.0.12.237 10
+10.0.12.236 31
+10.0.12.235 30
+10.0.12.234 29
+10.0.12.233 28
+10.0.12.232 27
+10.0.12.231 26
+10.0.12.230 25
+10.0.12.229 24
+10.0.12.228 23
+10.0.12.227 22
+10.0.12.226 21
+10.0.12.225 20
+10.0.12.224 19
+10.0.12.223 18
+10.0.12.222 17
+10.0.12.221 16
+10.0.12.220 15
+10.0.12.219 14
+10.0.12.218 13
+10.0.12.217 12
+10.0.12.216 11
+10.0.12.215 10
+10.0.12.214 9
+10.0.12.213 8
+10.0.12.212 29
+10.0.12.211 30
+10.0.12.210 31
+10.0.12.209 19
+10.0.12.208 20
+10.0.12.207 11
+10.0.12.206 12
+10.0.12.205 13
+10.0.12.204 31
+10.0.12.203 30
+10.0.12.202 29
+10.0.12.201 28
+10.0.12.200 27
+10.0.12.199 26
+10.0.12.198 25
+10.0.12.197 24
+10.0.12.196 23
+10.0.12.195 22
+10.0.12.194 21
+10.0.12.193 20
+10.0.12.192 19
+10.0.12.191 18
+10.0.12.190 17
+10.0.12.189 16
+10.0.12.188 15
+10.0.12.187 14
+10.0.12.186 13
+10.0.12.185 12
+10.0.12.184 11
+10.0.12.183 10
+10.0.12.182 9
+10.0.12.181 8
+10.0.12.180 21
+10.0.12.179 22
+10.0.12.178 23
+10.0.12.177 24
+10.0.12.176 25
+10.0.12.175 14
+10.0.12.174 15
+10.0.12.173 16
+10.0.12.172 31
+10.0.12.171 30
+10.0.12.170 29
+10.0.12.169 28
+10.0.12.168 27
+10.0.12.167 26
+10.0.12.166 25
+10.0.12.165 24
+10.0.12.164 23
+10.0.12.163 22
+10.0.12.162 21
+10.0.12.161 20
+10.0.12.160 19
+10.0.12.159 18
+10.0.12.158 17
+10.0.12.157 16
+10.0.12.156 15
+10.0.12.155 14
+10.0.12.154 13
+10.0.12.153 12
+10.0.12.152 11
+10.0.12.151 10
+10.0.12.150 9
+10.0.12.149 8
+10.0.12.148 26
+10.0.12.147 27
+10.0.12.146 28
+10.0.12.145 29
+10.0.12.144 30
+10.0.12.143 17
+10.0.12.142 18
+10.0.12.141 8
+10.0.12.140 31
+10.0.12.139 30
+10.0.12.138 29
+10.0.12.137 28
+10.0.12.136 27
+10.0.12.135 26
+10.0.12.134 25
+10.0.12.133 24
+10.0.12.132 23
+10.0.12.131 22
+10.0.12.130 21
+10.0.12.129 20
+10.0.12.128 19
+10.0.12.127 18
+10.0.12.126 17
+10.0.12.125 16
+10.0.12.124 15
+10.0.12.123 14
+10.0.12.122 13
+10.0.12.121 12
+10.0.12.120 11
+10.0.12.119 10
+10.0.12.118 9
+10.0.12.117 8
+10.0.12.116 29
+10.0.12.115 30
+10.0.12.114 31
+10.0.12.113 19
+10.0.12.112 20
+10.0.12.111 8
+10.0.12.110 9
+10.0.12.109 10
+10.0.12.108 31
+10.0.12.107 30
+10.0.12.106 29
+10.0.12.105 28
+10.0.12.104 27
+10.0.12.103 26
+10.0.12.102 25
+10.0.12.101 24
+10.0.12.100 23
+10.0.12.99 22
+10.0.12.98 21
+10.0.12.97 20
+10.0.12.96 19
+10.0.12.95 18
+10.0.12.94 17
+10.0.12.93 16
+10.0.12.92 15
+10.0.12.91 14
+10.0.12.90 13
+10.0.12.89 12
+10.0.12.88 11
+10.0.12.87 10
+10.0.12.86 9
+10.0.12.85 8
+10.0.12.84 21
+10.0.12.83 22
+10.0.12.82 23
+10.0.12.81 24
+10.0.12.80 25
+10.0.12.79 11
+10.0.12.78 12
+10.0.12.77 13
+10.0.12.76 31
+10.0.12.75 30
+10.0.12.74 29
+10.0.12.73 28
+10.0.12.72 27
+10.0.12.71 26
+10.0.12.70 25
+10.0.12.69 24
+10.0.12.68 23
+10.0.12.67 22
+10.0.12.66 21
+10.0.12.65 20
+10.0.12.64 19
+10.0.12.63 18
+10.0.12.62 17
+10.0.12.61 16
+10.0.12.60 15
+10.0.12.59 14
+10.0.12.58 13
+10.0.12.57 12
+10.0.12.56 11
+10.0.12.55 10
+10.0.12.54 9
+10.0.12.53 8
+10.0.12.52 26
+10.0.12.51 27
+10.0.12.50 28
+10.0.12.49 23
+10.0.12.48 24
+10.0.12.47 14
+10.0.12.46 15
+10.0.12.45 16
+10.0.12.44 31
+10.0.12.43 30
+10.0.12.42 29
+10.0.12.41 28
+10.0.12.40 27
+10.0.12.39 26
+10.0.12.38 25
+10.0.12.37 24
+10.0.12.36 23
+10.0.12.35 22
+10.0.12.34 21
+10.0.12.33 20
+10.0.12.32 19
+10.0.12.31 18
+10.0.12.30 17
+10.0.12.29 16
+10.0.12.28 15
+10.0.12.27 14
+10.0.12.26 13
+10.0.12.25 12
+10.0.12.24 11
+10.0.12.23 10
+10.0.12.22 9
+10.0.12.21 8
+10.0.12.20 19
+10.0.12.19 25
+10.0.12.18 31
+10.0.12.17 26
+10.0.12.16 27
+10.0.12.15 17
+10.0.12.14 18
+10.0.12.13 9
+10.0.12.12 31
+10.0.12.11 30
+10.0.12.10 29
+10.0.12.9 28
+10.0.12.8 27
+10.0.12.7 26
+10.0.12.6 25
+10.0.12.5 24
+10.0.12.4 23
+10.0.12.3 22
+10.0.12.2 21
+10.0.12.1 20
+10.0.11.250 19
+10.0.11.249 18
+10.0.11.248 17
+10.0.11.247 16
+10.0.11.246 15
+10.0.11.245 14
+10.0.11.244 13
+10.0.11.243 12
+10.0.11.242 11
+10.0.11.241 10
+10.0.11.240 9
+10.0.11.239 8
+10.0.11.238 20
+10.0.11.237 21
+10.0.11.236 22
+10.0.11.235 23
+10.0.11.234 24
+10.0.11.233 9
+10.0.11.232 10
+10.0.11.231 11
+10.0.11.230 31
+10.0.11.229 30
+10.0.11.228 29
+10.0.11.227 28
+10.0.11.226 27
+10.0.11.225 26
+10.0.11.224 25
+10.0.11.223 24
+10.0.11.222 23
+10.0.11.221 22
+10.0.11.220 21
+10.0.11.219 20
+10.0.11.218 19
+10.0.11.217 18
+10.0.11.216 17
+10.0.11.215 16
+10.0.11.214 15
+10.0.11.213 14
+10.0.11.212 13
+10.0.11.211 12
+10.0.11.210 11
+10.0.11.209 10
+10.0.11.208 9
+10.0.11.207 8
+10.0.11.206 12
+10.0.11.205 13
+10.0.11.204 14
+10.0.11.203 15
+10.0.11.202 16
+10.0.11.201 17
+10.0.11.200 18
+10.0.11.199 19
+10.0.11.198 31
+10.0.11.197 30
+10.0.11.196 29
+10.0.11.195 28
+10.0.11.194 27
+10.0.11.193 26
+10.0.11.192 25
+10.0.11.191 24
+10.0.11.190 23
+10.0.11.189 22
+10.0.11.188 21
+10.0.11.187 20
+10.0.11.186 19
+10.0.11.185 18
+10.0.11.184 17
+10.0.11.183 16
+10.0.11.182 15
+10.0.11.181 14
+10.0.11.180 13
+10.0.11.179 12
+10.0.11.178 11
+10.0.11.177 10
+10.0.11.176 9
+10.0.11.175 8
+10.0.11.174 20
+10.0.11.173 21
+10.0.11.172 22
+10.0.11.171 23
+10.0.11.170 24
+10.0.11.169 31
+10.0.11.168 25
+10.0.11.167 8
+10.0.11.166 31
+10.0.11.165 30
+10.0.11.164 29
+10.0.11.163 28
+10.0.11.162 27
+10.0.11.161 26
+10.0.11.160 25
+10.0.11.159 24
+10.0.11.158 23
+10.0.11.157 22
+10.0.11.156 21
+10.0.11.155 20
+10.0.11.154 19
+10.0.11.153 18
+10.0.11.152 17
+10.0.11.151 16
+10.0.11.150 15
+10.0.11.149 14
+10.0.11.148 13
+10.0.11.147 12
+10.0.11.146 11
+10.0.11.145 10
+10.0.11.144 9
+10.0.11.143 8
+10.0.11.142 26
+10.0.11.141 27
+10.0.11.140 28
+10.0.11.139 29
+10.0.11.138 30
+10.0.11.137 10
+10.0.11.136 11
+10.0.11.135 12
+10.0.11.134 31
+10.0.11.133 30
+10.0.11.132 29
+10.0.11.131 28
+10.0.11.130 27
+10.0.11.129 26
+10.0.11.128 25
+10.0.11.127 24
+10.0.11.126 23
+10.0.11.125 22
+10.0.11.124 21
+10.0.11.123 20
+10.0.11.122 19
+10.0.11.121 18
+10.0.11.120 17
+10.0.11.119 16
+10.0.11.118 15
+10.0.11.117 14
+10.0.11.116 13
+10.0.11.115 12
+10.0.11.114 11
+10.0.11.113 10
+10.0.11.112 9
+10.0.11.111 8
+10.0.11.110 9
+10.0.11.109 10
+10.0.11.108 11
+10.0.11.107 12
+10.0.11.106 13
+10.0.11.105 14
+10.0.11.104 15
+10.0.11.103 16
+10.0.11.102 31
+10.0.11.101 30
+10.0.11.100 29
+10.0.11.99 28
+10.0.11.98 27
+10.0.11.97 26
+10.0.11.96 25
+10.0.11.95 24
+10.0.11.94 23
+10.0.11.93 22
+10.0.11.92 21
+10.0.11.91 20
+10.0.11.90 19
+10.0.11.89 18
+10.0.11.88 17
+10.0.11.87 16
+10.0.11.86 15
+10.0.11.85 14
+10.0.11.84 13
+10.0.11.83 12
+10.0.11.82 11
+10.0.11.81 10
+10.0.11.80 9
+10.0.11.79 8
+10.0.11.78 17
+10.0.11.77 18
+10.0.11.76 19
+10.0.11.75 20
+10.0.11.74 21
+10.0.11.73 22
+10.0.11.72 23
+10.0.11.71 24
+10.0.11.70 31
+10.0.11.69 30
+10.0.11.68 29
+10.0.11.67 28
+10.0.11.66 27
+10.0.11.65 26
+10.0.11.64 25
+10.0.11.63 24
+10.0.11.62 23
+10.0.11.61 22
+10.0.11.60 21
+10.0.11.59 20
+10.0.11.58 19
+10.0.11.57 18
+10.0.11.56 17
+10.0.11.55 16
+10.0.11.54 15
+10.0.11.53 14
+10.0.11.52 13
+10.0.11.51 12
+10.0.11.50 11
+10.0.11.49 10
+10.0.11.48 9
+10.0.11.47 8
+10.0.11.46 31
+10.0.11.45 25
+10.0.11.44 26
+10.0.11.43 27
+10.0.11.42 28
+10.0.11.41 29
+10.0.11.40 30
+10.0.11.39 8
+10.0.11.38 31
+10.0.11.37 30
+10.0.11.36 29
+10.0.11.35 28
+10.0.11.34 27
+10.0.11.33 26
+10.0.11.32 25
+10.0.11.31 24
+10.0.11.30 23
+10.0.11.29 22
+10.0.11.28 21
+10.0.11.27 20
+10.0.11.26 19
+10.0.11.25 18
+10.0.11.24 17
+10.0.11.23 16
+10.0.11.22 15
+10.0.11.21 14
+10.0.11.20 13
+10.0.11.19 12
+10.0.11.18 11
+10.0.11.17 10
+10.0.11.16 9
+10.0.11.15 8
+10.0.11.14 25
+10.0.11.13 9
+10.0.11.12 13
+10.0.11.11 14
+10.0.11.10 15
+10.0.11.9 16
+10.0.11.8 17
+10.0.11.7 18
+10.0.11.6 31
+10.0.11.5 30
+10.0.11.4 29
+10.0.11.3 28
+10.0.11.2 27
+10.0.11.1 26
+10.0.10.250 25
+10.0.10.249 24
+10.0.10.248 23
+10.0.10.247 22
+10.0.10.246 21
+10.0.10.245 20
+10.0.10.244 19
+10.0.10.243 18
+10.0.10.242 17
+10.0.10.241 16
+10.0.10.240 15
+10.0.10.239 14
+10.0.10.238 13
+10.0.10.237 12
+10.0.10.236 11
+10.0.10.235 10
+10.0.10.234 9
+10.0.10.233 8
+10.0.10.232 26
+10.0.10.231 27
+10.0.10.230 28
+10.0.10.229 29
+10.0.10.228 30
+10.0.10.227 25
+10.0.10.226 15
+10.0.10.225 16
+10.0.10.224 31
+10.0.10.223 30
+10.0.10.222 29
+10.0.10.221 28
+10.0.10.220 27
+10.0.10.219 26
+10.0.10.218 25
+10.0.10.217 24
+10.0.10.216 23
+10.0.10.215 22
+10.0.10.214 21
+10.0.10.213 20
+10.0.10.212 19
+10.0.10.211 18
+10.0.10.210 17
+10.0.10.209 16
+10.0.10.208 15
+10.0.10.207 14
+10.0.10.206 13
+10.0.10.205 12
+10.0.10.204 11
+10.0.10.203 10
+10.0.10.202 9
+10.0.10.201 8
+10.0.10.200 26
+10.0.10.199 27
+10.0.10.198 28
+10.0.10.197 29
+10.0.10.196 30
+10.0.10.195 17
+10.0.10.194 18
+10.0.10.193 19
+10.0.10.192 31
+10.0.10.191 30
+10.0.10.190 29
+10.0.10.189 28
+10.0.10.188 27
+10.0.10.187 26
+10.0.10.186 25
+10.0.10.185 24
+10.0.10.184 23
+10.0.10.183 22
+10.0.10.182 21
+10.0.10.181 20
+10.0.10.180 19
+10.0.10.179 18
+10.0.10.178 17
+10.0.10.177 16
+10.0.10.176 15
+10.0.10.175 14
+10.0.10.174 13
+10.0.10.173 12
+10.0.10.172 11
+10.0.10.171 10
+10.0.10.170 9
+10.0.10.169 8
+10.0.10.168 20
+10.0.10.167 21
+10.0.10.166 22
+10.0.10.165 23
+10.0.10.164 24
+10.0.10.163 8
+10.0.10.162 9
+10.0.10.161 10
+10.0.10.160 31
+10.0.10.159 30
+10.0.10.158 29
+10.0.10.157 28
+10.0.10.156 27
+10.0.10.155 26
+10.0.10.154 25
+10.0.10.153 24
+10.0.10.152 23
+10.0.10.151 22
+10.0.10.150 21
+10.0.10.149 20
+10.0.10.148 19
+10.0.10.147 18
+10.0.10.146 17
+10.0.10.145 16
+10.0.10.144 15
+10.0.10.143 14
+10.0.10.142 13
+10.0.10.141 12
+10.0.10.140 11
+10.0.10.139 10
+10.0.10.138 9
+10.0.10.137 8
+10.0.10.136 31
+10.0.10.135 11
+10.0.10.134 12
+10.0.10.133 13
+10.0.10.132 14
+10.0.10.131 26
+10.0.10.130 27
+10.0.10.129 28
+10.0.10.128 31
+10.0.10.127 30
+10.0.10.126 29
+10.0.10.125 28
+10.0.10.124 27
+10.0.10.123 26
+10.0.10.122 25
+10.0.10.121 24
+10.0.10.120 23
+10.0.10.119 22
+10.0.10.118 21
+10.0.10.117 20
+10.0.10.116 19
+10.0.10.115 18
+10.0.10.114 17
+10.0.10.113 16
+10.0.10.112 15
+10.0.10.111 14
+10.0.10.110 13
+10.0.10.109 12
+10.0.10.108 11
+10.0.10.107 10
+10.0.10.106 9
+10.0.10.105 8
+10.0.10.104 25
+10.0.10.103 26
+10.0.10.102 27
+10.0.10.101 28
+10.0.10.100 29
+10.0.10.99 30
+10.0.10.98 15
+10.0.10.97 16
+10.0.10.96 31
+10.0.10.95 30
+10.0.10.94 29
+10.0.10.93 28
+10.0.10.92 27
+10.0.10.91 26
+10.0.10.90 25
+10.0.10.89 24
+10.0.10.88 23
+10.0.10.87 22
+10.0.10.86 21
+10.0.10.85 20
+10.0.10.84 19
+10.0.10.83 18
+10.0.10.82 17
+10.0.10.81 16
+10.0.10.80 15
+10.0.10.79 14
+10.0.10.78 13
+10.0.10.77 12
+10.0.10.76 11
+10.0.10.75 10
+10.0.10.74 9
+10.0.10.73 8
+10.0.10.72 17
+10.0.10.71 18
+10.0.10.70 19
+10.0.10.69 20
+10.0.10.68 21
+10.0.10.67 22
+10.0.10.66 23
+10.0.10.65 24
+10.0.10.64 31
+10.0.10.63 30
+10.0.10.62 29
+10.0.10.61 28
+10.0.10.60 27
+10.0.10.59 26
+10.0.10.58 25
+10.0.10.57 24
+10.0.10.56 23
+10.0.10.55 22
+10.0.10.54 21
+10.0.10.53 20
+10.0.10.52 19
+10.0.10.51 18
+10.0.10.50 17
+10.0.10.49 16
+10.0.10.48 15
+10.0.10.47 14
+10.0.10.46 13
+10.0.10.45 12
+10.0.10.44 11
+10.0.10.43 10
+10.0.10.42 9
+10.0.10.41 8
+10.0.10.40 31
+10.0.10.39 8
+10.0.10.38 9
+10.0.10.37 10
+10.0.10.36 11
+10.0.10.35 12
+10.0.10.34 13
+10.0.10.33 14
+10.0.10.32 31
+10.0.10.31 30
+10.0.10.30 29
+10.0.10.29 28
+10.0.10.28 27
+10.0.10.27 26
+10.0.10.26 25
+10.0.10.25 24
+10.0.10.24 23
+10.0.10.23 22
+10.0.10.22 21
+10.0.10.21 20
+10.0.10.20 19
+10.0.10.19 18
+10.0.10.18 17
+10.0.10.17 16
+10.0.10.16 15
+10.0.10.15 14
+10.0.10.14 13
+10.0.10.13 12
+10.0.10.12 11
+10.0.10.11 10
+10.0.10.10 9
+10.0.10.9 8
+10.0.10.8 31
+10.0.10.7 19
+10.0.10.6 20
+10.0.10.5 21
+10.0.10.4 22
+10.0.10.3 23
+10.0.10.2 24
+10.0.10.1 25
+EOF
+
+simple_test 2,2,2,2,2,2,2,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 <<EOF
+10.0.10.1 0
+10.0.10.2 2
+10.0.10.3 2
+10.0.10.4 3
+10.0.10.5 4
+10.0.10.6 5
+10.0.10.7 6
+10.0.10.8 7
+10.0.10.9 8
+10.0.10.10 9
+10.0.10.11 10
+10.0.10.12 11
+10.0.10.13 12
+10.0.10.14 13
+10.0.10.15 14
+10.0.10.16 15
+10.0.10.17 16
+10.0.10.18 17
+10.0.10.19 18
+10.0.10.20 19
+10.0.10.21 20
+10.0.10.22 21
+10.0.10.23 22
+10.0.10.24 23
+10.0.10.25 24
+10.0.10.26 25
+10.0.10.27 26
+10.0.10.28 27
+10.0.10.29 28
+10.0.10.30 29
+10.0.10.31 30
+10.0.10.32 31
+10.0.10.33 0
+10.0.10.34 2
+10.0.10.35 2
+10.0.10.36 3
+10.0.10.37 4
+10.0.10.38 5
+10.0.10.39 6
+10.0.10.40 7
+10.0.10.41 8
+10.0.10.42 9
+10.0.10.43 10
+10.0.10.44 11
+10.0.10.45 12
+10.0.10.46 13
+10.0.10.47 14
+10.0.10.48 15
+10.0.10.49 16
+10.0.10.50 17
+10.0.10.51 18
+10.0.10.52 19
+10.0.10.53 20
+10.0.10.54 21
+10.0.10.55 22
+10.0.10.56 23
+10.0.10.57 24
+10.0.10.58 25
+10.0.10.59 26
+10.0.10.60 27
+10.0.10.61 28
+10.0.10.62 29
+10.0.10.63 30
+10.0.10.64 31
+10.0.10.65 0
+10.0.10.66 2
+10.0.10.67 2
+10.0.10.68 3
+10.0.10.69 4
+10.0.10.70 5
+10.0.10.71 6
+10.0.10.72 7
+10.0.10.73 8
+10.0.10.74 9
+10.0.10.75 10
+10.0.10.76 11
+10.0.10.77 12
+10.0.10.78 13
+10.0.10.79 14
+10.0.10.80 15
+10.0.10.81 16
+10.0.10.82 17
+10.0.10.83 18
+10.0.10.84 19
+10.0.10.85 20
+10.0.10.86 21
+10.0.10.87 22
+10.0.10.88 23
+10.0.10.89 24
+10.0.10.90 25
+10.0.10.91 26
+10.0.10.92 27
+10.0.10.93 28
+10.0.10.94 29
+10.0.10.95 30
+10.0.10.96 31
+10.0.10.97 0
+10.0.10.98 2
+10.0.10.99 2
+10.0.10.100 3
+10.0.10.101 4
+10.0.10.102 5
+10.0.10.103 6
+10.0.10.104 7
+10.0.10.105 8
+10.0.10.106 9
+10.0.10.107 10
+10.0.10.108 11
+10.0.10.109 12
+10.0.10.110 13
+10.0.10.111 14
+10.0.10.112 15
+10.0.10.113 16
+10.0.10.114 17
+10.0.10.115 18
+10.0.10.116 19
+10.0.10.117 20
+10.0.10.118 21
+10.0.10.119 22
+10.0.10.120 23
+10.0.10.121 24
+10.0.10.122 25
+10.0.10.123 26
+10.0.10.124 27
+10.0.10.125 28
+10.0.10.126 29
+10.0.10.127 30
+10.0.10.128 31
+10.0.10.129 0
+10.0.10.130 2
+10.0.10.131 2
+10.0.10.132 3
+10.0.10.133 4
+10.0.10.134 5
+10.0.10.135 6
+10.0.10.136 7
+10.0.10.137 8
+10.0.10.138 9
+10.0.10.139 10
+10.0.10.140 11
+10.0.10.141 12
+10.0.10.142 13
+10.0.10.143 14
+10.0.10.144 15
+10.0.10.145 16
+10.0.10.146 17
+10.0.10.147 18
+10.0.10.148 19
+10.0.10.149 20
+10.0.10.150 21
+10.0.10.151 22
+10.0.10.152 23
+10.0.10.153 24
+10.0.10.154 25
+10.0.10.155 26
+10.0.10.156 27
+10.0.10.157 28
+10.0.10.158 29
+10.0.10.159 30
+10.0.10.160 31
+10.0.10.161 0
+10.0.10.162 2
+10.0.10.163 2
+10.0.10.164 3
+10.0.10.165 4
+10.0.10.166 5
+10.0.10.167 6
+10.0.10.168 7
+10.0.10.169 8
+10.0.10.170 9
+10.0.10.171 10
+10.0.10.172 11
+10.0.10.173 12
+10.0.10.174 13
+10.0.10.175 14
+10.0.10.176 15
+10.0.10.177 16
+10.0.10.178 17
+10.0.10.179 18
+10.0.10.180 19
+10.0.10.181 20
+10.0.10.182 21
+10.0.10.183 22
+10.0.10.184 23
+10.0.10.185 24
+10.0.10.186 25
+10.0.10.187 26
+10.0.10.188 27
+10.0.10.189 28
+10.0.10.190 29
+10.0.10.191 30
+10.0.10.192 31
+10.0.10.193 0
+10.0.10.194 2
+10.0.10.195 2
+10.0.10.196 3
+10.0.10.197 4
+10.0.10.198 5
+10.0.10.199 6
+10.0.10.200 7
+10.0.10.201 8
+10.0.10.202 9
+10.0.10.203 10
+10.0.10.204 11
+10.0.10.205 12
+10.0.10.206 13
+10.0.10.207 14
+10.0.10.208 15
+10.0.10.209 16
+10.0.10.210 17
+10.0.10.211 18
+10.0.10.212 19
+10.0.10.213 20
+10.0.10.214 21
+10.0.10.215 22
+10.0.10.216 23
+10.0.10.217 24
+10.0.10.218 25
+10.0.10.219 26
+10.0.10.220 27
+10.0.10.221 28
+10.0.10.222 29
+10.0.10.223 30
+10.0.10.224 31
+10.0.10.225 0
+10.0.10.226 2
+10.0.10.227 2
+10.0.10.228 3
+10.0.10.229 4
+10.0.10.230 5
+10.0.10.231 6
+10.0.10.232 7
+10.0.10.233 8
+10.0.10.234 9
+10.0.10.235 10
+10.0.10.236 11
+10.0.10.237 12
+10.0.10.238 13
+10.0.10.239 14
+10.0.10.240 15
+10.0.10.241 16
+10.0.10.242 17
+10.0.10.243 18
+10.0.10.244 19
+10.0.10.245 20
+10.0.10.246 21
+10.0.10.247 22
+10.0.10.248 23
+10.0.10.249 24
+10.0.10.250 25
+10.0.11.1 26
+10.0.11.2 27
+10.0.11.3 28
+10.0.11.4 29
+10.0.11.5 30
+10.0.11.6 31
+10.0.11.7 0
+10.0.11.8 2
+10.0.11.9 2
+10.0.11.10 3
+10.0.11.11 4
+10.0.11.12 5
+10.0.11.13 6
+10.0.11.14 7
+10.0.11.15 8
+10.0.11.16 9
+10.0.11.17 10
+10.0.11.18 11
+10.0.11.19 12
+10.0.11.20 13
+10.0.11.21 14
+10.0.11.22 15
+10.0.11.23 16
+10.0.11.24 17
+10.0.11.25 18
+10.0.11.26 19
+10.0.11.27 20
+10.0.11.28 21
+10.0.11.29 22
+10.0.11.30 23
+10.0.11.31 24
+10.0.11.32 25
+10.0.11.33 26
+10.0.11.34 27
+10.0.11.35 28
+10.0.11.36 29
+10.0.11.37 30
+10.0.11.38 31
+10.0.11.39 0
+10.0.11.40 2
+10.0.11.41 2
+10.0.11.42 3
+10.0.11.43 4
+10.0.11.44 5
+10.0.11.45 6
+10.0.11.46 7
+10.0.11.47 8
+10.0.11.48 9
+10.0.11.49 10
+10.0.11.50 11
+10.0.11.51 12
+10.0.11.52 13
+10.0.11.53 14
+10.0.11.54 15
+10.0.11.55 16
+10.0.11.56 17
+10.0.11.57 18
+10.0.11.58 19
+10.0.11.59 20
+10.0.11.60 21
+10.0.11.61 22
+10.0.11.62 23
+10.0.11.63 24
+10.0.11.64 25
+10.0.11.65 26
+10.0.11.66 27
+10.0.11.67 28
+10.0.11.68 29
+10.0.11.69 30
+10.0.11.70 31
+10.0.11.71 0
+10.0.11.72 2
+10.0.11.73 2
+10.0.11.74 3
+10.0.11.75 4
+10.0.11.76 5
+10.0.11.77 6
+10.0.11.78 7
+10.0.11.79 8
+10.0.11.80 9
+10.0.11.81 10
+10.0.11.82 11
+10.0.11.83 12
+10.0.11.84 13
+10.0.11.85 14
+10.0.11.86 15
+10.0.11.87 16
+10.0.11.88 17
+10.0.11.89 18
+10.0.11.90 19
+10.0.11.91 20
+10.0.11.92 21
+10.0.11.93 22
+10.0.11.94 23
+10.0.11.95 24
+10.0.11.96 25
+10.0.11.97 26
+10.0.11.98 27
+10.0.11.99 28
+10.0.11.100 29
+10.0.11.101 30
+10.0.11.102 31
+10.0.11.103 0
+10.0.11.104 2
+10.0.11.105 2
+10.0.11.106 3
+10.0.11.107 4
+10.0.11.108 5
+10.0.11.109 6
+10.0.11.110 7
+10.0.11.111 8
+10.0.11.112 9
+10.0.11.113 10
+10.0.11.114 11
+10.0.11.115 12
+10.0.11.116 13
+10.0.11.117 14
+10.0.11.118 15
+10.0.11.119 16
+10.0.11.120 17
+10.0.11.121 18
+10.0.11.122 19
+10.0.11.123 20
+10.0.11.124 21
+10.0.11.125 22
+10.0.11.126 23
+10.0.11.127 24
+10.0.11.128 25
+10.0.11.129 26
+10.0.11.130 27
+10.0.11.131 28
+10.0.11.132 29
+10.0.11.133 30
+10.0.11.134 31
+10.0.11.135 0
+10.0.11.136 2
+10.0.11.137 2
+10.0.11.138 3
+10.0.11.139 4
+10.0.11.140 5
+10.0.11.141 6
+10.0.11.142 7
+10.0.11.143 8
+10.0.11.144 9
+10.0.11.145 10
+10.0.11.146 11
+10.0.11.147 12
+10.0.11.148 13
+10.0.11.149 14
+10.0.11.150 15
+10.0.11.151 16
+10.0.11.152 17
+10.0.11.153 18
+10.0.11.154 19
+10.0.11.155 20
+10.0.11.156 21
+10.0.11.157 22
+10.0.11.158 23
+10.0.11.159 24
+10.0.11.160 25
+10.0.11.161 26
+10.0.11.162 27
+10.0.11.163 28
+10.0.11.164 29
+10.0.11.165 30
+10.0.11.166 31
+10.0.11.167 0
+10.0.11.168 2
+10.0.11.169 2
+10.0.11.170 3
+10.0.11.171 4
+10.0.11.172 5
+10.0.11.173 6
+10.0.11.174 7
+10.0.11.175 8
+10.0.11.176 9
+10.0.11.177 10
+10.0.11.178 11
+10.0.11.179 12
+10.0.11.180 13
+10.0.11.181 14
+10.0.11.182 15
+10.0.11.183 16
+10.0.11.184 17
+10.0.11.185 18
+10.0.11.186 19
+10.0.11.187 20
+10.0.11.188 21
+10.0.11.189 22
+10.0.11.190 23
+10.0.11.191 24
+10.0.11.192 25
+10.0.11.193 26
+10.0.11.194 27
+10.0.11.195 28
+10.0.11.196 29
+10.0.11.197 30
+10.0.11.198 31
+10.0.11.199 0
+10.0.11.200 2
+10.0.11.201 2
+10.0.11.202 3
+10.0.11.203 4
+10.0.11.204 5
+10.0.11.205 6
+10.0.11.206 7
+10.0.11.207 8
+10.0.11.208 9
+10.0.11.209 10
+10.0.11.210 11
+10.0.11.211 12
+10.0.11.212 13
+10.0.11.213 14
+10.0.11.214 15
+10.0.11.215 16
+10.0.11.216 17
+10.0.11.217 18
+10.0.11.218 19
+10.0.11.219 20
+10.0.11.220 21
+10.0.11.221 22
+10.0.11.222 23
+10.0.11.223 24
+10.0.11.224 25
+10.0.11.225 26
+10.0.11.226 27
+10.0.11.227 28
+10.0.11.228 29
+10.0.11.229 30
+10.0.11.230 31
+10.0.11.231 0
+10.0.11.232 2
+10.0.11.233 2
+10.0.11.234 3
+10.0.11.235 4
+10.0.11.236 5
+10.0.11.237 6
+10.0.11.238 7
+10.0.11.239 8
+10.0.11.240 9
+10.0.11.241 10
+10.0.11.242 11
+10.0.11.243 12
+10.0.11.244 13
+10.0.11.245 14
+10.0.11.246 15
+10.0.11.247 16
+10.0.11.248 17
+10.0.11.249 18
+10.0.11.250 19
+10.0.12.1 20
+10.0.12.2 21
+10.0.12.3 22
+10.0.12.4 23
+10.0.12.5 24
+10.0.12.6 25
+10.0.12.7 26
+10.0.12.8 27
+10.0.12.9 28
+10.0.12.10 29
+10.0.12.11 30
+10.0.12.12 31
+10.0.12.13 0
+10.0.12.14 2
+10.0.12.15 2
+10.0.12.16 3
+10.0.12.17 4
+10.0.12.18 5
+10.0.12.19 6
+10.0.12.20 7
+10.0.12.21 8
+10.0.12.22 9
+10.0.12.23 10
+10.0.12.24 11
+10.0.12.25 12
+10.0.12.26 13
+10.0.12.27 14
+10.0.12.28 15
+10.0.12.29 16
+10.0.12.30 17
+10.0.12.31 18
+10.0.12.32 19
+10.0.12.33 20
+10.0.12.34 21
+10.0.12.35 22
+10.0.12.36 23
+10.0.12.37 24
+10.0.12.38 25
+10.0.12.39 26
+10.0.12.40 27
+10.0.12.41 28
+10.0.12.42 29
+10.0.12.43 30
+10.0.12.44 31
+10.0.12.45 0
+10.0.12.46 2
+10.0.12.47 2
+10.0.12.48 3
+10.0.12.49 4
+10.0.12.50 5
+10.0.12.51 6
+10.0.12.52 7
+10.0.12.53 8
+10.0.12.54 9
+10.0.12.55 10
+10.0.12.56 11
+10.0.12.57 12
+10.0.12.58 13
+10.0.12.59 14
+10.0.12.60 15
+10.0.12.61 16
+10.0.12.62 17
+10.0.12.63 18
+10.0.12.64 19
+10.0.12.65 20
+10.0.12.66 21
+10.0.12.67 22
+10.0.12.68 23
+10.0.12.69 24
+10.0.12.70 25
+10.0.12.71 26
+10.0.12.72 27
+10.0.12.73 28
+10.0.12.74 29
+10.0.12.75 30
+10.0.12.76 31
+10.0.12.77 0
+10.0.12.78 2
+10.0.12.79 2
+10.0.12.80 3
+10.0.12.81 4
+10.0.12.82 5
+10.0.12.83 6
+10.0.12.84 7
+10.0.12.85 8
+10.0.12.86 9
+10.0.12.87 10
+10.0.12.88 11
+10.0.12.89 12
+10.0.12.90 13
+10.0.12.91 14
+10.0.12.92 15
+10.0.12.93 16
+10.0.12.94 17
+10.0.12.95 18
+10.0.12.96 19
+10.0.12.97 20
+10.0.12.98 21
+10.0.12.99 22
+10.0.12.100 23
+10.0.12.101 24
+10.0.12.102 25
+10.0.12.103 26
+10.0.12.104 27
+10.0.12.105 28
+10.0.12.106 29
+10.0.12.107 30
+10.0.12.108 31
+10.0.12.109 0
+10.0.12.110 2
+10.0.12.111 2
+10.0.12.112 3
+10.0.12.113 4
+10.0.12.114 5
+10.0.12.115 6
+10.0.12.116 7
+10.0.12.117 8
+10.0.12.118 9
+10.0.12.119 10
+10.0.12.120 11
+10.0.12.121 12
+10.0.12.122 13
+10.0.12.123 14
+10.0.12.124 15
+10.0.12.125 16
+10.0.12.126 17
+10.0.12.127 18
+10.0.12.128 19
+10.0.12.129 20
+10.0.12.130 21
+10.0.12.131 22
+10.0.12.132 23
+10.0.12.133 24
+10.0.12.134 25
+10.0.12.135 26
+10.0.12.136 27
+10.0.12.137 28
+10.0.12.138 29
+10.0.12.139 30
+10.0.12.140 31
+10.0.12.141 0
+10.0.12.142 2
+10.0.12.143 2
+10.0.12.144 3
+10.0.12.145 4
+10.0.12.146 5
+10.0.12.147 6
+10.0.12.148 7
+10.0.12.149 8
+10.0.12.150 9
+10.0.12.151 10
+10.0.12.152 11
+10.0.12.153 12
+10.0.12.154 13
+10.0.12.155 14
+10.0.12.156 15
+10.0.12.157 16
+10.0.12.158 17
+10.0.12.159 18
+10.0.12.160 19
+10.0.12.161 20
+10.0.12.162 21
+10.0.12.163 22
+10.0.12.164 23
+10.0.12.165 24
+10.0.12.166 25
+10.0.12.167 26
+10.0.12.168 27
+10.0.12.169 28
+10.0.12.170 29
+10.0.12.171 30
+10.0.12.172 31
+10.0.12.173 0
+10.0.12.174 2
+10.0.12.175 2
+10.0.12.176 3
+10.0.12.177 4
+10.0.12.178 5
+10.0.12.179 6
+10.0.12.180 7
+10.0.12.181 8
+10.0.12.182 9
+10.0.12.183 10
+10.0.12.184 11
+10.0.12.185 12
+10.0.12.186 13
+10.0.12.187 14
+10.0.12.188 15
+10.0.12.189 16
+10.0.12.190 17
+10.0.12.191 18
+10.0.12.192 19
+10.0.12.193 20
+10.0.12.194 21
+10.0.12.195 22
+10.0.12.196 23
+10.0.12.197 24
+10.0.12.198 25
+10.0.12.199 26
+10.0.12.200 27
+10.0.12.201 28
+10.0.12.202 29
+10.0.12.203 30
+10.0.12.204 31
+10.0.12.205 0
+10.0.12.206 2
+10.0.12.207 2
+10.0.12.208 3
+10.0.12.209 4
+10.0.12.210 5
+10.0.12.211 6
+10.0.12.212 7
+10.0.12.213 8
+10.0.12.214 9
+10.0.12.215 10
+10.0.12.216 11
+10.0.12.217 12
+10.0.12.218 13
+10.0.12.219 14
+10.0.12.220 15
+10.0.12.221 16
+10.0.12.222 17
+10.0.12.223 18
+10.0.12.224 19
+10.0.12.225 20
+10.0.12.226 21
+10.0.12.227 22
+10.0.12.228 23
+10.0.12.229 24
+10.0.12.230 25
+10.0.12.231 26
+10.0.12.232 27
+10.0.12.233 28
+10.0.12.234 29
+10.0.12.235 30
+10.0.12.236 31
+10.0.12.237 0
+10.0.12.238 2
+10.0.12.239 2
+10.0.12.240 3
+10.0.12.241 4
+10.0.12.242 5
+10.0.12.243 6
+10.0.12.244 7
+10.0.12.245 8
+10.0.12.246 9
+10.0.12.247 10
+10.0.12.248 11
+10.0.12.249 12
+10.0.12.250 13
+10.0.13.1 14
+10.0.13.2 15
+10.0.13.3 16
+10.0.13.4 17
+10.0.13.5 18
+10.0.13.6 19
+10.0.13.7 20
+10.0.13.8 21
+10.0.13.9 22
+10.0.13.10 23
+10.0.13.11 24
+10.0.13.12 25
+10.0.13.13 26
+10.0.13.14 27
+10.0.13.15 28
+10.0.13.16 29
+10.0.13.17 30
+10.0.13.18 31
+10.0.13.19 0
+10.0.13.20 2
+10.0.13.21 2
+10.0.13.22 3
+10.0.13.23 4
+10.0.13.24 5
+10.0.13.25 6
+10.0.13.26 7
+10.0.13.27 8
+10.0.13.28 9
+10.0.13.29 10
+10.0.13.30 11
+10.0.13.31 12
+10.0.13.32 13
+10.0.13.33 14
+10.0.13.34 15
+10.0.13.35 16
+10.0.13.36 17
+10.0.13.37 18
+10.0.13.38 19
+10.0.13.39 20
+10.0.13.40 21
+10.0.13.41 22
+10.0.13.42 23
+10.0.13.43 24
+10.0.13.44 25
+10.0.13.45 26
+10.0.13.46 27
+10.0.13.47 28
+10.0.13.48 29
+10.0.13.49 30
+10.0.13.50 31
+10.0.13.51 0
+10.0.13.52 2
+10.0.13.53 2
+10.0.13.54 3
+10.0.13.55 4
+10.0.13.56 5
+10.0.13.57 6
+10.0.13.58 7
+10.0.13.59 8
+10.0.13.60 9
+10.0.13.61 10
+10.0.13.62 11
+10.0.13.63 12
+10.0.13.64 13
+10.0.13.65 14
+10.0.13.66 15
+10.0.13.67 16
+10.0.13.68 17
+10.0.13.69 18
+10.0.13.70 19
+10.0.13.71 20
+10.0.13.72 21
+10.0.13.73 22
+10.0.13.74 23
+10.0.13.75 24
+10.0.13.76 25
+10.0.13.77 26
+10.0.13.78 27
+10.0.13.79 28
+10.0.13.80 29
+10.0.13.81 30
+10.0.13.82 31
+10.0.13.83 0
+10.0.13.84 2
+10.0.13.85 2
+10.0.13.86 3
+10.0.13.87 4
+10.0.13.88 5
+10.0.13.89 6
+10.0.13.90 7
+10.0.13.91 8
+10.0.13.92 9
+10.0.13.93 10
+10.0.13.94 11
+10.0.13.95 12
+10.0.13.96 13
+10.0.13.97 14
+10.0.13.98 15
+10.0.13.99 16
+10.0.13.100 17
+10.0.13.101 18
+10.0.13.102 19
+10.0.13.103 20
+10.0.13.104 21
+10.0.13.105 22
+10.0.13.106 23
+10.0.13.107 24
+10.0.13.108 25
+10.0.13.109 26
+10.0.13.110 27
+10.0.13.111 28
+10.0.13.112 29
+10.0.13.113 30
+10.0.13.114 31
+10.0.13.115 0
+10.0.13.116 2
+10.0.13.117 2
+10.0.13.118 3
+10.0.13.119 4
+10.0.13.120 5
+10.0.13.121 6
+10.0.13.122 7
+10.0.13.123 8
+10.0.13.124 9
+10.0.13.125 10
+10.0.13.126 11
+10.0.13.127 12
+10.0.13.128 13
+10.0.13.129 14
+10.0.13.130 15
+10.0.13.131 16
+10.0.13.132 17
+10.0.13.133 18
+10.0.13.134 19
+10.0.13.135 20
+10.0.13.136 21
+10.0.13.137 22
+10.0.13.138 23
+10.0.13.139 24
+10.0.13.140 25
+10.0.13.141 26
+10.0.13.142 27
+10.0.13.143 28
+10.0.13.144 29
+10.0.13.145 30
+10.0.13.146 31
+10.0.13.147 0
+10.0.13.148 2
+10.0.13.149 2
+10.0.13.150 3
+10.0.13.151 4
+10.0.13.152 5
+10.0.13.153 6
+10.0.13.154 7
+10.0.13.155 8
+10.0.13.156 9
+10.0.13.157 10
+10.0.13.158 11
+10.0.13.159 12
+10.0.13.160 13
+10.0.13.161 14
+10.0.13.162 15
+10.0.13.163 16
+10.0.13.164 17
+10.0.13.165 18
+10.0.13.166 19
+10.0.13.167 20
+10.0.13.168 21
+10.0.13.169 22
+10.0.13.170 23
+10.0.13.171 24
+10.0.13.172 25
+10.0.13.173 26
+10.0.13.174 27
+10.0.13.175 28
+10.0.13.176 29
+10.0.13.177 30
+10.0.13.178 31
+10.0.13.179 0
+10.0.13.180 2
+10.0.13.181 2
+10.0.13.182 3
+10.0.13.183 4
+10.0.13.184 5
+10.0.13.185 6
+10.0.13.186 7
+10.0.13.187 8
+10.0.13.188 9
+10.0.13.189 10
+10.0.13.190 11
+10.0.13.191 12
+10.0.13.192 13
+10.0.13.193 14
+10.0.13.194 15
+10.0.13.195 16
+10.0.13.196 17
+10.0.13.197 18
+10.0.13.198 19
+10.0.13.199 20
+10.0.13.200 21
+10.0.13.201 22
+10.0.13.202 23
+10.0.13.203 24
+10.0.13.204 25
+10.0.13.205 26
+10.0.13.206 27
+10.0.13.207 28
+10.0.13.208 29
+10.0.13.209 30
+10.0.13.210 31
+10.0.13.211 0
+10.0.13.212 2
+10.0.13.213 2
+10.0.13.214 3
+10.0.13.215 4
+10.0.13.216 5
+10.0.13.217 6
+10.0.13.218 7
+10.0.13.219 8
+10.0.13.220 9
+10.0.13.221 10
+10.0.13.222 11
+10.0.13.223 12
+10.0.13.224 13
+10.0.13.225 14
+10.0.13.226 15
+10.0.13.227 16
+10.0.13.228 17
+10.0.13.229 18
+10.0.13.230 19
+10.0.13.231 20
+10.0.13.232 21
+10.0.13.233 22
+10.0.13.234 23
+10.0.13.235 24
+10.0.13.236 25
+10.0.13.237 26
+10.0.13.238 27
+10.0.13.239 28
+10.0.13.240 29
+10.0.13.241 30
+10.0.13.242 31
+10.0.13.243 0
+10.0.13.244 2
+10.0.13.245 2
+10.0.13.246 3
+10.0.13.247 4
+10.0.13.248 5
+10.0.13.249 6
+10.0.13.250 7
+EOF
@@ -61,6 +61,8 @@ RecBufferSizeLimit         = 1000000
 QueueBufferSize            = 1024
 IPAllocAlgorithm           = 2
 AllowMixedVersions         = 0
+MigrationsMakeReadOnly     = 0
+VacuumFastPathLimit        = 0
 EOF
 
 simple_test
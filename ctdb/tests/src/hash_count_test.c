@@ -85,7 +85,7 @@ static void do_test2(void)
 	TALLOC_CTX *mem_ctx = talloc_new(NULL);
 	struct timeval interval = {1, 0};
 	TDB_DATA key;
-	uint64_t count = 0;
+	uint64_t count = 0, counter;
 	int ret;
 
 	key.dptr = (uint8_t *)discard_const(KEY);
@@ -94,6 +94,10 @@ static void do_test2(void)
 	ret = hash_count_init(mem_ctx, interval, test2_handler, &count, &hc);
 	assert(ret == 0);
 
+	ret = hash_count_get(hc, key, &counter);
+	assert(ret == 0);
+	assert(counter == 0);
+
 	ret = hash_count_increment(hc, key);
 	assert(ret == 0);
 	assert(count == 1);
@@ -105,6 +109,10 @@ static void do_test2(void)
 	assert(ret == 0);
 	assert(count == 2);
 
+	ret = hash_count_get(hc, key, &counter);
+	assert(ret == 0);
+	assert(counter == 2);
+
 	sleep(2);
 
 	ret = hash_count_increment(hc, key);
@@ -113,6 +121,10 @@ static void do_test2(void)
 
 	sleep(2);
 
+	ret = hash_count_get(hc, key, &counter);
+	assert(ret == 0);
+	assert(counter == 0);
+
 	hash_count_expire(hc, &ret);
 	assert(ret == 1);
 
@@ -354,7 +354,11 @@ static int ldb_kv_modified(struct ldb_module *module, struct ldb_dn *dn)
 				  ldb_kv->kv_ops->name(ldb_kv),
 				  ldb_dn_get_linearized(dn));
 		}
-		ret = ldb_kv_reindex(module);
+		if (ldb_dn_check_special(dn, LDB_KV_INDEXLIST)) {
+			ret = ldb_kv_reindex_indexlist(module);
+		} else {
+			ret = ldb_kv_reindex(module);
+		}
 	}
 
 	/* If the modify was to a normal record, or any special except @BASEINFO, update the seq number */
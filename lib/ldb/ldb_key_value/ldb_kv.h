@@ -179,6 +179,9 @@ struct ldb_kv_context {
 struct ldb_kv_reindex_context {
 	int error;
 	uint32_t count;
+	/* newly indexed attributes, for an incremental re-index */
+	struct ldb_message_element *attrs;
+	struct ldb_module *module;
 };
 
 struct ldb_kv_repack_context {
@@ -273,6 +276,7 @@ int ldb_kv_index_del_value(struct ldb_module *module,
 			   struct ldb_message_element *el,
 			   unsigned int v_idx);
 int ldb_kv_reindex(struct ldb_module *module);
+int ldb_kv_reindex_indexlist(struct ldb_module *module);
 int ldb_kv_repack(struct ldb_module *module);
 int ldb_kv_index_transaction_start(
 	struct ldb_module *module,
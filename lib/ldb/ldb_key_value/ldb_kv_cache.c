@@ -247,8 +247,9 @@ static int ldb_kv_index_load(struct ldb_module *module,
 
 	if (ldb->schema.index_handler_override) {
 		/*
-		 * we skip loading the @INDEXLIST record when a module is
-		 * supplying its own attribute handling
+		 * we skip using the @INDEXLIST record when a module is
+		 * supplying its own attribute handling, it is only kept
+		 * so ldb_kv_reindex_indexlist() can see what changed
 		 */
 		ldb_kv->cache->attribute_indexes = true;
 		ldb_kv->cache->one_level_indexes =
@@ -257,6 +258,28 @@ static int ldb_kv_index_load(struct ldb_module *module,
 		    ldb->schema.GUID_index_attribute;
 		ldb_kv->cache->GUID_index_dn_component =
 		    ldb->schema.GUID_index_dn_component;
+
+		talloc_free(ldb_kv->cache->indexlist);
+		ldb_kv->cache->indexlist = ldb_msg_new(ldb_kv->cache);
+		if (ldb_kv->cache->indexlist == NULL) {
+			return -1;
+		}
+
+		indexlist_dn = ldb_dn_new(ldb_kv, ldb, LDB_KV_INDEXLIST);
+		if (indexlist_dn == NULL) {
+			return -1;
+		}
+
+		r = ldb_kv_search_dn1(module,
+				      indexlist_dn,
+				      ldb_kv->cache->indexlist,
+				      LDB_UNPACK_DATA_FLAG_NO_VALUES_ALLOC |
+					  LDB_UNPACK_DATA_FLAG_NO_DN);
+		TALLOC_FREE(indexlist_dn);
+
+		if (r != LDB_SUCCESS && r != LDB_ERR_NO_SUCH_OBJECT) {
+			return -1;
+		}
 		return 0;
 	}
 
@@ -3502,7 +3502,12 @@ static int re_key(struct ldb_kv_private *ldb_kv,
 		return -1;
 	}
 
-	ret = ldb_unpack_data(ldb, &val, msg);
+	/*
+	 * The index code takes its own copy of any value it keeps, so
+	 * there is no need to copy each value out of the record.
+	 */
+	ret = ldb_unpack_data_flags(ldb, &val, msg,
+				    LDB_UNPACK_DATA_FLAG_NO_VALUES_ALLOC);
 	if (ret != 0) {
 		ldb_debug(ldb, LDB_DEBUG_ERROR, "Invalid data for index %s\n",
 						ldb_dn_get_linearized(msg->dn));
@@ -3579,7 +3584,12 @@ static int re_index(struct ldb_kv_private *ldb_kv,
 		return -1;
 	}
 
-	ret = ldb_unpack_data(ldb, &val, msg);
+	/*
+	 * The index code takes its own copy of any value it keeps, so
+	 * there is no need to copy each value out of the record.
+	 */
+	ret = ldb_unpack_data_flags(ldb, &val, msg,
+				    LDB_UNPACK_DATA_FLAG_NO_VALUES_ALLOC);
 	if (ret != 0) {
 		ldb_debug(ldb, LDB_DEBUG_ERROR, "Invalid data for index %s\n",
 						ldb_dn_get_linearized(msg->dn));
@@ -3627,6 +3637,202 @@ static int re_index(struct ldb_kv_private *ldb_kv,
 	return 0;
 }
 
+/*
+  is key (without the DN= prefix) an @INDEX record of one of the newly
+  indexed attributes of an incremental re-index?
+*/
+static bool ldb_kv_index_key_is_new_attr(struct ldb_kv_reindex_context *ctx,
+					 const char *key,
+					 size_t key_len)
+{
+	const char *prefix = LDB_KV_INDEX ":";
+	size_t prefix_len = strlen(prefix);
+	const char *attr;
+	const char *sep;
+	size_t attr_len;
+	unsigned int i;
+
+	if (key_len <= prefix_len ||
+	    strncmp(key, prefix, prefix_len) != 0) {
+		return false;
+	}
+
+	attr = key + prefix_len;
+	sep = memchr(attr, ':', key_len - prefix_len);
+	if (sep == NULL) {
+		return false;
+	}
+	attr_len = sep - attr;
+
+	for (i = 0; i < ctx->attrs->num_values; i++) {
+		const struct ldb_val *v = &ctx->attrs->values[i];
+		if (v->length == attr_len &&
+		    strncasecmp((const char *)v->data, attr, attr_len) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+  traversal function that deletes the @INDEX records of the newly
+  indexed attributes during an incremental re-index
+*/
+static int delete_index_attrs(struct ldb_kv_private *ldb_kv,
+			      struct ldb_val key,
+			      struct ldb_val data,
+			      void *state)
+{
+	struct ldb_kv_reindex_context *ctx =
+	    (struct ldb_kv_reindex_context *)state;
+
+	/* the offset of 3 is to remove the DN= prefix. */
+	if (key.length <= 3 || strncmp((char *)key.data, "DN=", 3) != 0) {
+		return 0;
+	}
+	if (!ldb_kv_index_key_is_new_attr(ctx,
+					  (const char *)key.data + 3,
+					  key.length - 3)) {
+		return 0;
+	}
+
+	return delete_index(ldb_kv, key, data, ldb_kv->module);
+}
+
+/*
+  tdb traversal function that empties the cached @INDEX records of the
+  newly indexed attributes during an incremental re-index.
+
+  With an index_handler_override the attributes may already have been
+  indexed earlier in this transaction.  The empty lists are stored
+  like any other index change, so they go into the sub transaction
+  cache when there is one.
+*/
+static int delete_cached_index_attrs(_UNUSED_ struct tdb_context *tdb,
+				     TDB_DATA key,
+				     _UNUSED_ TDB_DATA data,
+				     void *state)
+{
+	struct ldb_kv_reindex_context *ctx =
+	    (struct ldb_kv_reindex_context *)state;
+	struct ldb_module *module = ctx->module;
+	struct ldb_context *ldb = ldb_module_get_ctx(module);
+	struct dn_list list = { .count = 0, };
+	struct ldb_dn *dn = NULL;
+	struct ldb_val v;
+	int ret;
+
+	v.data = key.dptr;
+	v.length = strnlen((char *)key.dptr, key.dsize);
+
+	if (!ldb_kv_index_key_is_new_attr(ctx, (const char *)v.data,
+					  v.length)) {
+		return 0;
+	}
+
+	dn = ldb_dn_from_ldb_val(module, ldb, &v);
+	if (dn == NULL) {
+		ctx->error = LDB_ERR_OPERATIONS_ERROR;
+		return -1;
+	}
+
+	ret = ldb_kv_dn_list_store(module, dn, &list);
+	talloc_free(dn);
+	if (ret != LDB_SUCCESS) {
+		ctx->error = ret;
+		return -1;
+	}
+	return 0;
+}
+
+/*
+  traversal function that adds @INDEX records for the newly indexed
+  attributes during an incremental re-index
+*/
+static int re_index_attrs(struct ldb_kv_private *ldb_kv,
+			  struct ldb_val key,
+			  struct ldb_val val,
+			  void *state)
+{
+	struct ldb_context *ldb;
+	struct ldb_kv_reindex_context *ctx =
+	    (struct ldb_kv_reindex_context *)state;
+	struct ldb_module *module = ldb_kv->module;
+	struct ldb_message *msg;
+	unsigned int i;
+	int ret;
+	bool is_record;
+
+	ldb = ldb_module_get_ctx(module);
+
+	is_record = ldb_kv_key_is_normal_record(key);
+	if (is_record == false) {
+		return 0;
+	}
+
+	msg = ldb_msg_new(module);
+	if (msg == NULL) {
+		return -1;
+	}
+
+	ret = ldb_unpack_data_flags(ldb, &val, msg,
+				    LDB_UNPACK_DATA_FLAG_NO_VALUES_ALLOC);
+	if (ret != 0) {
+		ldb_debug(ldb, LDB_DEBUG_ERROR, "Invalid data for index %s\n",
+						ldb_dn_get_linearized(msg->dn));
+		ctx->error = ret;
+		talloc_free(msg);
+		return -1;
+	}
+
+	if (msg->dn == NULL) {
+		ldb_debug(ldb, LDB_DEBUG_ERROR,
+			  "Refusing to re-index as GUID "
+			  "key %*.*s with no DN\n",
+			  (int)key.length, (int)key.length,
+			  (char *)key.data);
+		talloc_free(msg);
+		return -1;
+	}
+
+	for (i = 0; i < ctx->attrs->num_values; i++) {
+		const char *attr = (const char *)ctx->attrs->values[i].data;
+		struct ldb_message_element *el = NULL;
+
+		/* An index_handler_override has the last word */
+		if (!ldb_kv_is_indexed(module, ldb_kv, attr)) {
+			continue;
+		}
+		el = ldb_msg_find_element(msg, attr);
+		if (el == NULL) {
+			continue;
+		}
+		ret = ldb_kv_index_add_el(module, ldb_kv, msg, el);
+		if (ret != LDB_SUCCESS) {
+			ldb_asprintf_errstring(ldb,
+					       __location__ ": Failed to re-index %s in %s - %s",
+					       el->name,
+					       ldb_dn_get_linearized(msg->dn),
+					       ldb_errstring(ldb));
+			ctx->error = ret;
+			talloc_free(msg);
+			return -1;
+		}
+	}
+
+	talloc_free(msg);
+
+	ctx->count++;
+	if (ctx->count % 10000 == 0) {
+		ldb_debug(ldb, LDB_DEBUG_WARNING,
+			  "Reindexing: re-indexed %u records so far",
+			  ctx->count);
+	}
+
+	return 0;
+}
+
 /*
  * Convert the 4-byte pack format version to a number that's slightly
  * more intelligible to a user e.g. version 0, 1, 2, etc.
@@ -3736,6 +3942,69 @@ int ldb_kv_repack(struct ldb_module *module)
 	return LDB_SUCCESS;
 }
 
+/*
+ * Calculate the size of the index cache needed for a re-index. If
+ * specified always use the ldb_kv->index_transaction_cache_size
+ * otherwise use the maximum of the size estimate or the
+ * DEFAULT_INDEX_CACHE_SIZE
+ */
+static size_t ldb_kv_reindex_cache_size(struct ldb_kv_private *ldb_kv)
+{
+	size_t index_cache_size;
+
+	if (ldb_kv->index_transaction_cache_size > 0) {
+		return ldb_kv->index_transaction_cache_size;
+	}
+
+	index_cache_size = ldb_kv->kv_ops->get_size(ldb_kv);
+	if (index_cache_size < DEFAULT_INDEX_CACHE_SIZE) {
+		index_cache_size = DEFAULT_INDEX_CACHE_SIZE;
+	}
+	return index_cache_size;
+}
+
+static int ldb_kv_index_cache_copy(_UNUSED_ struct tdb_context *tdb,
+				   TDB_DATA key,
+				   TDB_DATA data,
+				   void *state)
+{
+	struct tdb_context *new_itdb = state;
+
+	return tdb_store(new_itdb, key, data, TDB_INSERT);
+}
+
+/*
+ * Move an index cache into an in memory tdb of cache_size hash
+ * buckets.  The cached dn_lists stay where they are, the tdb only
+ * holds pointers to them.
+ */
+static int ldb_kv_index_cache_resize(struct ldb_kv_idxptr *idxptr,
+				     size_t cache_size)
+{
+	struct tdb_context *new_itdb = NULL;
+	int ret;
+
+	if (idxptr == NULL || idxptr->itdb == NULL) {
+		return LDB_SUCCESS;
+	}
+
+	new_itdb = tdb_open(NULL, cache_size, TDB_INTERNAL, O_RDWR, 0);
+	if (new_itdb == NULL) {
+		return LDB_ERR_OPERATIONS_ERROR;
+	}
+
+	ret = tdb_traverse(idxptr->itdb, ldb_kv_index_cache_copy, new_itdb);
+	if (ret < 0) {
+		ret = ltdb_err_map(tdb_error(new_itdb));
+		tdb_close(new_itdb);
+		return ret;
+	}
+
+	tdb_close(idxptr->itdb);
+	idxptr->itdb = new_itdb;
+	return LDB_SUCCESS;
+}
+
 /*
   force a complete reindex of the database
 */
@@ -3769,24 +4038,10 @@ int ldb_kv_reindex(struct ldb_module *module)
 		ldb_kv_index_sub_transaction_cancel(ldb_kv);
 	}
 
-	/*
-	 * Calculate the size of the index cache needed for
-	 * the re-index. If specified always use the
-	 * ldb_kv->index_transaction_cache_size otherwise use the maximum
-	 * of the size estimate or the DEFAULT_INDEX_CACHE_SIZE
-	 */
-	if (ldb_kv->index_transaction_cache_size > 0) {
-		index_cache_size = ldb_kv->index_transaction_cache_size;
-	} else {
-		index_cache_size = ldb_kv->kv_ops->get_size(ldb_kv);
-		if (index_cache_size < DEFAULT_INDEX_CACHE_SIZE) {
-			index_cache_size = DEFAULT_INDEX_CACHE_SIZE;
-		}
-	}
-
 	/*
 	 * Note that we don't start an index sub transaction for re-indexing
 	 */
+	index_cache_size = ldb_kv_reindex_cache_size(ldb_kv);
 	ret = ldb_kv_index_transaction_start(module, index_cache_size);
 	if (ret != LDB_SUCCESS) {
 		return ret;
@@ -3805,6 +4060,8 @@ int ldb_kv_reindex(struct ldb_module *module)
 
 	ctx.error = 0;
 	ctx.count = 0;
+	ctx.attrs = NULL;
+	ctx.module = module;
 
 	ret = ldb_kv->kv_ops->iterate(ldb_kv, re_key, &ctx);
 	if (ret < 0) {
@@ -3848,6 +4105,266 @@ int ldb_kv_reindex(struct ldb_module *module)
 	return LDB_SUCCESS;
 }
 
+/*
+ * Work out if a change to @INDEXLIST did nothing but add attributes to
+ * @IDXATTR.  If so, *added is set to the newly indexed attributes.
+ */
+static bool ldb_kv_indexlist_only_added(TALLOC_CTX *mem_ctx,
+					struct ldb_kv_private *ldb_kv,
+					const struct ldb_message *old_list,
+					const struct ldb_message *new_list,
+					struct ldb_message_element **added)
+{
+	const struct ldb_message *lists[2] = { old_list, new_list };
+	struct ldb_message_element *old_attrs = NULL;
+	struct ldb_message_element *new_attrs = NULL;
+	struct ldb_message_element *el = NULL;
+	unsigned int i, j, k;
+
+	/*
+	 * Anything other than @IDXATTR (@IDXONE, @IDXGUID, ...)
+	 * changes the layout of every index record
+	 */
+	for (k = 0; k < 2; k++) {
+		const struct ldb_message *other = lists[1 - k];
+
+		for (i = 0; i < lists[k]->num_elements; i++) {
+			const struct ldb_message_element *el1 =
+				&lists[k]->elements[i];
+			const struct ldb_message_element *el2 = NULL;
+
+			if (ldb_attr_cmp(el1->name, LDB_KV_IDXATTR) == 0) {
+				continue;
+			}
+			el2 = ldb_msg_find_element(other, el1->name);
+			if (el2 == NULL ||
+			    !ldb_msg_element_equal_ordered(el1, el2)) {
+				return false;
+			}
+		}
+	}
+
+	old_attrs = ldb_msg_find_element(old_list, LDB_KV_IDXATTR);
+	new_attrs = ldb_msg_find_element(new_list, LDB_KV_IDXATTR);
+
+	el = talloc_zero(mem_ctx, struct ldb_message_element);
+	if (el == NULL) {
+		return false;
+	}
+	el->name = LDB_KV_IDXATTR;
+
+	if (old_attrs != NULL) {
+		for (i = 0; i < old_attrs->num_values; i++) {
+			const char *attr =
+				(const char *)old_attrs->values[i].data;
+			bool found = false;
+
+			for (j = 0; new_attrs != NULL &&
+				    j < new_attrs->num_values; j++) {
+				const char *attr2 =
+					(const char *)new_attrs->values[j].data;
+				if (ldb_attr_cmp(attr, attr2) == 0) {
+					found = true;
+					break;
+				}
+			}
+			if (!found) {
+				/* an index was removed */
+				return false;
+			}
+		}
+	}
+
+	for (i = 0; new_attrs != NULL && i < new_attrs->num_values; i++) {
+		const char *attr = (const char *)new_attrs->values[i].data;
+		bool found = false;
+
+		if (ldb_kv->cache->GUID_index_attribute != NULL &&
+		    ldb_attr_cmp(attr,
+				 ldb_kv->cache->GUID_index_attribute) == 0) {
+			/* Implicitly covered, this is the index key */
+			continue;
+		}
+
+		for (j = 0; old_attrs != NULL &&
+			    j < old_attrs->num_values; j++) {
+			const char *attr2 =
+				(const char *)old_attrs->values[j].data;
+			if (ldb_attr_cmp(attr, attr2) == 0) {
+				found = true;
+				break;
+			}
+		}
+		for (j = 0; !found && j < el->num_values; j++) {
+			const char *attr2 = (const char *)el->values[j].data;
+			if (ldb_attr_cmp(attr, attr2) == 0) {
+				found = true;
+			}
+		}
+		if (found) {
+			continue;
+		}
+
+		el->values = talloc_realloc(el, el->values, struct ldb_val,
+					    el->num_values + 1);
+		if (el->values == NULL) {
+			return false;
+		}
+		el->values[el->num_values] = new_attrs->values[i];
+		el->num_values++;
+	}
+
+	*added = el;
+	return true;
+}
+
+/*
+  re-index after a modification to @INDEXLIST
+
+  If the only change was to start indexing some more attributes, the
+  existing @INDEX records are all still correct, so rather than
+  rebuilding every index we only add the records for the new
+  attributes.  Otherwise fall back to a complete re-index.
+
+  This also holds with an index_handler_override (as in the AD DC),
+  where the handler decides which attributes are indexed: the
+  @INDEXLIST is written from the same schema, so the attributes new
+  in @IDXATTR are the ones the handler now indexes.  As the handler
+  may have indexed them already, any cached or stored records for
+  them are dropped first.
+
+  The new records are built in the index caches of the current
+  operation, so they are thrown away with it if it fails.
+*/
+int ldb_kv_reindex_indexlist(struct ldb_module *module)
+{
+	struct ldb_kv_private *ldb_kv = talloc_get_type(
+	    ldb_module_get_private(module), struct ldb_kv_private);
+	struct ldb_context *ldb = ldb_module_get_ctx(module);
+	struct ldb_kv_reindex_context ctx;
+	struct ldb_message *old_list = NULL;
+	size_t index_cache_size = 0;
+	TALLOC_CTX *tmp_ctx = NULL;
+	int ret;
+
+	if (ldb_kv->read_only) {
+		return LDB_ERR_UNWILLING_TO_PERFORM;
+	}
+
+	/*
+	 * Without the previous @INDEXLIST we can't tell what changed,
+	 * and without a transaction index cache we have nowhere to
+	 * build the new records.
+	 */
+	if (ldb_kv->cache->indexlist == NULL ||
+	    ldb_kv->idxptr == NULL) {
+		return ldb_kv_reindex(module);
+	}
+
+	tmp_ctx = talloc_new(ldb_kv);
+	if (tmp_ctx == NULL) {
+		return ldb_oom(ldb);
+	}
+
+	/* The cache still holds the @INDEXLIST from before the change */
+	old_list = ldb_msg_copy(tmp_ctx, ldb_kv->cache->indexlist);
+	if (old_list == NULL) {
+		TALLOC_FREE(tmp_ctx);
+		return ldb_oom(ldb);
+	}
+
+	if (ldb_kv_cache_reload(module) != 0) {
+		TALLOC_FREE(tmp_ctx);
+		return LDB_ERR_OPERATIONS_ERROR;
+	}
+
+	ctx.error = 0;
+	ctx.count = 0;
+	ctx.attrs = NULL;
+	ctx.module = module;
+
+	if (!ldb_kv_indexlist_only_added(tmp_ctx,
+					 ldb_kv,
+					 old_list,
+					 ldb_kv->cache->indexlist,
+					 &ctx.attrs)) {
+		TALLOC_FREE(tmp_ctx);
+		return ldb_kv_reindex(module);
+	}
+
+	if (ctx.attrs->num_values == 0) {
+		TALLOC_FREE(tmp_ctx);
+		return LDB_SUCCESS;
+	}
+
+	/*
+	 * Like a full re-index, this may write an index record for
+	 * every record in the database, so give the caches the same
+	 * size.  The records the transaction and the current
+	 * operation already changed are kept.
+	 */
+	index_cache_size = ldb_kv_reindex_cache_size(ldb_kv);
+	ret = ldb_kv_index_cache_resize(ldb_kv->idxptr, index_cache_size);
+	if (ret == LDB_SUCCESS) {
+		ret = ldb_kv_index_cache_resize(ldb_kv->nested_idx_ptr,
+						index_cache_size);
+	}
+	if (ret != LDB_SUCCESS) {
+		ldb_asprintf_errstring(ldb, "resizing the index cache failed");
+		TALLOC_FREE(tmp_ctx);
+		return ret;
+	}
+
+	/*
+	 * Remove any stale records for these attributes, such as
+	 * from a database written by an older version, or indexed
+	 * by an index_handler_override
+	 */
+	ret = tdb_traverse(ldb_kv->idxptr->itdb,
+			   delete_cached_index_attrs,
+			   &ctx);
+	if (ret >= 0 && ldb_kv->nested_idx_ptr != NULL) {
+		ret = tdb_traverse(ldb_kv->nested_idx_ptr->itdb,
+				   delete_cached_index_attrs,
+				   &ctx);
+	}
+	if (ret >= 0) {
+		ret = ldb_kv->kv_ops->iterate(ldb_kv, delete_index_attrs, &ctx);
+	}
+	if (ret < 0) {
+		ldb_asprintf_errstring(ldb, "index deletion traverse failed: %s",
+				       ldb_errstring(ldb));
+		TALLOC_FREE(tmp_ctx);
+		return ctx.error != LDB_SUCCESS ?
+			ctx.error : LDB_ERR_OPERATIONS_ERROR;
+	}
+
+	ret = ldb_kv->kv_ops->iterate(ldb_kv, re_index_attrs, &ctx);
+	if (ret < 0) {
+		ldb_asprintf_errstring(ldb, "reindexing traverse failed: %s",
+				       ldb_errstring(ldb));
+		TALLOC_FREE(tmp_ctx);
+		return LDB_ERR_OPERATIONS_ERROR;
+	}
+
+	if (ctx.error != LDB_SUCCESS) {
+		ldb_asprintf_errstring(ldb, "reindexing failed: %s", ldb_errstring(ldb));
+		TALLOC_FREE(tmp_ctx);
+		return ctx.error;
+	}
+
+	if (ctx.count > 10000) {
+		ldb_debug(ldb,
+			  LDB_DEBUG_WARNING,
+			  "Reindexing: incremental re_index successful on %s, "
+			  "final index write-out will be in transaction commit",
+			  ldb_kv->kv_ops->name(ldb_kv));
+	}
+
+	TALLOC_FREE(tmp_ctx);
+	return LDB_SUCCESS;
+}
+
 /*
  * Copy the contents of the nested transaction index cache record to the
  * transaction index cache.
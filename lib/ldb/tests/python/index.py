@@ -1416,6 +1416,137 @@ class OrderedIntegerRangeTestsLmdb(OrderedIntegerRangeTests):
         super(OrderedIntegerRangeTestsLmdb, self).tearDown()
 
 
+class IndexListChangeTests(LdbBaseTest):
+    """Changing @INDEXLIST only re-indexes the attributes that changed"""
+
+    def tearDown(self):
+        shutil.rmtree(self.testdir)
+        super(IndexListChangeTests, self).tearDown()
+
+        # Ensure the LDB is closed now, so we close the FD
+        del(self.l)
+
+    def setUp(self):
+        super(IndexListChangeTests, self).setUp()
+        self.testdir = tempdir()
+        self.filename = os.path.join(self.testdir, "indexlist_test.ldb")
+        self.l = ldb.Ldb(self.url(), flags=self.flags())
+        self.l.add({"dn": "@INDEXLIST",
+                    "@IDXATTR": [b"x"],
+                    "@IDXONE": [b"1"],
+                    "@IDXGUID": [b"objectUUID"],
+                    "@IDX_DN_GUID": [b"GUID"]})
+        self.l.add({"dn": "OU=A,DC=SAMBA,DC=ORG",
+                    "objectUUID": b"0123456789abcde0",
+                    "x": "a",
+                    "y": "b"})
+        self.l.add({"dn": "OU=B,DC=SAMBA,DC=ORG",
+                    "objectUUID": b"0123456789abcde1",
+                    "x": "a",
+                    "y": "c"})
+
+    def checkGuids(self, key, guids):
+        res = self.l.search(base=key, scope=ldb.SCOPE_BASE)
+        if guids is None:
+            self.assertEqual(len(res), 0)
+            return
+        self.assertEqual(len(res), 1)
+        self.assertEqual(guids, res[0]["@IDX"][0])
+
+    def set_idxattr(self, attrs):
+        m = ldb.Message()
+        m.dn = ldb.Dn(self.l, "@INDEXLIST")
+        m["@IDXATTR"] = ldb.MessageElement(attrs,
+                                           ldb.FLAG_MOD_REPLACE,
+                                           "@IDXATTR")
+        self.l.modify(m)
+
+    def test_add_index(self):
+        self.checkGuids("@INDEX:Y:b", None)
+        self.set_idxattr([b"x", b"y"])
+        self.checkGuids("@INDEX:Y:b", b"0123456789abcde0")
+        self.checkGuids("@INDEX:Y:c", b"0123456789abcde1")
+        self.checkGuids("@INDEX:X:a",
+                        b"0123456789abcde0" + b"0123456789abcde1")
+
+        res = self.l.search(base="DC=SAMBA,DC=ORG",
+                            expression="(y=c)")
+        self.assertEqual(len(res), 1)
+        self.assertEqual(str(res[0].dn), "OU=B,DC=SAMBA,DC=ORG")
+
+    def test_add_index_in_transaction(self):
+        self.l.transaction_start()
+        self.l.add({"dn": "OU=C,DC=SAMBA,DC=ORG",
+                    "objectUUID": b"0123456789abcde2",
+                    "x": "a",
+                    "y": "c"})
+        self.set_idxattr([b"y", b"x"])
+        self.l.transaction_commit()
+
+        self.checkGuids("@INDEX:Y:c",
+                        b"0123456789abcde1" + b"0123456789abcde2")
+        self.checkGuids("@INDEX:X:a",
+                        b"0123456789abcde0" + b"0123456789abcde1" +
+                        b"0123456789abcde2")
+
+    def add_marker(self, key):
+        # An index record no object has, only a full re-index
+        # throws it away
+        self.l.add({"dn": key,
+                    "@IDXVERSION": [b"3"],
+                    "@IDX": [b"0123456789abcdef"]})
+
+    def test_add_index_keeps_old_records(self):
+        self.add_marker("@INDEX:X:zzz")
+        self.add_marker("@INDEX:Y:zzz")
+        self.set_idxattr([b"x", b"y"])
+
+        # the existing index was not walked
+        self.checkGuids("@INDEX:X:zzz", b"0123456789abcdef")
+        # but stale records for the new attribute are gone
+        self.checkGuids("@INDEX:Y:zzz", None)
+        self.checkGuids("@INDEX:Y:b", b"0123456789abcde0")
+
+    def test_remove_index(self):
+        self.add_marker("@INDEX:Y:zzz")
+        self.set_idxattr([b"y"])
+        self.checkGuids("@INDEX:X:a", None)
+        self.checkGuids("@INDEX:Y:b", b"0123456789abcde0")
+        # a full re-index
+        self.checkGuids("@INDEX:Y:zzz", None)
+
+        res = self.l.search(base="DC=SAMBA,DC=ORG",
+                            expression="(x=a)")
+        self.assertEqual(len(res), 2)
+
+    def test_add_index_cancelled(self):
+        self.add_marker("@INDEX:X:zzz")
+        self.l.transaction_start()
+        self.set_idxattr([b"x", b"y"])
+        res = self.l.search(base="DC=SAMBA,DC=ORG",
+                            expression="(y=b)")
+        self.assertEqual(len(res), 1)
+        self.l.transaction_cancel()
+
+        self.checkGuids("@INDEX:Y:b", None)
+        self.checkGuids("@INDEX:X:zzz", b"0123456789abcdef")
+        res = self.l.search(base="DC=SAMBA,DC=ORG",
+                            expression="(y=c)")
+        self.assertEqual(len(res), 1)
+
+
+class IndexListChangeTestsLmdb(IndexListChangeTests):
+
+    def setUp(self):
+        if os.environ.get('HAVE_LMDB', '1') == '0':
+            self.skipTest("No lmdb backend")
+        self.prefix = MDB_PREFIX
+        super(IndexListChangeTestsLmdb, self).setUp()
+
+    def tearDown(self):
+        super(IndexListChangeTestsLmdb, self).tearDown()
+
+
 # Run the index truncation tests against an lmdb backend
 class RejectSubDBIndex(LdbBaseTest):
 
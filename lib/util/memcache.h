@@ -47,6 +47,12 @@ enum memcache_number {
 	SHARE_MODE_LOCK_CACHE,	/* talloc */
 	VIRUSFILTER_SCAN_RESULTS_CACHE_TALLOC, /* talloc */
 	DFREE_CACHE,
+	WINBIND_GETPWSID_CACHE,
+	WINBIND_GETTOKEN_CACHE,
+	DNS_ZONE_CACHE_TALLOC,	/* talloc */
+	DNS_FORWARDER_CACHE,
+	KDC_ENTRY_CACHE_TALLOC,	/* talloc */
+	AUTHSAM_ACCOUNT_CACHE_TALLOC,	/* talloc */
 };
 
 /*
@@ -402,6 +402,100 @@ enum ndr_compression_alg {
 	} \
 } while(0)
 
+/*
+ * pidl pulls and pushes structures that only consist of integers and
+ * fixed size byte arrays without any padding between them with a
+ * single bounds check. NDR_PULL_FIXED_LAYOUT() and
+ * NDR_PUSH_FIXED_LAYOUT() reserve the whole structure, the
+ * NDR_FIXED_* macros access the members at their offset within it.
+ */
+#define NDR_PULL_FIXED_LAYOUT(ndr, n, p) do { \
+	NDR_PULL_NEED_BYTES(ndr, n); \
+	(p) = (ndr)->data + (ndr)->offset; \
+	(ndr)->offset += (n); \
+} while(0)
+
+#define NDR_PUSH_FIXED_LAYOUT(ndr, n, p) do { \
+	NDR_PUSH_NEED_BYTES(ndr, n); \
+	(p) = (ndr)->data + (ndr)->offset; \
+	(ndr)->offset += (n); \
+} while(0)
+
+#define _NDR_FIXED_LE_U16(p, ofs) \
+	((uint16_t)((uint16_t)(p)[(ofs)] | ((uint16_t)(p)[(ofs)+1] << 8)))
+#define _NDR_FIXED_BE_U16(p, ofs) \
+	((uint16_t)(((uint16_t)(p)[(ofs)] << 8) | (uint16_t)(p)[(ofs)+1]))
+#define _NDR_FIXED_LE_U32(p, ofs) \
+	((uint32_t)_NDR_FIXED_LE_U16(p, ofs) | \
+	 ((uint32_t)_NDR_FIXED_LE_U16(p, (ofs)+2) << 16))
+#define _NDR_FIXED_BE_U32(p, ofs) \
+	(((uint32_t)_NDR_FIXED_BE_U16(p, ofs) << 16) | \
+	 (uint32_t)_NDR_FIXED_BE_U16(p, (ofs)+2))
+
+#define NDR_FIXED_PULL_U8(ndr, p, ofs) ((uint8_t)(p)[(ofs)])
+#define NDR_FIXED_PULL_U16(ndr, p, ofs) \
+	(NDR_BE(ndr) ? _NDR_FIXED_BE_U16(p, ofs) : _NDR_FIXED_LE_U16(p, ofs))
+#define NDR_FIXED_PULL_U32(ndr, p, ofs) \
+	(NDR_BE(ndr) ? _NDR_FIXED_BE_U32(p, ofs) : _NDR_FIXED_LE_U32(p, ofs))
+/* like ndr_pull_udlong(): the low word comes first */
+#define NDR_FIXED_PULL_UDLONG(ndr, p, ofs) \
+	((uint64_t)NDR_FIXED_PULL_U32(ndr, p, ofs) | \
+	 ((uint64_t)NDR_FIXED_PULL_U32(ndr, p, (ofs)+4) << 32))
+/* like ndr_pull_hyper(): a 64 bit value in the byte order of ndr */
+#define NDR_FIXED_PULL_HYPER(ndr, p, ofs) \
+	(NDR_BE(ndr) ? \
+	 (((uint64_t)_NDR_FIXED_BE_U32(p, ofs) << 32) | \
+	  (uint64_t)_NDR_FIXED_BE_U32(p, (ofs)+4)) : \
+	 ((uint64_t)_NDR_FIXED_LE_U32(p, ofs) | \
+	  ((uint64_t)_NDR_FIXED_LE_U32(p, (ofs)+4) << 32)))
+
+#define NDR_FIXED_PUSH_U8(ndr, p, ofs, v) do { \
+	(p)[(ofs)] = (uint8_t)(v); \
+} while(0)
+
+#define NDR_FIXED_PUSH_U16(ndr, p, ofs, v) do { \
+	uint16_t _v16 = (uint16_t)(v); \
+	if (NDR_BE(ndr)) { \
+		(p)[(ofs)] = (uint8_t)(_v16 >> 8); \
+		(p)[(ofs)+1] = (uint8_t)_v16; \
+	} else { \
+		(p)[(ofs)] = (uint8_t)_v16; \
+		(p)[(ofs)+1] = (uint8_t)(_v16 >> 8); \
+	} \
+} while(0)
+
+#define NDR_FIXED_PUSH_U32(ndr, p, ofs, v) do { \
+	uint32_t _v32 = (uint32_t)(v); \
+	if (NDR_BE(ndr)) { \
+		(p)[(ofs)] = (uint8_t)(_v32 >> 24); \
+		(p)[(ofs)+1] = (uint8_t)(_v32 >> 16); \
+		(p)[(ofs)+2] = (uint8_t)(_v32 >> 8); \
+		(p)[(ofs)+3] = (uint8_t)_v32; \
+	} else { \
+		(p)[(ofs)] = (uint8_t)_v32; \
+		(p)[(ofs)+1] = (uint8_t)(_v32 >> 8); \
+		(p)[(ofs)+2] = (uint8_t)(_v32 >> 16); \
+		(p)[(ofs)+3] = (uint8_t)(_v32 >> 24); \
+	} \
+} while(0)
+
+#define NDR_FIXED_PUSH_UDLONG(ndr, p, ofs, v) do { \
+	uint64_t _v64 = (uint64_t)(v); \
+	NDR_FIXED_PUSH_U32(ndr, p, ofs, _v64 & 0xFFFFFFFF); \
+	NDR_FIXED_PUSH_U32(ndr, p, (ofs)+4, _v64 >> 32); \
+} while(0)
+
+#define NDR_FIXED_PUSH_HYPER(ndr, p, ofs, v) do { \
+	uint64_t _v64 = (uint64_t)(v); \
+	if (NDR_BE(ndr)) { \
+		NDR_FIXED_PUSH_U32(ndr, p, ofs, _v64 >> 32); \
+		NDR_FIXED_PUSH_U32(ndr, p, (ofs)+4, _v64 & 0xFFFFFFFF); \
+	} else { \
+		NDR_FIXED_PUSH_U32(ndr, p, ofs, _v64 & 0xFFFFFFFF); \
+		NDR_FIXED_PUSH_U32(ndr, p, (ofs)+4, _v64 >> 32); \
+	} \
+} while(0)
+
 #define NDR_RECURSION_CHECK(ndr, d) do { \
 	uint32_t _ndr_min_ = (d); \
 	if (ndr->global_max_recursion &&  ndr->global_max_recursion < (d)) { \
@@ -623,6 +717,7 @@ enum ndr_err_code ndr_pull_relative_ptr2(struct ndr_pull *ndr, const void *p);
 enum ndr_err_code ndr_pull_relative_ptr_short(struct ndr_pull *ndr, uint16_t *v);
 size_t ndr_align_size(uint32_t offset, size_t n);
 struct ndr_pull *ndr_pull_init_blob(const DATA_BLOB *blob, TALLOC_CTX *mem_ctx);
+enum ndr_err_code ndr_pull_set_mem_pool(struct ndr_pull *ndr, TALLOC_CTX *mem_ctx);
 enum ndr_err_code ndr_pull_append(struct ndr_pull *ndr, DATA_BLOB *blob);
 enum ndr_err_code ndr_pull_pop(struct ndr_pull *ndr);
 enum ndr_err_code ndr_pull_advance(struct ndr_pull *ndr, uint32_t size);
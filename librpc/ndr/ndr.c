@@ -37,6 +37,14 @@
 
 #define NDR_BASE_MARSHALL_SIZE 1024
 
+/*
+ * Bounds for the talloc pool used by ndr_pull_set_mem_pool(). Small
+ * blobs don't pay for the pool and the upper limit keeps a peer from
+ * making us reserve more than that in advance.
+ */
+#define NDR_PULL_POOL_MIN_SIZE 1024
+#define NDR_PULL_POOL_MAX_SIZE (4 * 1024 * 1024)
+
 /*
  * This value is arbitrary, but designed to reduce the memory a client
  * can allocate and the work the client can force in processing a
@@ -94,6 +102,56 @@ _PUBLIC_ struct ndr_pull *ndr_pull_init_blob(const DATA_BLOB *blob, TALLOC_CTX *
 	return ndr;
 }
 
+/*
+  let everything that is pulled from ndr from now on be allocated
+  from a single talloc pool below mem_ctx, sized from the remaining
+  input. A large drsuapi or lsa reply otherwise means thousands of
+  small malloc() calls.
+
+  The pulled objects are still normal talloc chunks, they can be
+  stolen and freed as usual. But the pool memory is only returned
+  once all objects allocated from it are gone: a small piece stolen
+  into longer lived state keeps the whole pool (up to
+  NDR_PULL_POOL_MAX_SIZE) allocated. So only use this where the
+  whole result is freed together, like the request of a
+  dcesrv_call_state, and not for results handed to arbitrary
+  callers.
+*/
+_PUBLIC_ enum ndr_err_code ndr_pull_set_mem_pool(struct ndr_pull *ndr,
+						 TALLOC_CTX *mem_ctx)
+{
+	uint32_t remaining = ndr->data_size - ndr->offset;
+	size_t pool_size;
+	TALLOC_CTX *pool = NULL;
+
+	if (remaining < NDR_PULL_POOL_MIN_SIZE) {
+		/*
+		 * Not worth it, just allocate from mem_ctx
+		 */
+		ndr->current_mem_ctx = mem_ctx;
+		return NDR_ERR_SUCCESS;
+	}
+
+	/*
+	 * The unmarshalled structures are usually larger than the
+	 * wire format: pointers get wider and every allocation comes
+	 * with a talloc header. Anything that does not fit into the
+	 * pool is allocated as usual.
+	 */
+	pool_size = MIN((size_t)remaining * 2, NDR_PULL_POOL_MAX_SIZE);
+
+	pool = talloc_pool(mem_ctx, pool_size);
+	if (pool == NULL) {
+		return ndr_pull_error(ndr, NDR_ERR_ALLOC,
+				      "Failed to allocate a %zu byte pool",
+				      pool_size);
+	}
+	talloc_set_name_const(pool, "ndr_pull_pool");
+
+	ndr->current_mem_ctx = pool;
+	return NDR_ERR_SUCCESS;
+}
+
 _PUBLIC_ enum ndr_err_code ndr_pull_append(struct ndr_pull *ndr, DATA_BLOB *blob)
 {
 	enum ndr_err_code ndr_err;
@@ -22,6 +22,57 @@
 #include "includes.h"
 #include "librpc/ndr/libndr.h"
 
+/*
+  convert a string from the wire into CH_UNIX, allocated on the
+  current memory context of ndr.
+
+  Almost all UTF-16 strings in drsuapi, lsa and samr traffic are
+  plain ASCII. Like the fast path in convert_string_handle() we copy
+  those directly, which avoids the iconv call and the three times
+  over-allocation of convert_string_talloc(). The latter matters when
+  pulling into a pool, see ndr_pull_set_mem_pool().
+*/
+static bool ndr_pull_convert_string(struct ndr_pull *ndr,
+				    charset_t chset,
+				    const uint8_t *src,
+				    size_t srclen,
+				    char **dest,
+				    size_t *converted_size)
+{
+	size_t lo = (chset == CH_UTF16BE) ? 1 : 0;
+	size_t i, n;
+	char *as = NULL;
+
+	if ((chset != CH_UTF16LE && chset != CH_UTF16BE) ||
+	    srclen == 0 || srclen % 2 != 0) {
+		goto slow_path;
+	}
+
+	n = srclen / 2;
+	for (i = 0; i < n; i++) {
+		if (src[2*i + lo] > 0x7f || src[2*i + (1 - lo)] != 0) {
+			goto slow_path;
+		}
+	}
+
+	as = talloc_array(ndr->current_mem_ctx, char, n + 1);
+	if (as == NULL) {
+		return false;
+	}
+	for (i = 0; i < n; i++) {
+		as[i] = (char)src[2*i + lo];
+	}
+	as[n] = '\0';
+
+	*dest = as;
+	*converted_size = n;
+	return true;
+
+slow_path:
+	return convert_string_talloc(ndr->current_mem_ctx, chset, CH_UNIX,
+				     src, srclen, dest, converted_size);
+}
+
 /**
   pull a general string from the wire
 */
@@ -167,8 +218,8 @@ _PUBLIC_ enum ndr_err_code ndr_pull_string(struct ndr_pull *ndr, int ndr_flags,
 						      "Failed to talloc_strndup() in RAW8 ndr_string_pull()");
 			}
 			converted_size = MIN(strlen(as)+1, conv_src_len);
-		} else if (!convert_string_talloc(ndr->current_mem_ctx, chset,
-					   CH_UNIX, ndr->data + ndr->offset,
+		} else if (!ndr_pull_convert_string(ndr, chset,
+					   ndr->data + ndr->offset,
 					   conv_src_len * byte_mul,
 					   &as,
 					   &converted_size)) {
@@ -709,10 +760,10 @@ _PUBLIC_ enum ndr_err_code ndr_pull_charset(struct ndr_pull *ndr, int ndr_flags,
 	}
 	NDR_PULL_NEED_BYTES(ndr, length*byte_mul);
 
-	if (!convert_string_talloc(ndr->current_mem_ctx, chset, CH_UNIX,
-				   ndr->data+ndr->offset, length*byte_mul,
-				   var,
-				   &converted_size))
+	if (!ndr_pull_convert_string(ndr, chset,
+				     ndr->data+ndr->offset, length*byte_mul,
+				     discard_const_p(char *, var),
+				     &converted_size))
 	{
 		return ndr_pull_error(ndr, NDR_ERR_CHARCNV,
 				      "Bad character conversion");
@@ -747,10 +798,10 @@ _PUBLIC_ enum ndr_err_code ndr_pull_charset_to_null(struct ndr_pull *ndr, int nd
 				      "Invalid length");
 	}
 
-	if (!convert_string_talloc(ndr->current_mem_ctx, chset, CH_UNIX,
-				   ndr->data+ndr->offset, str_len*byte_mul,
-				   var,
-				   &converted_size))
+	if (!ndr_pull_convert_string(ndr, chset,
+				     ndr->data+ndr->offset, str_len*byte_mul,
+				     discard_const_p(char *, var),
+				     &converted_size))
 	{
 		return ndr_pull_error(ndr, NDR_ERR_CHARCNV,
 				      "Bad character conversion");
@@ -47,6 +47,9 @@
 
 #undef strcasecmp
 
+/* Calls per connection the backends may work on at the same time */
+#define DCESRV_MAX_PENDING_CALLS 64
+
 static NTSTATUS dcesrv_negotiate_contexts(struct dcesrv_call_state *call,
 				const struct dcerpc_bind *b,
 				struct dcerpc_ack_ctx *ack_ctx_list);
@@ -585,6 +588,21 @@ _PUBLIC_ NTSTATUS dcesrv_endpoint_connect(struct dcesrv_context *dce_ctx,
 					      "dcesrv",
 					      "max auth states",
 					      2049);
+	p->max_pending_calls = lpcfg_parm_ulong(dce_ctx->lp_ctx,
+						NULL,
+						"dcesrv",
+						"max pending calls",
+						DCESRV_MAX_PENDING_CALLS);
+
+	/*
+	 * Allocated before any call, so it is still there when
+	 * the destructors of the calls run as the connection is
+	 * freed.
+	 */
+	p->resume_read_im = tevent_create_immediate(p);
+	if (p->resume_read_im == NULL) {
+		goto nomem;
+	}
 
 	auth = dcesrv_auth_create(p);
 	if (auth == NULL) {
@@ -610,14 +628,220 @@ nomem:
 	return NT_STATUS_NO_MEMORY;
 }
 
+static struct dcesrv_opnum_stats *dcesrv_call_stats_find(
+	struct dcesrv_context *dce_ctx,
+	const struct dcesrv_interface *iface,
+	uint16_t opnum)
+{
+	struct dcesrv_iface_stats *s = NULL;
+
+	for (s = dce_ctx->call_stats.ifaces; s != NULL; s = s->next) {
+		if (ndr_syntax_id_equal(&s->syntax_id, &iface->syntax_id)) {
+			break;
+		}
+	}
+
+	if (s == NULL) {
+		s = talloc_zero(dce_ctx, struct dcesrv_iface_stats);
+		if (s == NULL) {
+			return NULL;
+		}
+		s->name = iface->name;
+		s->syntax_id = iface->syntax_id;
+		DLIST_ADD(dce_ctx->call_stats.ifaces, s);
+	} else if (s != dce_ctx->call_stats.ifaces) {
+		DLIST_PROMOTE(dce_ctx->call_stats.ifaces, s);
+	}
+
+	if (opnum >= s->num_opnums) {
+		struct dcesrv_opnum_stats *opnums = NULL;
+
+		opnums = talloc_realloc(s,
+					s->opnums,
+					struct dcesrv_opnum_stats,
+					opnum + 1);
+		if (opnums == NULL) {
+			return NULL;
+		}
+		memset(&opnums[s->num_opnums],
+		       0,
+		       sizeof(opnums[0]) * (opnum + 1 - s->num_opnums));
+		s->opnums = opnums;
+		s->num_opnums = opnum + 1;
+	}
+
+	return &s->opnums[opnum];
+}
+
+/*
+  account for the time between the arrival of a request and its reply
+ */
+static void dcesrv_call_stats_record(struct dcesrv_call_state *call)
+{
+	struct dcesrv_context *dce_ctx = call->conn->dce_ctx;
+	struct dcesrv_opnum_stats *o = NULL;
+	struct timeval now;
+	int64_t diff;
+	uint64_t usec;
+	size_t i;
+
+	if (!dce_ctx->call_stats.enabled) {
+		return;
+	}
+	if (call->pkt.ptype != DCERPC_PKT_REQUEST || call->context == NULL) {
+		return;
+	}
+
+	o = dcesrv_call_stats_find(dce_ctx,
+				   call->context->iface,
+				   call->pkt.u.request.opnum);
+	if (o == NULL) {
+		return;
+	}
+
+	now = timeval_current();
+	diff = usec_time_diff(&now, &call->time);
+	usec = MAX(diff, 0);
+
+	for (i = 0; i < DCESRV_CALL_STATS_BUCKETS - 1; i++) {
+		if (usec < (UINT64_C(2) << i)) {
+			break;
+		}
+	}
+
+	o->calls += 1;
+	if (call->fault_code != 0) {
+		o->faults += 1;
+	}
+	o->total_usec += usec;
+	o->max_usec = MAX(o->max_usec, usec);
+	o->buckets[i] += 1;
+}
+
+/*
+  log the latency histograms collected so far
+ */
+_PUBLIC_ void dcesrv_call_stats_log(struct dcesrv_context *dce_ctx)
+{
+	struct dcesrv_iface_stats *s = NULL;
+
+	for (s = dce_ctx->call_stats.ifaces; s != NULL; s = s->next) {
+		uint32_t opnum;
+
+		for (opnum = 0; opnum < s->num_opnums; opnum++) {
+			struct dcesrv_opnum_stats *o = &s->opnums[opnum];
+			char *histogram = NULL;
+			size_t i;
+
+			if (o->calls == 0) {
+				continue;
+			}
+
+			histogram = talloc_strdup(dce_ctx, "");
+
+			for (i = 0; i < DCESRV_CALL_STATS_BUCKETS; i++) {
+				if (o->buckets[i] == 0) {
+					continue;
+				}
+				if (i == DCESRV_CALL_STATS_BUCKETS - 1) {
+					talloc_asprintf_addbuf(
+						&histogram,
+						" >=%"PRIu64"us:%"PRIu64,
+						UINT64_C(1) << i,
+						o->buckets[i]);
+					continue;
+				}
+				talloc_asprintf_addbuf(&histogram,
+						       " <%"PRIu64"us:%"PRIu64,
+						       UINT64_C(2) << i,
+						       o->buckets[i]);
+			}
+
+			DBG_NOTICE("%s opnum %"PRIu32": %"PRIu64" calls, "
+				   "%"PRIu64" faults, %"PRIu64"us average, "
+				   "%"PRIu64"us max,%s\n",
+				   s->name,
+				   opnum,
+				   o->calls,
+				   o->faults,
+				   o->total_usec / o->calls,
+				   o->max_usec,
+				   histogram != NULL ? histogram : "");
+			TALLOC_FREE(histogram);
+
+			/* The maximum is per interval */
+			o->max_usec = 0;
+		}
+	}
+}
+
+/*
+  stop reading from the client while it has too many calls pending,
+  returns true if reading is paused
+ */
+static bool dcesrv_connection_pause_read(struct dcesrv_connection *conn)
+{
+	struct dcesrv_call_state *call = NULL;
+	size_t num_pending = 0;
+
+	if (conn->max_pending_calls == 0) {
+		return false;
+	}
+
+	for (call = conn->pending_call_list; call != NULL; call = call->next) {
+		num_pending += 1;
+	}
+
+	if (num_pending < conn->max_pending_calls) {
+		return false;
+	}
+
+	/*
+	 * Don't read more requests before one of the pending
+	 * calls is done, dcesrv_call_set_list() starts reading
+	 * again.
+	 */
+	DBG_DEBUG("%zu pending calls, pausing the connection\n",
+		  num_pending);
+	conn->read_paused = true;
+	return true;
+}
+
+static void dcesrv_connection_resume_read(struct tevent_context *ev,
+					  struct tevent_immediate *im,
+					  void *private_data)
+{
+	struct dcesrv_connection *conn = talloc_get_type_abort(
+		private_data, struct dcesrv_connection);
+	NTSTATUS status;
+
+	if (!conn->read_paused || conn->terminate != NULL) {
+		return;
+	}
+
+	conn->read_paused = false;
+
+	if (dcesrv_connection_pause_read(conn)) {
+		return;
+	}
+
+	status = dcesrv_connection_loop_start(conn);
+	if (!NT_STATUS_IS_OK(status)) {
+		dcesrv_terminate_connection(conn, nt_errstr(status));
+	}
+}
+
 /*
   move a call from an existing linked list to the specified list. This
   prevents bugs where we forget to remove the call from a previous
   list when moving it.
  */
-static void dcesrv_call_set_list(struct dcesrv_call_state *call,
-				 enum dcesrv_call_list list)
+void dcesrv_call_set_list(struct dcesrv_call_state *call,
+			  enum dcesrv_call_list list)
 {
+	struct dcesrv_connection *conn = call->conn;
+	bool was_pending = (call->list == DCESRV_LIST_PENDING_CALL_LIST);
+
 	switch (call->list) {
 	case DCESRV_LIST_NONE:
 		break;
@@ -645,6 +869,27 @@ static void dcesrv_call_set_list(struct dcesrv_call_state *call,
 		DLIST_ADD_END(call->conn->pending_call_list, call);
 		break;
 	}
+
+	if (list == DCESRV_LIST_CALL_LIST) {
+		dcesrv_call_stats_record(call);
+	}
+
+	if (was_pending &&
+	    list != DCESRV_LIST_PENDING_CALL_LIST &&
+	    conn->read_paused)
+	{
+		/*
+		 * dcesrv_loop_next_packet() stopped reading because
+		 * of too many pending calls. This call is answered,
+		 * orphaned or freed, so there may be room again.
+		 * We may be called from the destructor of the call,
+		 * so check it from an immediate event.
+		 */
+		tevent_schedule_immediate(conn->resume_read_im,
+					  conn->event_ctx,
+					  dcesrv_connection_resume_read,
+					  conn);
+	}
 }
 
 static void dcesrv_call_disconnect_after(struct dcesrv_call_state *call,
@@ -1841,6 +2086,7 @@ static NTSTATUS dcesrv_request(struct dcesrv_call_state *call)
 		dcerpc_binding_get_transport(endpoint->ep_description);
 	struct ndr_pull *pull;
 	bool turn_winbind_on = false;
+	enum ndr_err_code ndr_err;
 	NTSTATUS status;
 
 	if (auth->auth_invalid) {
@@ -1911,6 +2157,16 @@ static NTSTATUS dcesrv_request(struct dcesrv_call_state *call)
 
 	pull->flags |= LIBNDR_FLAG_REF_ALLOC;
 
+	/*
+	 * The unmarshalled request lives as long as the call,
+	 * so allocate it from a single pool. Backends must copy
+	 * what they keep beyond the call rather than steal it.
+	 */
+	ndr_err = ndr_pull_set_mem_pool(pull, call);
+	if (!NDR_ERR_CODE_IS_SUCCESS(ndr_err)) {
+		return ndr_map_error2ntstatus(ndr_err);
+	}
+
 	call->ndr_pull	= pull;
 
 	if (!(call->pkt.drep[0] & DCERPC_DREP_LE)) {
@@ -1965,7 +2221,15 @@ static NTSTATUS dcesrv_request(struct dcesrv_call_state *call)
 		}
 	}
 
-	/* call the dispatch function */
+	/*
+	 * call the dispatch function
+	 *
+	 * This runs in the event loop, there is no thread pool
+	 * dispatch of read-only calls: the backends share ldb
+	 * handles and their association state without locking.
+	 * Only calls marked DCESRV_CALL_STATE_FLAG_ASYNC overlap,
+	 * up to max_pending_calls per connection.
+	 */
 	status = call->context->iface->dispatch(call, call, call->r);
 
 	if (turn_winbind_on) {
@@ -2961,6 +3225,10 @@ void dcesrv_loop_next_packet(
 		return;
 	}
 
+	if (dcesrv_connection_pause_read(dce_conn)) {
+		return;
+	}
+
 	subreq = dcerpc_read_ncacn_packet_send(dce_conn,
 					       dce_conn->event_ctx,
 					       dce_conn->stream);
@@ -324,6 +324,15 @@ struct dcesrv_connection {
 					void *private_data);
 	NTSTATUS (*wait_recv)(struct tevent_req *req);
 	void *wait_private;
+
+	/*
+	 * The number of calls we let the backends work on at the
+	 * same time. Once reached we stop reading from the client
+	 * until one of them is answered, orphaned or freed.
+	 */
+	size_t max_pending_calls;
+	bool read_paused;
+	struct tevent_immediate *resume_read_im;
 };
 
 
@@ -380,6 +389,28 @@ struct dcesrv_assoc_group {
 	uint16_t bind_time_features;
 };
 
+/*
+ * Bucket i of the latency histogram counts the calls that took less
+ * than 2^(i+1) microseconds, the last one everything slower.
+ */
+#define DCESRV_CALL_STATS_BUCKETS 24
+
+struct dcesrv_opnum_stats {
+	uint64_t calls;
+	uint64_t faults;
+	uint64_t total_usec;
+	uint64_t max_usec;
+	uint64_t buckets[DCESRV_CALL_STATS_BUCKETS];
+};
+
+struct dcesrv_iface_stats {
+	struct dcesrv_iface_stats *prev, *next;
+	const char *name;
+	struct ndr_syntax_id syntax_id;
+	uint32_t num_opnums;
+	struct dcesrv_opnum_stats *opnums;
+};
+
 struct dcesrv_context_callbacks {
 	struct {
 		void (*successful_authz)(
@@ -444,6 +475,15 @@ struct dcesrv_context {
 	struct dcesrv_connection *broken_connections;
 
 	struct dcesrv_context_callbacks *callbacks;
+
+	/*
+	 * Time between the arrival of a request and its reply,
+	 * per interface and opnum. Only collected when enabled.
+	 */
+	struct {
+		bool enabled;
+		struct dcesrv_iface_stats *ifaces;
+	} call_stats;
 };
 
 /* this structure is used by modules to determine the size of some critical types */
@@ -649,6 +689,8 @@ _PUBLIC_ void dcesrv_loop_next_packet(
 
 _PUBLIC_ NTSTATUS dcesrv_call_dispatch_local(struct dcesrv_call_state *call);
 
+_PUBLIC_ void dcesrv_call_stats_log(struct dcesrv_context *dce_ctx);
+
 _PUBLIC_ const struct dcesrv_interface *find_interface_by_syntax_id(
 	const struct dcesrv_endpoint *endpoint,
 	const struct ndr_syntax_id *interface);
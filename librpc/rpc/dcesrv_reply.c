@@ -28,44 +28,6 @@
 #include "lib/util/dlinklist.h"
 #include "param/param.h"
 
-/*
-  move a call from an existing linked list to the specified list. This
-  prevents bugs where we forget to remove the call from a previous
-  list when moving it.
- */
-static void dcesrv_call_set_list(struct dcesrv_call_state *call,
-				 enum dcesrv_call_list list)
-{
-	switch (call->list) {
-	case DCESRV_LIST_NONE:
-		break;
-	case DCESRV_LIST_CALL_LIST:
-		DLIST_REMOVE(call->conn->call_list, call);
-		break;
-	case DCESRV_LIST_FRAGMENTED_CALL_LIST:
-		DLIST_REMOVE(call->conn->incoming_fragmented_call_list, call);
-		break;
-	case DCESRV_LIST_PENDING_CALL_LIST:
-		DLIST_REMOVE(call->conn->pending_call_list, call);
-		break;
-	}
-	call->list = list;
-	switch (list) {
-	case DCESRV_LIST_NONE:
-		break;
-	case DCESRV_LIST_CALL_LIST:
-		DLIST_ADD_END(call->conn->call_list, call);
-		break;
-	case DCESRV_LIST_FRAGMENTED_CALL_LIST:
-		DLIST_ADD_END(call->conn->incoming_fragmented_call_list, call);
-		break;
-	case DCESRV_LIST_PENDING_CALL_LIST:
-		DLIST_ADD_END(call->conn->pending_call_list, call);
-		break;
-	}
-}
-
-
 void dcesrv_init_hdr(struct ncacn_packet *pkt, bool bigendian)
 {
 	pkt->rpc_vers = 5;
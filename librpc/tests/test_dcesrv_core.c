@@ -0,0 +1,267 @@
+/*
+ * Unit tests for the pending call limit of the DCE/RPC server
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * from cmocka.c:
+ * These headers or their equivalents should be included prior to
+ * including
+ * this header file.
+ *
+ * #include <stdarg.h>
+ * #include <stddef.h>
+ * #include <setjmp.h>
+ *
+ * This allows test applications to use custom definitions of C standard
+ * library functions and types.
+ *
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "librpc/rpc/dcesrv_core.c"
+
+#define TEST_MAX_PENDING_CALLS 2
+
+struct test_ctx {
+	struct tevent_context *ev;
+	struct dcesrv_context *dce_ctx;
+	struct dcesrv_connection *conn;
+	int peer_fd;
+};
+
+static void test_terminate_connection(struct dcesrv_connection *conn,
+				      const char *reason)
+{
+	fail_msg("connection terminated: %s", reason);
+}
+
+static int setup(void **state)
+{
+	struct test_ctx *ctx = NULL;
+	struct dcesrv_connection *conn = NULL;
+	int fds[2];
+	int ret;
+
+	ctx = talloc_zero(NULL, struct test_ctx);
+	assert_non_null(ctx);
+
+	ctx->ev = tevent_context_init(ctx);
+	assert_non_null(ctx->ev);
+
+	ctx->dce_ctx = talloc_zero(ctx, struct dcesrv_context);
+	assert_non_null(ctx->dce_ctx);
+
+	/*
+	 * Only what dcesrv_endpoint_connect() sets up for the
+	 * pending call limit and reading from the client.
+	 */
+	conn = talloc_zero(ctx, struct dcesrv_connection);
+	assert_non_null(conn);
+	conn->dce_ctx = ctx->dce_ctx;
+	conn->event_ctx = ctx->ev;
+	conn->max_pending_calls = TEST_MAX_PENDING_CALLS;
+	conn->resume_read_im = tevent_create_immediate(conn);
+	assert_non_null(conn->resume_read_im);
+	conn->default_auth_state = talloc_zero(conn, struct dcesrv_auth);
+	assert_non_null(conn->default_auth_state);
+	conn->transport.terminate_connection = test_terminate_connection;
+
+	ret = socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+	assert_int_equal(ret, 0);
+	ret = tstream_bsd_existing_socket(conn, fds[0], &conn->stream);
+	assert_int_equal(ret, 0);
+	ctx->peer_fd = fds[1];
+
+	ctx->conn = conn;
+	*state = ctx;
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	struct test_ctx *ctx = talloc_get_type_abort(*state,
+						     struct test_ctx);
+
+	if (ctx->peer_fd != -1) {
+		close(ctx->peer_fd);
+	}
+	TALLOC_FREE(ctx->conn);
+	TALLOC_FREE(ctx);
+	return 0;
+}
+
+/*
+ * A call the backend is working on, like dcesrv_request() leaves it
+ */
+static struct dcesrv_call_state *new_pending_call(
+	struct dcesrv_connection *conn)
+{
+	struct dcesrv_call_state *call = NULL;
+
+	call = talloc_zero(conn, struct dcesrv_call_state);
+	assert_non_null(call);
+	call->conn = conn;
+	talloc_set_destructor(call, dcesrv_call_dequeue);
+	dcesrv_call_set_list(call, DCESRV_LIST_PENDING_CALL_LIST);
+
+	return call;
+}
+
+/*
+ * Fill the limit, the connection must stop reading
+ */
+static struct dcesrv_call_state *fill_pending_calls(
+	struct dcesrv_connection *conn)
+{
+	struct dcesrv_call_state *call = NULL;
+	size_t i;
+
+	for (i = 0; i < TEST_MAX_PENDING_CALLS; i++) {
+		assert_false(dcesrv_connection_pause_read(conn));
+		call = new_pending_call(conn);
+	}
+
+	assert_true(dcesrv_connection_pause_read(conn));
+	assert_true(conn->read_paused);
+
+	return call;
+}
+
+/*
+ * Close the client side, if the connection reads again it sees
+ * the end of the stream and (with calls still pending) defers
+ * its termination.
+ */
+static void assert_reading(struct test_ctx *ctx)
+{
+	struct dcesrv_connection *conn = ctx->conn;
+	int ret;
+
+	close(ctx->peer_fd);
+	ctx->peer_fd = -1;
+
+	while (conn->terminate == NULL) {
+		ret = tevent_loop_once(ctx->ev);
+		assert_int_equal(ret, 0);
+	}
+}
+
+static void test_resume_after_freed_call(void **state)
+{
+	struct test_ctx *ctx = talloc_get_type_abort(*state,
+						     struct test_ctx);
+	struct dcesrv_connection *conn = ctx->conn;
+	struct dcesrv_call_state *call = NULL;
+	int ret;
+
+	call = fill_pending_calls(conn);
+
+	/* the backend gave up on the call without a reply */
+	TALLOC_FREE(call);
+	assert_true(conn->read_paused);
+
+	ret = tevent_loop_once(ctx->ev);
+	assert_int_equal(ret, 0);
+	assert_false(conn->read_paused);
+
+	assert_reading(ctx);
+}
+
+static void test_resume_after_dropped_call(void **state)
+{
+	struct test_ctx *ctx = talloc_get_type_abort(*state,
+						     struct test_ctx);
+	struct dcesrv_connection *conn = ctx->conn;
+	struct dcesrv_call_state *call = NULL;
+	int ret;
+
+	call = fill_pending_calls(conn);
+
+	/* taken off the pending list without a reply */
+	dcesrv_call_set_list(call, DCESRV_LIST_NONE);
+	assert_true(conn->read_paused);
+
+	ret = tevent_loop_once(ctx->ev);
+	assert_int_equal(ret, 0);
+	assert_false(conn->read_paused);
+
+	assert_reading(ctx);
+}
+
+static void test_stay_paused_at_limit(void **state)
+{
+	struct test_ctx *ctx = talloc_get_type_abort(*state,
+						     struct test_ctx);
+	struct dcesrv_connection *conn = ctx->conn;
+	struct dcesrv_call_state *call = NULL;
+	int ret;
+
+	call = fill_pending_calls(conn);
+
+	/*
+	 * A call ends without a reply, but the limit is reached
+	 * again before the connection checks it.
+	 */
+	TALLOC_FREE(call);
+	new_pending_call(conn);
+
+	ret = tevent_loop_once(ctx->ev);
+	assert_int_equal(ret, 0);
+	assert_true(conn->read_paused);
+	assert_null(conn->terminate);
+}
+
+static void test_no_resume_while_terminating(void **state)
+{
+	struct test_ctx *ctx = talloc_get_type_abort(*state,
+						     struct test_ctx);
+	struct dcesrv_connection *conn = ctx->conn;
+	struct dcesrv_call_state *call = NULL;
+	int ret;
+
+	call = fill_pending_calls(conn);
+
+	dcesrv_terminate_connection(conn, "test");
+	assert_non_null(conn->terminate);
+
+	TALLOC_FREE(call);
+
+	ret = tevent_loop_once(ctx->ev);
+	assert_int_equal(ret, 0);
+	assert_true(conn->read_paused);
+}
+
+int main(int argc, const char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(test_resume_after_freed_call,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_resume_after_dropped_call,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_stay_paused_at_limit,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(
+			test_no_resume_while_terminating,
+			setup, teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_SUBUNIT);
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -37,6 +37,8 @@
 #include <cmocka.h>
 
 #include "librpc/ndr/libndr.h"
+#include "librpc/gen_ndr/ndr_misc.h"
+#include "lib/util/time.h"
 
 /*
  * Test NDR_PULL_NEED_BYTES integer overflow handling.
@@ -129,12 +131,235 @@ static void test_ndr_pull_advance(void **state)
 	assert_int_equal(NDR_ERR_BUFSIZE, err);
 }
 
+/*
+ * Test NDR_PULL_FIXED_LAYOUT integer overflow handling.
+ */
+static enum ndr_err_code wrap_NDR_PULL_FIXED_LAYOUT(
+	struct ndr_pull *ndr,
+	uint32_t bytes,
+	const uint8_t **p) {
+
+	NDR_PULL_FIXED_LAYOUT(ndr, bytes, *p);
+	return NDR_ERR_SUCCESS;
+}
+
+static void test_NDR_PULL_FIXED_LAYOUT(void **state)
+{
+	uint8_t data[4] = {0};
+	struct ndr_pull ndr = {0};
+	const uint8_t *p = NULL;
+	enum ndr_err_code err;
+
+	ndr.data = data;
+	ndr.data_size = sizeof(data);
+
+	err = wrap_NDR_PULL_FIXED_LAYOUT(&ndr, 4, &p);
+	assert_int_equal(NDR_ERR_SUCCESS, err);
+	assert_ptr_equal(data, p);
+	assert_int_equal(4, ndr.offset);
+
+	/*
+	 * Nothing left
+	 */
+	err = wrap_NDR_PULL_FIXED_LAYOUT(&ndr, 1, &p);
+	assert_int_equal(NDR_ERR_BUFSIZE, err);
+	assert_int_equal(4, ndr.offset);
+
+	/*
+	 * This will cause an overflow
+	 * and (offset + n) will be less than data_size
+	 */
+	ndr.data_size = UINT32_MAX;
+	ndr.offset = UINT32_MAX -1;
+	err = wrap_NDR_PULL_FIXED_LAYOUT(&ndr, 2, &p);
+	assert_int_equal(NDR_ERR_BUFSIZE, err);
+	assert_int_equal(UINT32_MAX -1, ndr.offset);
+}
+
+/*
+ * The generated policy_handle and GUID code uses the fixed layout
+ * macros, check that it produces the same wire format as pushing
+ * the members one by one, in both byte orders.
+ */
+static enum ndr_err_code push_policy_handle_members(
+	struct ndr_push *ndr,
+	const struct policy_handle *r)
+{
+	NDR_CHECK(ndr_push_align(ndr, 4));
+	NDR_CHECK(ndr_push_uint32(ndr, NDR_SCALARS, r->handle_type));
+	NDR_CHECK(ndr_push_uint32(ndr, NDR_SCALARS, r->uuid.time_low));
+	NDR_CHECK(ndr_push_uint16(ndr, NDR_SCALARS, r->uuid.time_mid));
+	NDR_CHECK(ndr_push_uint16(ndr, NDR_SCALARS, r->uuid.time_hi_and_version));
+	NDR_CHECK(ndr_push_array_uint8(ndr, NDR_SCALARS, r->uuid.clock_seq, 2));
+	NDR_CHECK(ndr_push_array_uint8(ndr, NDR_SCALARS, r->uuid.node, 6));
+	return NDR_ERR_SUCCESS;
+}
+
+static enum ndr_err_code pull_policy_handle_members(
+	struct ndr_pull *ndr,
+	struct policy_handle *r)
+{
+	NDR_CHECK(ndr_pull_align(ndr, 4));
+	NDR_CHECK(ndr_pull_uint32(ndr, NDR_SCALARS, &r->handle_type));
+	NDR_CHECK(ndr_pull_uint32(ndr, NDR_SCALARS, &r->uuid.time_low));
+	NDR_CHECK(ndr_pull_uint16(ndr, NDR_SCALARS, &r->uuid.time_mid));
+	NDR_CHECK(ndr_pull_uint16(ndr, NDR_SCALARS, &r->uuid.time_hi_and_version));
+	NDR_CHECK(ndr_pull_array_uint8(ndr, NDR_SCALARS, r->uuid.clock_seq, 2));
+	NDR_CHECK(ndr_pull_array_uint8(ndr, NDR_SCALARS, r->uuid.node, 6));
+	return NDR_ERR_SUCCESS;
+}
+
+static void check_policy_handle(uint32_t flags)
+{
+	TALLOC_CTX *mem_ctx = talloc_new(NULL);
+	struct policy_handle in = {
+		.handle_type = 0x01020304,
+		.uuid = {
+			.time_low = 0x05060708,
+			.time_mid = 0x090a,
+			.time_hi_and_version = 0x0b0c,
+			.clock_seq = { 0x0d, 0x0e },
+			.node = { 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14 },
+		},
+	};
+	struct policy_handle out = {0};
+	struct ndr_push *push = NULL;
+	struct ndr_push *ref = NULL;
+	struct ndr_pull *pull = NULL;
+	DATA_BLOB blob;
+	DATA_BLOB ref_blob;
+	enum ndr_err_code err;
+
+	push = ndr_push_init_ctx(mem_ctx);
+	assert_non_null(push);
+	push->flags |= flags;
+	err = ndr_push_policy_handle(push, NDR_SCALARS, &in);
+	assert_int_equal(NDR_ERR_SUCCESS, err);
+	blob = ndr_push_blob(push);
+	assert_int_equal(20, blob.length);
+
+	ref = ndr_push_init_ctx(mem_ctx);
+	assert_non_null(ref);
+	ref->flags |= flags;
+	err = push_policy_handle_members(ref, &in);
+	assert_int_equal(NDR_ERR_SUCCESS, err);
+	ref_blob = ndr_push_blob(ref);
+	assert_int_equal(ref_blob.length, blob.length);
+	assert_memory_equal(ref_blob.data, blob.data, blob.length);
+
+	pull = ndr_pull_init_blob(&blob, mem_ctx);
+	assert_non_null(pull);
+	pull->flags |= flags;
+	err = ndr_pull_policy_handle(pull, NDR_SCALARS, &out);
+	assert_int_equal(NDR_ERR_SUCCESS, err);
+	assert_int_equal(blob.length, pull->offset);
+	assert_memory_equal(&in, &out, sizeof(in));
+
+	/*
+	 * A short buffer fails the single bounds check
+	 */
+	blob.length -= 1;
+	pull = ndr_pull_init_blob(&blob, mem_ctx);
+	assert_non_null(pull);
+	pull->flags |= flags;
+	err = ndr_pull_policy_handle(pull, NDR_SCALARS, &out);
+	assert_int_equal(NDR_ERR_BUFSIZE, err);
+
+	TALLOC_FREE(mem_ctx);
+}
+
+static void test_fixed_layout_policy_handle(void **state)
+{
+	check_policy_handle(0);
+	check_policy_handle(LIBNDR_FLAG_BIGENDIAN);
+}
+
+/*
+ * Compare the generated fixed layout code against pushing and
+ * pulling the members one by one. This only reports the rates,
+ * it does not fail on a slow machine.
+ */
+#define FIXED_LAYOUT_BENCH_LOOPS 1000000
+
+static void test_fixed_layout_benchmark(void **state)
+{
+	TALLOC_CTX *mem_ctx = talloc_new(NULL);
+	struct policy_handle in = {
+		.handle_type = 1,
+		.uuid = {
+			.time_low = 0x05060708,
+			.time_mid = 0x090a,
+			.time_hi_and_version = 0x0b0c,
+		},
+	};
+	struct policy_handle out;
+	struct ndr_push *push = NULL;
+	struct ndr_pull *pull = NULL;
+	struct timeval start;
+	double t_fixed, t_members;
+	DATA_BLOB blob;
+	enum ndr_err_code err;
+	uint32_t i;
+
+	push = ndr_push_init_ctx(mem_ctx);
+	assert_non_null(push);
+
+	start = timeval_current();
+	for (i = 0; i < FIXED_LAYOUT_BENCH_LOOPS; i++) {
+		push->offset = 0;
+		err = ndr_push_policy_handle(push, NDR_SCALARS, &in);
+		assert_int_equal(NDR_ERR_SUCCESS, err);
+	}
+	t_fixed = timeval_elapsed(&start);
+
+	start = timeval_current();
+	for (i = 0; i < FIXED_LAYOUT_BENCH_LOOPS; i++) {
+		push->offset = 0;
+		err = push_policy_handle_members(push, &in);
+		assert_int_equal(NDR_ERR_SUCCESS, err);
+	}
+	t_members = timeval_elapsed(&start);
+
+	print_message("push policy_handle: fixed layout %.3fs, "
+		      "per member %.3fs for %u loops\n",
+		      t_fixed, t_members, FIXED_LAYOUT_BENCH_LOOPS);
+
+	blob = ndr_push_blob(push);
+	pull = ndr_pull_init_blob(&blob, mem_ctx);
+	assert_non_null(pull);
+
+	start = timeval_current();
+	for (i = 0; i < FIXED_LAYOUT_BENCH_LOOPS; i++) {
+		pull->offset = 0;
+		err = ndr_pull_policy_handle(pull, NDR_SCALARS, &out);
+		assert_int_equal(NDR_ERR_SUCCESS, err);
+	}
+	t_fixed = timeval_elapsed(&start);
+
+	start = timeval_current();
+	for (i = 0; i < FIXED_LAYOUT_BENCH_LOOPS; i++) {
+		pull->offset = 0;
+		err = pull_policy_handle_members(pull, &out);
+		assert_int_equal(NDR_ERR_SUCCESS, err);
+	}
+	t_members = timeval_elapsed(&start);
+
+	print_message("pull policy_handle: fixed layout %.3fs, "
+		      "per member %.3fs for %u loops\n",
+		      t_fixed, t_members, FIXED_LAYOUT_BENCH_LOOPS);
+
+	TALLOC_FREE(mem_ctx);
+}
+
 int main(int argc, const char **argv)
 {
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test(test_NDR_PULL_NEED_BYTES),
 		cmocka_unit_test(test_NDR_PULL_ALIGN),
 		cmocka_unit_test(test_ndr_pull_advance),
+		cmocka_unit_test(test_NDR_PULL_FIXED_LAYOUT),
+		cmocka_unit_test(test_fixed_layout_policy_handle),
+		cmocka_unit_test(test_fixed_layout_benchmark),
 	};
 
 	cmocka_set_message_output(CM_OUTPUT_SUBUNIT);
@@ -0,0 +1,336 @@
+/*
+ * Tests for pulling NDR data into a talloc pool
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * from cmocka.c:
+ * These headers or their equivalents should be included prior to
+ * including
+ * this header file.
+ *
+ * #include <stdarg.h>
+ * #include <stddef.h>
+ * #include <setjmp.h>
+ *
+ * This allows test applications to use custom definitions of C standard
+ * library functions and types.
+ *
+ */
+#include "replace.h"
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "lib/util/time.h"
+#include "librpc/ndr/libndr.h"
+#include "librpc/gen_ndr/ndr_lsa.h"
+#include "librpc/gen_ndr/ndr_drsuapi.h"
+
+#define NUM_LSA_NAMES 20000
+#define NUM_DRS_OBJECTS 2000
+#define NUM_DRS_ATTRIBUTES 8
+#define NUM_BENCH_LOOPS 20
+
+/*
+ * A lsa_LookupSids() style reply with a lot of names, one of them
+ * not ASCII so that the iconv path is covered as well.
+ */
+static DATA_BLOB make_lsa_names(TALLOC_CTX *mem_ctx)
+{
+	struct lsa_TransNameArray names = {
+		.count = NUM_LSA_NAMES,
+	};
+	DATA_BLOB blob;
+	enum ndr_err_code ndr_err;
+	uint32_t i;
+
+	names.names = talloc_zero_array(mem_ctx,
+					struct lsa_TranslatedName,
+					NUM_LSA_NAMES);
+	assert_non_null(names.names);
+
+	for (i = 0; i < NUM_LSA_NAMES; i++) {
+		struct lsa_TranslatedName *n = &names.names[i];
+
+		n->sid_type = SID_NAME_USER;
+		n->sid_index = i % 3;
+		n->name.string = talloc_asprintf(names.names,
+						 "user%05"PRIu32, i);
+		assert_non_null(n->name.string);
+	}
+	names.names[7].name.string = "J\xc3\xb6rg";
+
+	ndr_err = ndr_push_struct_blob(&blob, mem_ctx, &names,
+			(ndr_push_flags_fn_t)ndr_push_lsa_TransNameArray);
+	assert_true(NDR_ERR_CODE_IS_SUCCESS(ndr_err));
+
+	return blob;
+}
+
+/*
+ * A drsuapi_DsGetNCChanges() style reply
+ */
+static DATA_BLOB make_drs_ctr6(TALLOC_CTX *mem_ctx)
+{
+	struct drsuapi_DsGetNCChangesCtr6 ctr6 = {
+		.object_count = NUM_DRS_OBJECTS,
+		.more_data = true,
+	};
+	struct drsuapi_DsReplicaObjectListItemEx *prev = NULL;
+	DATA_BLOB blob;
+	enum ndr_err_code ndr_err;
+	uint32_t i, j;
+
+	ctr6.naming_context = talloc_zero(mem_ctx,
+				struct drsuapi_DsReplicaObjectIdentifier);
+	assert_non_null(ctr6.naming_context);
+	ctr6.naming_context->dn = "DC=samba,DC=example,DC=com";
+
+	for (i = 0; i < NUM_DRS_OBJECTS; i++) {
+		struct drsuapi_DsReplicaObjectListItemEx *obj = NULL;
+		struct drsuapi_DsReplicaObject *o = NULL;
+
+		obj = talloc_zero(mem_ctx,
+				  struct drsuapi_DsReplicaObjectListItemEx);
+		assert_non_null(obj);
+		o = &obj->object;
+
+		o->identifier = talloc_zero(obj,
+				struct drsuapi_DsReplicaObjectIdentifier);
+		assert_non_null(o->identifier);
+		o->identifier->guid.time_low = i;
+		o->identifier->dn = talloc_asprintf(o->identifier,
+				"CN=user%05"PRIu32",CN=Users,"
+				"DC=samba,DC=example,DC=com", i);
+		assert_non_null(o->identifier->dn);
+
+		o->attribute_ctr.num_attributes = NUM_DRS_ATTRIBUTES;
+		o->attribute_ctr.attributes = talloc_zero_array(obj,
+					struct drsuapi_DsReplicaAttribute,
+					NUM_DRS_ATTRIBUTES);
+		assert_non_null(o->attribute_ctr.attributes);
+
+		for (j = 0; j < NUM_DRS_ATTRIBUTES; j++) {
+			struct drsuapi_DsReplicaAttribute *a =
+				&o->attribute_ctr.attributes[j];
+			uint8_t value[32];
+
+			memset(value, i + j, sizeof(value));
+
+			a->attid = DRSUAPI_ATTID_description + j;
+			a->value_ctr.num_values = 1;
+			a->value_ctr.values = talloc_zero(obj,
+					struct drsuapi_DsAttributeValue);
+			assert_non_null(a->value_ctr.values);
+			a->value_ctr.values->blob = talloc(obj, DATA_BLOB);
+			assert_non_null(a->value_ctr.values->blob);
+			*a->value_ctr.values->blob = data_blob_talloc(obj,
+							value,
+							sizeof(value));
+		}
+
+		if (prev == NULL) {
+			ctr6.first_object = obj;
+		} else {
+			prev->next_object = obj;
+		}
+		prev = obj;
+	}
+
+	ndr_err = ndr_push_struct_blob(&blob, mem_ctx, &ctr6,
+			(ndr_push_flags_fn_t)ndr_push_drsuapi_DsGetNCChangesCtr6);
+	assert_true(NDR_ERR_CODE_IS_SUCCESS(ndr_err));
+
+	return blob;
+}
+
+static void pull_blob(const DATA_BLOB *blob,
+		      TALLOC_CTX *mem_ctx,
+		      bool use_pool,
+		      void *r,
+		      ndr_pull_flags_fn_t pull_fn)
+{
+	struct ndr_pull *ndr = NULL;
+	enum ndr_err_code ndr_err;
+
+	ndr = ndr_pull_init_blob(blob, mem_ctx);
+	assert_non_null(ndr);
+
+	if (use_pool) {
+		ndr_err = ndr_pull_set_mem_pool(ndr, mem_ctx);
+		assert_true(NDR_ERR_CODE_IS_SUCCESS(ndr_err));
+	}
+
+	ndr_err = pull_fn(ndr, NDR_SCALARS|NDR_BUFFERS, r);
+	assert_true(NDR_ERR_CODE_IS_SUCCESS(ndr_err));
+	assert_int_equal(ndr->offset, blob->length);
+
+	TALLOC_FREE(ndr);
+}
+
+/*
+ * Whether pulled with or without the pool, the result has to
+ * marshall back into the original blob.
+ */
+static void check_roundtrip(const DATA_BLOB *blob,
+			    bool use_pool,
+			    size_t struct_size,
+			    ndr_pull_flags_fn_t pull_fn,
+			    ndr_push_flags_fn_t push_fn)
+{
+	TALLOC_CTX *mem_ctx = talloc_new(NULL);
+	void *r = NULL;
+	DATA_BLOB blob2;
+	enum ndr_err_code ndr_err;
+
+	assert_non_null(mem_ctx);
+	r = talloc_zero_size(mem_ctx, struct_size);
+	assert_non_null(r);
+
+	pull_blob(blob, mem_ctx, use_pool, r, pull_fn);
+
+	ndr_err = ndr_push_struct_blob(&blob2, mem_ctx, r, push_fn);
+	assert_true(NDR_ERR_CODE_IS_SUCCESS(ndr_err));
+	assert_int_equal(blob->length, blob2.length);
+	assert_memory_equal(blob->data, blob2.data, blob->length);
+
+	TALLOC_FREE(mem_ctx);
+}
+
+static void test_lsa_names_roundtrip(void **state)
+{
+	TALLOC_CTX *mem_ctx = talloc_new(NULL);
+	DATA_BLOB blob = make_lsa_names(mem_ctx);
+
+	check_roundtrip(&blob, false,
+			sizeof(struct lsa_TransNameArray),
+			(ndr_pull_flags_fn_t)ndr_pull_lsa_TransNameArray,
+			(ndr_push_flags_fn_t)ndr_push_lsa_TransNameArray);
+	check_roundtrip(&blob, true,
+			sizeof(struct lsa_TransNameArray),
+			(ndr_pull_flags_fn_t)ndr_pull_lsa_TransNameArray,
+			(ndr_push_flags_fn_t)ndr_push_lsa_TransNameArray);
+
+	TALLOC_FREE(mem_ctx);
+}
+
+static void test_drs_ctr6_roundtrip(void **state)
+{
+	TALLOC_CTX *mem_ctx = talloc_new(NULL);
+	DATA_BLOB blob = make_drs_ctr6(mem_ctx);
+
+	check_roundtrip(&blob, false,
+			sizeof(struct drsuapi_DsGetNCChangesCtr6),
+			(ndr_pull_flags_fn_t)ndr_pull_drsuapi_DsGetNCChangesCtr6,
+			(ndr_push_flags_fn_t)ndr_push_drsuapi_DsGetNCChangesCtr6);
+	check_roundtrip(&blob, true,
+			sizeof(struct drsuapi_DsGetNCChangesCtr6),
+			(ndr_pull_flags_fn_t)ndr_pull_drsuapi_DsGetNCChangesCtr6,
+			(ndr_push_flags_fn_t)ndr_push_drsuapi_DsGetNCChangesCtr6);
+
+	TALLOC_FREE(mem_ctx);
+}
+
+/*
+ * Objects pulled into the pool are normal talloc chunks, they
+ * can be stolen and outlive the context the pool hangs off.
+ */
+static void test_pool_steal(void **state)
+{
+	TALLOC_CTX *mem_ctx = talloc_new(NULL);
+	TALLOC_CTX *pull_ctx = talloc_new(mem_ctx);
+	DATA_BLOB blob = make_lsa_names(mem_ctx);
+	struct lsa_TransNameArray names = {0};
+	const char *name = NULL;
+
+	pull_blob(&blob, pull_ctx, true, &names,
+		  (ndr_pull_flags_fn_t)ndr_pull_lsa_TransNameArray);
+	assert_int_equal(names.count, NUM_LSA_NAMES);
+	assert_string_equal(names.names[7].name.string, "J\xc3\xb6rg");
+	assert_string_equal(names.names[42].name.string, "user00042");
+
+	name = talloc_steal(mem_ctx, names.names[42].name.string);
+	TALLOC_FREE(pull_ctx);
+	assert_string_equal(name, "user00042");
+
+	TALLOC_FREE(mem_ctx);
+}
+
+static double time_pull(const DATA_BLOB *blob,
+			bool use_pool,
+			size_t struct_size,
+			ndr_pull_flags_fn_t pull_fn)
+{
+	struct timeval start = timeval_current();
+	uint32_t i;
+
+	for (i = 0; i < NUM_BENCH_LOOPS; i++) {
+		TALLOC_CTX *mem_ctx = talloc_new(NULL);
+		void *r = talloc_zero_size(mem_ctx, struct_size);
+
+		assert_non_null(r);
+		pull_blob(blob, mem_ctx, use_pool, r, pull_fn);
+		TALLOC_FREE(mem_ctx);
+	}
+
+	return timeval_elapsed(&start);
+}
+
+/*
+ * This only reports the numbers, it does not fail on a slow machine.
+ */
+static void test_pull_benchmark(void **state)
+{
+	TALLOC_CTX *mem_ctx = talloc_new(NULL);
+	DATA_BLOB lsa = make_lsa_names(mem_ctx);
+	DATA_BLOB drs = make_drs_ctr6(mem_ctx);
+	double t_plain, t_pool;
+
+	t_plain = time_pull(&lsa, false,
+			    sizeof(struct lsa_TransNameArray),
+			    (ndr_pull_flags_fn_t)ndr_pull_lsa_TransNameArray);
+	t_pool = time_pull(&lsa, true,
+			   sizeof(struct lsa_TransNameArray),
+			   (ndr_pull_flags_fn_t)ndr_pull_lsa_TransNameArray);
+	print_message("lsa_TransNameArray (%zu bytes): "
+		      "talloc %.3fs, pool %.3fs for %u loops\n",
+		      lsa.length, t_plain, t_pool, NUM_BENCH_LOOPS);
+
+	t_plain = time_pull(&drs, false,
+			    sizeof(struct drsuapi_DsGetNCChangesCtr6),
+			    (ndr_pull_flags_fn_t)ndr_pull_drsuapi_DsGetNCChangesCtr6);
+	t_pool = time_pull(&drs, true,
+			   sizeof(struct drsuapi_DsGetNCChangesCtr6),
+			   (ndr_pull_flags_fn_t)ndr_pull_drsuapi_DsGetNCChangesCtr6);
+	print_message("drsuapi_DsGetNCChangesCtr6 (%zu bytes): "
+		      "talloc %.3fs, pool %.3fs for %u loops\n",
+		      drs.length, t_plain, t_pool, NUM_BENCH_LOOPS);
+
+	TALLOC_FREE(mem_ctx);
+}
+
+int main(int argc, const char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_lsa_names_roundtrip),
+		cmocka_unit_test(test_drs_ctr6_roundtrip),
+		cmocka_unit_test(test_pool_steal),
+		cmocka_unit_test(test_pull_benchmark),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_SUBUNIT);
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
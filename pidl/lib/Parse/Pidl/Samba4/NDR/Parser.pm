@@ -88,6 +88,122 @@ sub has_fast_array($$)
 	return ($t->{NAME} eq "uint8");
 }
 
+# Scalars that may make up a fixed layout structure: their size and
+# alignment on the wire, the NDR_FIXED_* accessor that matches the
+# ndr_push_/ndr_pull_ function and the C type of signed values
+my %fixed_layout_scalars = (
+	"uint8"        => [ 1, 1, "U8",     undef ],
+	"int8"         => [ 1, 1, "U8",     "int8_t" ],
+	"uint16"       => [ 2, 2, "U16",    undef ],
+	"int16"        => [ 2, 2, "U16",    "int16_t" ],
+	"uint32"       => [ 4, 4, "U32",    undef ],
+	"int32"        => [ 4, 4, "U32",    "int32_t" ],
+	"udlong"       => [ 8, 4, "UDLONG", undef ],
+	"dlong"        => [ 8, 4, "UDLONG", "int64_t" ],
+	"NTTIME"       => [ 8, 4, "UDLONG", undef ],
+	"hyper"        => [ 8, 8, "HYPER",  undef ],
+	"NTTIME_hyper" => [ 8, 8, "HYPER",  undef ],
+);
+
+#####################################################################
+# Work out the wire layout of a structure that only consists of the
+# scalars above, fixed size byte arrays and other such structures,
+# without any padding. Returns undef if the structure doesn't qualify.
+sub FixedLayout($$);
+sub FixedLayout($$)
+{
+	my ($struct, $prefix) = @_;
+	my $offset = 0;
+	my $align = 1;
+	my @members = ();
+
+	return undef unless defined($struct->{ELEMENTS});
+	return undef if (scalar(@{$struct->{ELEMENTS}}) == 0);
+
+	foreach my $e (@{$struct->{ELEMENTS}}) {
+		my $type = $e->{TYPE};
+		my $count = undef;
+
+		return undef if ref($type);
+		return undef if ($e->{POINTERS});
+		foreach my $p (keys %{$e->{PROPERTIES}}) {
+			return undef unless ($p eq "noprint");
+		}
+
+		if (defined($e->{ARRAY_LEN}) and scalar(@{$e->{ARRAY_LEN}})) {
+			return undef if (scalar(@{$e->{ARRAY_LEN}}) > 1);
+			return undef unless ($e->{ARRAY_LEN}[0] =~ /^[0-9]+$/);
+			$count = $e->{ARRAY_LEN}[0];
+			return undef if ($count == 0);
+		}
+
+		$type = Parse::Pidl::Typelist::expandAlias($type);
+
+		if (defined($fixed_layout_scalars{$type})) {
+			my ($size, $salign, $access, $cast) = @{$fixed_layout_scalars{$type}};
+
+			# Arrays other than byte arrays are left to the
+			# generic code
+			return undef if (defined($count) and $size != 1);
+			return undef if ($offset % $salign);
+
+			push (@members, {
+				NAME => "$prefix$e->{NAME}",
+				OFFSET => $offset,
+				ACCESS => $access,
+				CAST => $cast,
+				COUNT => $count,
+			});
+			$offset += $size * (defined($count) ? $count : 1);
+			$align = $salign if ($salign > $align);
+			next;
+		}
+
+		return undef if defined($count);
+		return undef unless hasType($type);
+
+		my $t = getType($type);
+		my $props = $t->{PROPERTIES};
+		$t = $t->{DATA} if ($t->{TYPE} eq "TYPEDEF");
+		return undef unless (ref($t) eq "HASH" and $t->{TYPE} eq "STRUCT");
+		foreach my $p ("flag", "nopush", "nopull", "relative_base") {
+			return undef if has_property($t, $p);
+			return undef if (defined($props) and defined($props->{$p}));
+		}
+
+		my $nested = FixedLayout($t, "$prefix$e->{NAME}.");
+		return undef unless defined($nested);
+		return undef if ($offset % $nested->{ALIGN});
+
+		foreach my $m (@{$nested->{MEMBERS}}) {
+			$m->{OFFSET} += $offset;
+			push (@members, $m);
+		}
+		$offset += $nested->{SIZE};
+		$align = $nested->{ALIGN} if ($nested->{ALIGN} > $align);
+	}
+
+	# the trailer alignment has to be a no-op as well
+	return undef if ($offset % $align);
+
+	return { MEMBERS => \@members, SIZE => $offset, ALIGN => $align };
+}
+
+sub fixed_layout($$)
+{
+	my ($struct, $varname) = @_;
+
+	return undef unless defined($struct->{ORIGINAL});
+	return undef if defined($struct->{PROPERTIES}{relative_base});
+	return undef if defined($struct->{SURROUNDING_ELEMENT});
+
+	my $layout = FixedLayout($struct->{ORIGINAL}, "$varname->");
+	return undef unless defined($layout);
+	return undef if ($layout->{ALIGN} != $struct->{ALIGN});
+
+	return $layout;
+}
+
 sub is_public_struct
 {
 	my ($d) = @_;
@@ -1479,11 +1595,30 @@ sub ParseStructPushPrimitives($$$$$)
 		$self->pidl("NDR_CHECK(ndr_push_setup_relative_base_offset1($ndr, $varname, $ndr->offset));");
 	}
 
-	$self->ParseElementPush($_, $ndr, $env, 1, 0) foreach (@{$struct->{ELEMENTS}});
+	my $layout = fixed_layout($struct, $varname);
+	if (defined($layout)) {
+		$self->ParseFixedLayoutPush($layout, $ndr);
+	} else {
+		$self->ParseElementPush($_, $ndr, $env, 1, 0) foreach (@{$struct->{ELEMENTS}});
+	}
 
 	$self->pidl("NDR_CHECK(ndr_push_trailer_align($ndr, $struct->{ALIGN}));");
 }
 
+sub ParseFixedLayoutPush($$$)
+{
+	my ($self, $layout, $ndr) = @_;
+
+	$self->pidl("NDR_PUSH_FIXED_LAYOUT($ndr, $layout->{SIZE}, _fixed);");
+	foreach my $m (@{$layout->{MEMBERS}}) {
+		if (defined($m->{COUNT})) {
+			$self->pidl("memcpy(_fixed + $m->{OFFSET}, $m->{NAME}, $m->{COUNT});");
+			next;
+		}
+		$self->pidl("NDR_FIXED_PUSH_$m->{ACCESS}($ndr, _fixed, $m->{OFFSET}, $m->{NAME});");
+	}
+}
+
 sub ParseStructPushDeferred($$$$)
 {
 	my ($self, $struct, $ndr, $varname, $env) = @_;
@@ -1507,7 +1642,11 @@ sub ParseStructPush($$$$)
 
 	EnvSubstituteValue($env, $struct);
 
-	$self->DeclareArrayVariablesNoZero($_, $env) foreach (@{$struct->{ELEMENTS}});
+	if (defined(fixed_layout($struct, $varname))) {
+		$self->pidl("uint8_t *_fixed = NULL;");
+	} else {
+		$self->DeclareArrayVariablesNoZero($_, $env) foreach (@{$struct->{ELEMENTS}});
+	}
 
 	$self->start_flags($struct, $ndr);
 
@@ -1810,13 +1949,34 @@ sub ParseStructPullPrimitives($$$$$)
 		$self->pidl("NDR_CHECK(ndr_pull_setup_relative_base_offset1($ndr, $varname, $ndr->offset));");
 	}
 
-	$self->ParseElementPull($_, $ndr, $env, 1, 0) foreach (@{$struct->{ELEMENTS}});
+	my $layout = fixed_layout($struct, $varname);
+	if (defined($layout)) {
+		$self->ParseFixedLayoutPull($layout, $ndr);
+	} else {
+		$self->ParseElementPull($_, $ndr, $env, 1, 0) foreach (@{$struct->{ELEMENTS}});
+	}
 
 	$self->add_deferred();
 
 	$self->pidl("NDR_CHECK(ndr_pull_trailer_align($ndr, $struct->{ALIGN}));");
 }
 
+sub ParseFixedLayoutPull($$$)
+{
+	my ($self, $layout, $ndr) = @_;
+
+	$self->pidl("NDR_PULL_FIXED_LAYOUT($ndr, $layout->{SIZE}, _fixed);");
+	foreach my $m (@{$layout->{MEMBERS}}) {
+		if (defined($m->{COUNT})) {
+			$self->pidl("memcpy($m->{NAME}, _fixed + $m->{OFFSET}, $m->{COUNT});");
+			next;
+		}
+		my $cast = "";
+		$cast = "($m->{CAST})" if defined($m->{CAST});
+		$self->pidl("$m->{NAME} = ${cast}NDR_FIXED_PULL_$m->{ACCESS}($ndr, _fixed, $m->{OFFSET});");
+	}
+}
+
 sub ParseStructPullDeferred($$$$$)
 {
 	my ($self,$struct,$ndr,$varname,$env) = @_;
@@ -1842,10 +2002,14 @@ sub ParseStructPull($$$$)
 	return unless defined $struct->{ELEMENTS};
 
 	# declare any internal pointers we need
-	foreach my $e (@{$struct->{ELEMENTS}}) {
-		$self->DeclarePtrVariables($e);
-		$self->DeclareArrayVariables($e, "pull");
-		$self->DeclareMemCtxVariables($e);
+	if (defined(fixed_layout($struct, $varname))) {
+		$self->pidl("const uint8_t *_fixed = NULL;");
+	} else {
+		foreach my $e (@{$struct->{ELEMENTS}}) {
+			$self->DeclarePtrVariables($e);
+			$self->DeclareArrayVariables($e, "pull");
+			$self->DeclareMemCtxVariables($e);
+		}
 	}
 
 	$self->start_flags($struct, $ndr);
@@ -0,0 +1,207 @@
+#!/usr/bin/perl
+# NDR fixed layout structure tests
+# Published under the GNU GPL
+use strict;
+use warnings;
+
+use Test::More tests => 8 * 5 + 4;
+use FindBin qw($RealBin);
+use lib "$RealBin";
+use Util qw(test_samba4_ndr);
+use Parse::Pidl::IDL;
+use Parse::Pidl::NDR;
+use Parse::Pidl::Samba4::NDR::Parser;
+
+sub generate_parser($)
+{
+	my ($idl) = @_;
+
+	my $pidl = Parse::Pidl::IDL::parse_string("interface echo { $idl }; ", "<fixed>");
+	my $pndr = Parse::Pidl::NDR::Parse($pidl);
+	my $generator = new Parse::Pidl::Samba4::NDR::Parser();
+	my ($ndrheader, $ndrparser) = $generator->Parse($pndr, undef, undef);
+
+	return $ndrparser;
+}
+
+my $parser = generate_parser('
+	typedef [public] struct {
+		uint32 a;
+		uint16 b;
+		uint16 c;
+		uint8 d[8];
+	} bla;
+');
+like($parser, qr/NDR_PUSH_FIXED_LAYOUT\(ndr, 16, _fixed\);/,
+     "fixed layout push with a single bounds check");
+like($parser, qr/NDR_PULL_FIXED_LAYOUT\(ndr, 16, _fixed\);/,
+     "fixed layout pull with a single bounds check");
+
+# padding between the members needs the generic code
+$parser = generate_parser('
+	typedef [public] struct {
+		uint8 x;
+		uint32 y;
+	} bla;
+');
+unlike($parser, qr/FIXED_LAYOUT/, "no fixed layout with padding");
+
+# so do pointers and conformant arrays
+$parser = generate_parser('
+	typedef [public] struct {
+		uint32 count;
+		[size_is(count)] uint8 *data;
+	} bla;
+');
+unlike($parser, qr/FIXED_LAYOUT/, "no fixed layout with pointers");
+
+test_samba4_ndr('fixed-layout-push',
+'
+	typedef [public] struct {
+		uint32 a;
+		uint16 b;
+		uint16 c;
+		uint8 d[8];
+	} bla;
+',
+'
+	struct ndr_push *ndr = ndr_push_init_ctx(NULL);
+	struct bla r;
+	uint8_t expected[] = { 0x04, 0x03, 0x02, 0x01, 0x06, 0x05, 0x08, 0x07,
+			       0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10 };
+	DATA_BLOB expected_blob = { expected, 16 };
+	DATA_BLOB result_blob;
+	uint8_t i;
+
+	r.a = 0x01020304;
+	r.b = 0x0506;
+	r.c = 0x0708;
+	for (i = 0; i < 8; i++) {
+		r.d[i] = 0x09 + i;
+	}
+
+	if (!NDR_ERR_CODE_IS_SUCCESS(ndr_push_bla(ndr, NDR_SCALARS|NDR_BUFFERS, &r)))
+		return 1;
+
+	result_blob = ndr_push_blob(ndr);
+
+	if (data_blob_cmp(&result_blob, &expected_blob) != 0)
+		return 2;
+');
+
+test_samba4_ndr('fixed-layout-pull-bigendian',
+'
+	typedef [public] struct {
+		uint32 a;
+		int16 b;
+		uint16 c;
+	} bla;
+',
+'
+	uint8_t data[] = { 0x01, 0x02, 0x03, 0x04, 0xff, 0xfe, 0x07, 0x08 };
+	DATA_BLOB blob = { data, sizeof(data) };
+	struct ndr_pull *ndr = ndr_pull_init_blob(&blob, NULL);
+	struct bla r;
+
+	ndr->flags |= LIBNDR_FLAG_BIGENDIAN;
+
+	if (!NDR_ERR_CODE_IS_SUCCESS(ndr_pull_bla(ndr, NDR_SCALARS|NDR_BUFFERS, &r)))
+		return 1;
+
+	if (r.a != 0x01020304 || r.b != -2 || r.c != 0x0708)
+		return 2;
+
+	if (ndr->offset != 8)
+		return 3;
+');
+
+test_samba4_ndr('fixed-layout-pull-short',
+'
+	typedef [public] struct {
+		uint32 a;
+		uint32 b;
+	} bla;
+',
+'
+	uint8_t data[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07 };
+	DATA_BLOB blob = { data, sizeof(data) };
+	struct ndr_pull *ndr = ndr_pull_init_blob(&blob, NULL);
+	struct bla r;
+
+	if (NDR_ERR_CODE_IS_SUCCESS(ndr_pull_bla(ndr, NDR_SCALARS|NDR_BUFFERS, &r)))
+		return 1;
+');
+
+test_samba4_ndr('fixed-layout-nested',
+'
+	typedef [public] struct {
+		uint32 x;
+		uint8 y[4];
+	} inner;
+
+	typedef [public] struct {
+		uint32 a;
+		inner b;
+	} bla;
+',
+'
+	struct ndr_push *ndr = ndr_push_init_ctx(NULL);
+	struct bla r;
+	struct bla r2;
+	uint8_t expected[] = { 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+			       0x03, 0x04, 0x05, 0x06 };
+	DATA_BLOB expected_blob = { expected, 12 };
+	DATA_BLOB result_blob;
+	struct ndr_pull *pull;
+
+	r.a = 1;
+	r.b.x = 2;
+	r.b.y[0] = 3;
+	r.b.y[1] = 4;
+	r.b.y[2] = 5;
+	r.b.y[3] = 6;
+
+	if (!NDR_ERR_CODE_IS_SUCCESS(ndr_push_bla(ndr, NDR_SCALARS|NDR_BUFFERS, &r)))
+		return 1;
+
+	result_blob = ndr_push_blob(ndr);
+
+	if (data_blob_cmp(&result_blob, &expected_blob) != 0)
+		return 2;
+
+	pull = ndr_pull_init_blob(&result_blob, NULL);
+	if (!NDR_ERR_CODE_IS_SUCCESS(ndr_pull_bla(pull, NDR_SCALARS|NDR_BUFFERS, &r2)))
+		return 3;
+
+	if (memcmp(&r, &r2, sizeof(r)) != 0)
+		return 4;
+');
+
+test_samba4_ndr('fixed-layout-hyper',
+'
+	typedef [public] struct {
+		hyper a;
+		udlong b;
+	} bla;
+',
+'
+	struct ndr_push *ndr = ndr_push_init_ctx(NULL);
+	struct bla r;
+	uint8_t expected[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+			       0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10 };
+	DATA_BLOB expected_blob = { expected, 16 };
+	DATA_BLOB result_blob;
+
+	ndr->flags |= LIBNDR_FLAG_BIGENDIAN;
+
+	r.a = 0x0102030405060708ULL;
+	r.b = 0x0d0e0f10090a0b0cULL;
+
+	if (!NDR_ERR_CODE_IS_SUCCESS(ndr_push_bla(ndr, NDR_SCALARS|NDR_BUFFERS, &r)))
+		return 1;
+
+	result_blob = ndr_push_blob(ndr);
+
+	if (data_blob_cmp(&result_blob, &expected_blob) != 0)
+		return 2;
+');
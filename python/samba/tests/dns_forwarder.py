@@ -596,5 +596,72 @@ class TestDnsForwarding(DNSTest):
         except socket.timeout:
             self.fail("DNS server is too slow (timeout %s)" % timeout)
 
+    def forwarded_query(self, name, qtype=dns.DNS_QTYPE_CNAME):
+        ad = contact_real_server(server_ip, 53)
+        p = self.make_name_packet(dns.DNS_OPCODE_QUERY)
+        q = self.make_name_question(name, qtype, dns.DNS_QCLASS_IN)
+        self.finish_name_packet(p, [q])
+        p.operation |= dns.DNS_FLAG_RECURSION_DESIRED
+        send_packet = ndr.ndr_pack(p)
+
+        ad.send(send_packet, 0)
+        ad.settimeout(timeout)
+        try:
+            data = ad.recv(0xffff + 2, 0)
+            return ndr.ndr_unpack(dns.name_packet, data)
+        except socket.timeout:
+            self.fail("DNS server is too slow (timeout %s)" % timeout)
+
+    def test_cached_answer(self):
+        s = self.start_toy_server(dns_servers[0], 53, 'forwarder1')
+        s.send(b'ttl 300', 0)
+        name = "cached-%08x.dsfsdfs" % random.randint(0, 0xffffffff)
+
+        data = self.forwarded_query(name)
+        self.assert_dns_rcode_equals(data, dns.DNS_RCODE_OK)
+        self.assertEqual('forwarder1', data.answers[0].rdata)
+        self.assertEqual(300, data.answers[0].ttl)
+
+        # The forwarder stops answering, the reply now has to come
+        # from the cache
+        s.send(b'timeout 10000', 0)
+
+        data = self.forwarded_query(name)
+        self.assert_dns_rcode_equals(data, dns.DNS_RCODE_OK)
+        self.assertEqual('forwarder1', data.answers[0].rdata)
+        self.assertGreater(data.answers[0].ttl, 0)
+        self.assertLessEqual(data.answers[0].ttl, 300)
+
+    def test_cached_negative_answer(self):
+        s = self.start_toy_server(dns_servers[0], 53, 'forwarder1')
+        s.send(b'ttl 300', 0)
+        name = "nxdomain.cached-%08x.dsfsdfs" % random.randint(0, 0xffffffff)
+
+        data = self.forwarded_query(name)
+        self.assertEqual(data.ancount, 0)
+        self.assertEqual(data.nscount, 1)
+        self.assertEqual(data.nsrecs[0].rr_type, dns.DNS_QTYPE_SOA)
+
+        s.send(b'timeout 10000', 0)
+
+        data = self.forwarded_query(name)
+        self.assertEqual(data.ancount, 0)
+        self.assertEqual(data.nscount, 1)
+        self.assertEqual(data.nsrecs[0].rr_type, dns.DNS_QTYPE_SOA)
+        self.assertLessEqual(data.nsrecs[0].ttl, 300)
+
+    def test_zero_ttl_not_cached(self):
+        s = self.start_toy_server(dns_servers[0], 53, 'forwarder1')
+        name = "uncached-%08x.dsfsdfs" % random.randint(0, 0xffffffff)
+
+        data = self.forwarded_query(name)
+        self.assert_dns_rcode_equals(data, dns.DNS_RCODE_OK)
+        self.assertEqual('forwarder1', data.answers[0].rdata)
+
+        s.send(b'timeout 10000', 0)
+
+        data = self.forwarded_query(name)
+        self.assert_dns_rcode_equals(data, dns.DNS_RCODE_SERVFAIL)
+
 
 TestProgram(module=__name__, opts=subunitopts)
@@ -37,19 +37,44 @@ def debug(msg):
 
 
 timeout = 0
+# A TTL of 0 keeps the DNS server from caching our answers
+ttl = 0
 
 
 def answer_question(data, question):
+    if question.name.startswith('nxdomain.'):
+        return None
+
     r = dns.res_rec()
     r.name = question.name
     r.rr_type = dns.DNS_QTYPE_CNAME
     r.rr_class = dns.DNS_QCLASS_IN
-    r.ttl = 900
+    r.ttl = ttl
     r.length = 0xffff
     r.rdata = SERVER_ID
     return r
 
 
+def authority_soa(question):
+    soa = dns.soa_record()
+    soa.mname = 'ns.' + SERVER_ID
+    soa.rname = 'hostmaster.' + SERVER_ID
+    soa.serial = 1
+    soa.refresh = 900
+    soa.retry = 600
+    soa.expire = 86400
+    soa.minimum = ttl
+
+    r = dns.res_rec()
+    r.name = question.name.split('.', 1)[1]
+    r.rr_type = dns.DNS_QTYPE_SOA
+    r.rr_class = dns.DNS_QCLASS_IN
+    r.ttl = ttl
+    r.length = 0xffff
+    r.rdata = soa
+    return r
+
+
 class DnsHandler(SocketServer.BaseRequestHandler):
     def make_answer(self, data):
         data = ndr.ndr_unpack(dns.name_packet, data)
@@ -63,6 +88,10 @@ class DnsHandler(SocketServer.BaseRequestHandler):
             data.ancount += 1
             debug('the answer was: ')
             debug(data.__ndr_print__())
+        else:
+            data.nsrecs = [authority_soa(data.questions[0])]
+            data.nscount = 1
+            data.operation |= dns.DNS_RCODE_NXDOMAIN
 
         data.operation |= dns.DNS_FLAG_REPLY
 
@@ -83,6 +112,13 @@ class DnsHandler(SocketServer.BaseRequestHandler):
             debug("timing out at %s" % timeout)
             return
 
+        global ttl
+        m = re.match(br'^ttl\s+(\d+)$', data.strip())
+        if m:
+            ttl = int(m.group(1))
+            debug("answering with TTL %s" % ttl)
+            return
+
         t = Timer(timeout, self.really_handle, [data, socket])
         t.start()
 
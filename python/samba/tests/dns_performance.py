@@ -0,0 +1,95 @@
+# Unix SMB/CIFS implementation.
+#
+# Query throughput of the internal DNS server
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""Measure how many queries per second the DNS server answers.
+
+The same names are asked for repeatedly, the way domain members keep
+re-resolving the DC records. Run it before and after a change to the
+query path and compare the printed rates.
+"""
+
+import optparse
+import sys
+import time
+
+import samba.getopt as options
+from samba.dcerpc import dns
+from samba.tests.subunitrun import SubunitOptions, TestProgram
+from samba.tests.dns_base import DNSTest
+
+parser = optparse.OptionParser(
+    "dns_performance.py <server name> <server ip> [options]")
+sambaopts = options.SambaOptions(parser)
+parser.add_option_group(sambaopts)
+parser.add_option("--queries", type="int", dest="queries", default=5000,
+                  help="Number of queries per test")
+
+credopts = options.CredentialsOptions(parser)
+parser.add_option_group(credopts)
+subunitopts = SubunitOptions(parser)
+parser.add_option_group(subunitopts)
+
+opts, args = parser.parse_args()
+
+lp = sambaopts.get_loadparm()
+creds = credopts.get_credentials(lp)
+
+if len(args) < 2:
+    parser.print_usage()
+    sys.exit(1)
+
+server_name = args[0]
+server_ip = args[1]
+
+
+class DNSQueryPerformance(DNSTest):
+    def setUp(self):
+        super().setUp()
+        self.server = server_name
+        self.server_ip = server_ip
+        self.lp = lp
+        self.creds = creds
+        self.timeout = 5
+
+    def run_queries(self, name, qtype, rcode):
+        n = opts.queries
+        start = time.time()
+        for i in range(n):
+            p = self.make_name_packet(dns.DNS_OPCODE_QUERY)
+            q = self.make_name_question(name, qtype, dns.DNS_QCLASS_IN)
+            self.finish_name_packet(p, [q])
+            (response, _) = self.dns_transaction_udp(p, host=self.server_ip)
+            self.assert_dns_rcode_equals(response, rcode)
+        elapsed = time.time() - start
+        print("%s: %d queries in %.2fs, %.0f queries/s" %
+              (name, n, elapsed, n / elapsed))
+
+    def test_a_query(self):
+        name = "%s.%s" % (self.server, self.get_dns_domain())
+        self.run_queries(name, dns.DNS_QTYPE_A, dns.DNS_RCODE_OK)
+
+    def test_srv_query(self):
+        name = "_ldap._tcp.%s" % self.get_dns_domain()
+        self.run_queries(name, dns.DNS_QTYPE_SRV, dns.DNS_RCODE_OK)
+
+    def test_missing_name_query(self):
+        name = "no-such-host.%s" % self.get_dns_domain()
+        self.run_queries(name, dns.DNS_QTYPE_A, dns.DNS_RCODE_NXDOMAIN)
+
+
+TestProgram(module=__name__, opts=subunitopts)
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+# Unix SMB/CIFS implementation.
+#
+# TGS-REQ throughput of the KDC
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""Measure how many TGS-REQs per second the KDC answers.
+
+A single TGT is used to ask for service tickets over and over, the way
+clients do at the start of a working day. Run it before and after a
+change to the KDC backend and compare the printed rates. The number of
+requests per test can be set with TGS_REQUESTS.
+
+test_as_nested_groups instead asks for TGTs for a user in a chain of
+nested groups, which is dominated by building the PAC.
+
+test_mixed_concurrent keeps KDC_CLIENTS (default 8) clients busy with
+AS-REQs and TGS-REQs at the same time, to see how the KDC scales over
+its pre-fork workers. Set "kdc:stats interval" to see how the requests
+were spread over the workers.
+"""
+
+import sys
+import os
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+sys.path.insert(0, "bin/python")
+os.environ["PYTHONUNBUFFERED"] = "1"
+
+import ldb
+
+import samba.tests
+from samba.tests.krb5.kdc_base_test import KDCBaseTest
+
+global_asn1_print = False
+global_hexdump = False
+
+
+class TgsPerformanceTests(KDCBaseTest):
+
+    def setUp(self):
+        super().setUp()
+        self.do_asn1_print = global_asn1_print
+        self.do_hexdump = global_hexdump
+
+    def _run_tgs_requests(self, target_creds):
+        n = int(samba.tests.env_get_var_value('TGS_REQUESTS',
+                                              allow_missing=True) or 1000)
+
+        client_creds = self.get_client_creds()
+        tgt = self.get_tgt(client_creds)
+
+        start = time.time()
+        for i in range(n):
+            self.get_service_ticket(tgt, target_creds, fresh=True)
+        elapsed = time.time() - start
+
+        print("%s: %d TGS-REQs in %.2fs, %.0f requests/s" %
+              (target_creds.get_username(), n, elapsed, n / elapsed))
+
+    def test_tgs_service(self):
+        self._run_tgs_requests(self.get_service_creds())
+
+    def test_tgs_machine(self):
+        self._run_tgs_requests(self.get_mach_creds())
+
+    def test_as_nested_groups(self):
+        n = int(samba.tests.env_get_var_value('TGS_REQUESTS',
+                                              allow_missing=True) or 1000)
+        depth = 20
+
+        samdb = self.get_samdb()
+
+        # Build a chain of groups, each a member of the next one.
+        groups = [self.create_group(samdb, self.get_new_username())
+                  for _ in range(depth)]
+        for child, parent in zip(groups, groups[1:]):
+            self.add_to_group(child, ldb.Dn(samdb, parent), 'member',
+                              expect_attr=False)
+
+        client_creds = self.get_cached_creds(
+            account_type=self.AccountType.USER,
+            opts={'member_of': (groups[0],)},
+            use_cache=False)
+
+        start = time.time()
+        for i in range(n):
+            self.get_tgt(client_creds, fresh=True)
+        elapsed = time.time() - start
+
+        print("%s: %d AS-REQs in %.2fs, %.0f requests/s" %
+              (client_creds.get_username(), n, elapsed, n / elapsed))
+
+    def test_mixed_concurrent(self):
+        n = int(samba.tests.env_get_var_value('TGS_REQUESTS',
+                                              allow_missing=True) or 1000)
+        clients = int(samba.tests.env_get_var_value('KDC_CLIENTS',
+                                                    allow_missing=True) or 8)
+
+        client_creds = self.get_client_creds()
+        service_creds = self.get_service_creds()
+
+        # Fetch the credentials (and with them the keys) up front, so
+        # the clients only talk to the KDC.
+        self.get_krbtgt_creds()
+
+        def run_client(count):
+            for i in range(count):
+                tgt = self.get_tgt(client_creds, fresh=True)
+                self.get_service_ticket(tgt, service_creds, fresh=True)
+
+        per_client = max(1, n // clients)
+
+        start = time.time()
+        with ThreadPoolExecutor(max_workers=clients) as executor:
+            futures = [executor.submit(run_client, per_client)
+                       for _ in range(clients)]
+            for future in futures:
+                future.result()
+        elapsed = time.time() - start
+
+        total = 2 * per_client * clients
+        print("%d clients: %d AS-REQs and TGS-REQs in %.2fs, "
+              "%.0f requests/s" %
+              (clients, total, elapsed, total / elapsed))
+
+
+if __name__ == "__main__":
+    global_asn1_print = False
+    global_hexdump = False
+    import unittest
+    unittest.main()
@@ -0,0 +1,143 @@
+# Unix SMB/CIFS implementation.
+#
+# NTLM logon throughput of netr_LogonSamLogonEx
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""Measure how many NTLM logons per second netr_LogonSamLogonEx handles.
+
+A member server passing through the NTLM logons of a legacy
+application asks for the same few users over and over on one schannel
+connection. Run it before and after a change to the NTLM logon path
+and compare the printed rates. The number of logons per test can be
+set with SAMLOGON_REQUESTS.
+"""
+
+import os
+import time
+
+import samba
+from samba.auth import system_session
+from samba.credentials import (
+    Credentials,
+    CLI_CRED_NTLM_AUTH,
+    DONT_USE_KERBEROS)
+from samba.dcerpc import netlogon
+from samba.dcerpc.misc import SEC_CHAN_WKSTA
+from samba.dsdb import (
+    UF_WORKSTATION_TRUST_ACCOUNT,
+    UF_PASSWD_NOTREQD,
+    UF_NORMAL_ACCOUNT)
+from samba.samdb import SamDB
+from samba.common import get_string
+from samba.tests import TestCase, delete_force
+from samba.tests.py_credentials import samlogon_logon_info
+
+MACHINE_NAME = "SLPM"
+USER_NAME = "SLPU"
+
+
+class SamLogonPerformanceTests(TestCase):
+
+    def setUp(self):
+        super().setUp()
+
+        self.server = os.environ["SERVER"]
+        self.domain = os.environ["DOMAIN"]
+        self.host = os.environ["SERVER_IP"]
+        self.lp = self.get_loadparm()
+        self.n = int(os.environ.get("SAMLOGON_REQUESTS", "1000"))
+
+        self.ldb = SamDB(url="ldap://%s" % self.host,
+                         session_info=system_session(),
+                         credentials=self.get_credentials(),
+                         lp=self.lp)
+
+        self.machine_dn = "cn=%s,%s" % (MACHINE_NAME, self.ldb.domain_dn())
+        self.user_dn = "cn=%s,%s" % (USER_NAME, self.ldb.domain_dn())
+
+        self.machine_creds = self.create_account(
+            self.machine_dn,
+            "%s$" % MACHINE_NAME,
+            UF_WORKSTATION_TRUST_ACCOUNT | UF_PASSWD_NOTREQD,
+            "computer")
+        self.machine_creds.set_secure_channel_type(SEC_CHAN_WKSTA)
+
+        self.user_creds = self.create_account(self.user_dn,
+                                              USER_NAME,
+                                              UF_NORMAL_ACCOUNT,
+                                              "user")
+
+    def tearDown(self):
+        super().tearDown()
+        delete_force(self.ldb, self.machine_dn)
+        delete_force(self.ldb, self.user_dn)
+
+    def create_account(self, dn, account_name, uac, objectclass):
+        password = samba.generate_random_password(32, 32)
+
+        # remove the account if it exists, this will happen if a
+        # previous test run failed
+        delete_force(self.ldb, dn)
+
+        utf16pw = ('"%s"' % get_string(password)).encode('utf-16-le')
+        self.ldb.add({
+            "dn": dn,
+            "objectclass": objectclass,
+            "sAMAccountName": account_name,
+            "userAccountControl": str(uac),
+            "unicodePwd": utf16pw})
+
+        creds = Credentials()
+        creds.guess(self.lp)
+        creds.set_kerberos_state(DONT_USE_KERBEROS)
+        creds.set_password(password)
+        creds.set_username(account_name)
+        creds.set_workstation(MACHINE_NAME)
+        return creds
+
+    def run_logons(self, name, flags=None):
+        c = netlogon.netlogon("ncacn_ip_tcp:%s[schannel,seal]" % self.server,
+                              self.lp,
+                              self.machine_creds)
+
+        if flags is None:
+            logon = samlogon_logon_info(self.domain,
+                                        MACHINE_NAME,
+                                        self.user_creds)
+        else:
+            logon = samlogon_logon_info(self.domain,
+                                        MACHINE_NAME,
+                                        self.user_creds,
+                                        flags=flags)
+
+        start = time.time()
+        for i in range(self.n):
+            c.netr_LogonSamLogonEx(self.server,
+                                   self.user_creds.get_workstation(),
+                                   netlogon.NetlogonNetworkTransitiveInformation,
+                                   logon,
+                                   netlogon.NetlogonValidationSamInfo4,
+                                   0)
+        elapsed = time.time() - start
+
+        print("%s: %d logons in %.2fs, %.0f logons/s" %
+              (name, self.n, elapsed, self.n / elapsed))
+
+    def test_ntlmv2(self):
+        self.run_logons("NTLMv2")
+
+    def test_ntlm(self):
+        self.run_logons("NTLM", flags=CLI_CRED_NTLM_AUTH)
@@ -13,7 +13,7 @@
 # comments.
 
 import os
-from selftesthelpers import source4dir, bindir, python, plantestsuite_loadlist
+from selftesthelpers import source4dir, srcdir, bindir, python, plantestsuite_loadlist
 
 samba4srcdir = source4dir()
 samba4bindir = bindir()
@@ -80,6 +80,24 @@ plantestsuite_loadlist("samba4.ldap.vlv.python(ad_dc_ntvfs)", "ad_dc_ntvfs",
                         '$SERVER', '-U"$USERNAME%$PASSWORD"',
                         '--workgroup=$DOMAIN', '$LOADLIST', '$LISTOPT'])
 
+plantestsuite_loadlist("samba4.drs_apply_performance.python(ad_dc_ntvfs)",
+                       "ad_dc_ntvfs",
+                       [python,
+                        os.path.join(samba4srcdir,
+                                     "dsdb/tests/python/drs_apply_performance.py"),
+                        '$SERVER', '-U"$USERNAME%$PASSWORD"',
+                        '--workgroup=$DOMAIN', '--realm=$REALM',
+                        '$LOADLIST', '$LISTOPT'])
+
+plantestsuite_loadlist("samba4.large_group_performance.python(ad_dc_ntvfs)",
+                       "ad_dc_ntvfs",
+                       [python,
+                        os.path.join(samba4srcdir,
+                                     "dsdb/tests/python/large_group_performance.py"),
+                        '$SERVER', '-U"$USERNAME%$PASSWORD"',
+                        '--workgroup=$DOMAIN',
+                        '$LOADLIST', '$LISTOPT'])
+
 # this one doesn't tidy itself up fully, so leave it as last unless
 # you want a messy database.
 plantestsuite_loadlist("samba4.ldap.ad_dc_medley_performance.python(ad_dc_ntvfs)",
@@ -102,3 +120,32 @@ plantestsuite_loadlist("samba4.ldap.ad_dc_performance.paged_search."+\
                         '--workgroup=$DOMAIN',
                         '--use-paged-search',
                         '$LOADLIST', '$LISTOPT'])
+
+plantestsuite_loadlist("samba.tests.dns_performance.python(ad_dc_ntvfs)",
+                       "ad_dc_ntvfs:local",
+                       [python,
+                        os.path.join(srcdir(),
+                                     "python/samba/tests/dns_performance.py"),
+                        '$SERVER', '$SERVER_IP',
+                        '-U"$USERNAME%$PASSWORD"',
+                        '--workgroup=$DOMAIN',
+                        '$LOADLIST', '$LISTOPT'])
+
+plantestsuite_loadlist("samba.tests.krb5.tgs_performance.python(ad_dc_ntvfs)",
+                       "ad_dc_ntvfs",
+                       ['SERVICE_USERNAME="$SERVER"',
+                        'ADMIN_USERNAME="$DC_USERNAME"',
+                        'ADMIN_PASSWORD="$DC_PASSWORD"',
+                        'STRICT_CHECKING=0',
+                        python,
+                        os.path.join(samba4srcdir, "scripting/bin/subunitrun"),
+                        '$LISTOPT', '$LOADLIST',
+                        'samba.tests.krb5.tgs_performance'])
+
+plantestsuite_loadlist("samba.tests.samlogon_performance.python(ad_dc_ntvfs)",
+                       "ad_dc_ntvfs",
+                       [python,
+                        os.path.join(samba4srcdir, "scripting/bin/subunitrun"),
+                        '$LISTOPT', '$LOADLIST',
+                        'samba.tests.samlogon_performance',
+                        '-U"$USERNAME%$PASSWORD"'])
@@ -997,6 +997,18 @@ plantestsuite("samba3.test_nfs4_acl", "none",
               [os.path.join(bindir(), "test_nfs4_acls"),
                "$SMB_CONF_PATH"])
 
+plantestsuite("samba3.test_wb_getpwsid", "none",
+              [os.path.join(bindir(), "test_wb_getpwsid"),
+               "$SMB_CONF_PATH"])
+
+plantestsuite("samba3.test_wb_gettoken", "none",
+              [os.path.join(bindir(), "test_wb_gettoken"),
+               "$SMB_CONF_PATH"])
+
+plantestsuite("samba3.test_wb_sids2xids", "none",
+              [os.path.join(bindir(), "test_wb_sids2xids"),
+               "$SMB_CONF_PATH"])
+
 plantestsuite("samba3.test_vfs_full_audit", "none",
               [os.path.join(bindir(), "test_vfs_full_audit"),
                "$SMB_CONF_PATH"])
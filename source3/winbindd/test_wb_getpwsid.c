@@ -0,0 +1,191 @@
+/*
+ *  Unix SMB/CIFS implementation.
+ *
+ *  Unit test for the winbindd passwd cache
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "wb_getpwsid.c"
+#include <cmocka.h>
+#include "test_wb_stubs.h"
+
+#define TEST_USER_SID TEST_WB_DOMAIN_SID "-1105"
+
+/*
+ * Stubs for the parts of winbindd that wb_getpwsid.c calls, besides
+ * the ones in test_wb_stubs.c.  The user lookup there completes
+ * immediately and counts how often it was asked, which tells whether
+ * a getpwsid was served from the cache.
+ */
+
+NTSTATUS normalize_name_map(TALLOC_CTX *mem_ctx,
+			    const char *domain_name,
+			    const char *name,
+			    char **normalized)
+{
+	return NT_STATUS_NONE_MAPPED;
+}
+
+char *fill_domain_username_talloc(TALLOC_CTX *ctx,
+				  const char *domain,
+				  const char *user,
+				  bool can_assume)
+{
+	return talloc_asprintf(ctx, "%s\\%s", domain, user);
+}
+
+static NTSTATUS getpwsid(struct winbindd_pw *pw)
+{
+	TALLOC_CTX *frame = talloc_stackframe();
+	struct tevent_context *ev;
+	struct tevent_req *req;
+	struct dom_sid sid;
+	NTSTATUS status;
+	bool ok;
+
+	ok = dom_sid_parse(TEST_USER_SID, &sid);
+	assert_true(ok);
+
+	ev = samba_tevent_context_init(frame);
+	assert_non_null(ev);
+
+	ZERO_STRUCTP(pw);
+	req = wb_getpwsid_send(frame, ev, &sid, pw);
+	assert_non_null(req);
+
+	ok = tevent_req_poll(req, ev);
+	assert_true(ok);
+
+	status = wb_getpwsid_recv(req);
+	TALLOC_FREE(frame);
+	return status;
+}
+
+static int setup(void **state)
+{
+	test_wb_stubs_setup();
+	wb_getpwsid_flush_cache();
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	wb_getpwsid_flush_cache();
+	return 0;
+}
+
+static void test_cache_hit(void **state)
+{
+	struct winbindd_pw pw1, pw2;
+	NTSTATUS status;
+
+	status = getpwsid(&pw1);
+	assert_true(NT_STATUS_IS_OK(status));
+	assert_int_equal(test_wb_queryuser_calls, 1);
+	assert_string_equal(pw1.pw_name, "SAMBADOMAIN\\user1");
+	assert_string_equal(pw1.pw_dir, "/home/user1");
+	assert_int_equal(pw1.pw_uid, 3000001);
+
+	/* the second lookup must not ask the child again */
+	status = getpwsid(&pw2);
+	assert_true(NT_STATUS_IS_OK(status));
+	assert_int_equal(test_wb_queryuser_calls, 1);
+	assert_memory_equal(&pw1, &pw2, sizeof(pw1));
+}
+
+static void test_flush(void **state)
+{
+	struct winbindd_pw pw;
+	NTSTATUS status;
+
+	status = getpwsid(&pw);
+	assert_true(NT_STATUS_IS_OK(status));
+	assert_int_equal(test_wb_queryuser_calls, 1);
+
+	wb_getpwsid_flush_cache();
+
+	status = getpwsid(&pw);
+	assert_true(NT_STATUS_IS_OK(status));
+	assert_int_equal(test_wb_queryuser_calls, 2);
+	assert_int_equal(pw.pw_uid, 3000002);
+}
+
+static void test_cache_time_zero(void **state)
+{
+	struct winbindd_pw pw;
+	NTSTATUS status;
+
+	lp_do_parameter(-1, "winbind cache time", "0");
+
+	status = getpwsid(&pw);
+	assert_true(NT_STATUS_IS_OK(status));
+	status = getpwsid(&pw);
+	assert_true(NT_STATUS_IS_OK(status));
+	assert_int_equal(test_wb_queryuser_calls, 2);
+}
+
+static void test_cache_disabled(void **state)
+{
+	struct winbindd_pw pw;
+	NTSTATUS status;
+
+	test_wb_use_cache = false;
+
+	status = getpwsid(&pw);
+	assert_true(NT_STATUS_IS_OK(status));
+	status = getpwsid(&pw);
+	assert_true(NT_STATUS_IS_OK(status));
+	assert_int_equal(test_wb_queryuser_calls, 2);
+}
+
+static void test_failure_not_cached(void **state)
+{
+	struct winbindd_pw pw;
+	NTSTATUS status;
+
+	test_wb_queryuser_status = NT_STATUS_NO_SUCH_USER;
+
+	status = getpwsid(&pw);
+	assert_true(NT_STATUS_EQUAL(status, NT_STATUS_NO_SUCH_USER));
+	assert_int_equal(test_wb_queryuser_calls, 1);
+
+	test_wb_queryuser_status = NT_STATUS_OK;
+
+	status = getpwsid(&pw);
+	assert_true(NT_STATUS_IS_OK(status));
+	assert_int_equal(test_wb_queryuser_calls, 2);
+}
+
+int main(int argc, char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(test_cache_hit,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_flush,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_cache_time_zero,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_cache_disabled,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_failure_not_cached,
+						setup, teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_SUBUNIT);
+
+	test_wb_stubs_init(argc, argv);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,492 @@
+/*
+ *  Unix SMB/CIFS implementation.
+ *
+ *  Unit test for the winbindd token cache
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "wb_gettoken.c"
+#include <cmocka.h>
+#include "test_wb_stubs.h"
+
+#define TEST_SAM_SID "S-1-5-21-4444444444-5555555555-6666666666"
+
+#define TEST_USER_RID 1105
+#define TEST_MAX_GROUPS 4
+#define TEST_MAX_ALIASES 4
+
+/*
+ * Stubs for the parts of winbindd that wb_gettoken.c calls, besides
+ * the ones in test_wb_stubs.c.  All child requests complete
+ * immediately.  The sequence numbers of the user's domain, our SAM
+ * and BUILTIN, the user's groups and aliases are set by the tests,
+ * and the number of calls tells whether a token was built or came
+ * from the cache.
+ */
+
+struct test_alias_domain {
+	struct winbindd_domain domain;
+	uint32_t alias_rids[TEST_MAX_ALIASES];
+	uint32_t num_aliases;
+};
+
+static struct dom_sid test_sam_sid;
+static struct winbindd_domain test_domain;
+static struct test_alias_domain test_sam;
+static struct test_alias_domain test_builtin;
+
+static NTSTATUS seqnum_status;
+static unsigned seqnum_calls;
+static uint32_t test_group_rids[TEST_MAX_GROUPS];
+static uint32_t num_test_groups;
+
+struct winbindd_domain *find_domain_from_sid_noinit(const struct dom_sid *sid)
+{
+	if (dom_sid_equal(sid, &test_sam_sid)) {
+		return &test_sam.domain;
+	}
+	if (dom_sid_equal(sid, &global_sid_Builtin)) {
+		return &test_builtin.domain;
+	}
+	return &test_domain;
+}
+
+struct winbindd_domain *find_domain_from_sid(const struct dom_sid *sid)
+{
+	return find_domain_from_sid_noinit(sid);
+}
+
+struct dom_sid *get_global_sam_sid(void)
+{
+	return &test_sam_sid;
+}
+
+struct seqnum_stub_state {
+	uint32_t seqnum;
+};
+
+struct tevent_req *wb_seqnum_send(TALLOC_CTX *mem_ctx,
+				  struct tevent_context *ev,
+				  struct winbindd_domain *domain)
+{
+	struct tevent_req *req;
+	struct seqnum_stub_state *state;
+
+	seqnum_calls += 1;
+
+	req = tevent_req_create(mem_ctx, &state, struct seqnum_stub_state);
+	if (req == NULL) {
+		return NULL;
+	}
+	if (tevent_req_nterror(req, seqnum_status)) {
+		return tevent_req_post(req, ev);
+	}
+	state->seqnum = domain->sequence_number;
+	tevent_req_done(req);
+	return tevent_req_post(req, ev);
+}
+
+NTSTATUS wb_seqnum_recv(struct tevent_req *req, uint32_t *seqnum)
+{
+	struct seqnum_stub_state *state = tevent_req_data(
+		req, struct seqnum_stub_state);
+	NTSTATUS status;
+
+	if (tevent_req_is_nterror(req, &status)) {
+		return status;
+	}
+	*seqnum = state->seqnum;
+	return NT_STATUS_OK;
+}
+
+struct lookupusergroups_stub_state {
+	uint32_t num_sids;
+	struct dom_sid *sids;
+};
+
+struct tevent_req *wb_lookupusergroups_send(TALLOC_CTX *mem_ctx,
+					    struct tevent_context *ev,
+					    const struct dom_sid *sid)
+{
+	struct tevent_req *req;
+	struct lookupusergroups_stub_state *state;
+	uint32_t i;
+
+	req = tevent_req_create(mem_ctx, &state,
+				struct lookupusergroups_stub_state);
+	if (req == NULL) {
+		return NULL;
+	}
+	state->sids = talloc_array(state, struct dom_sid, num_test_groups);
+	if (tevent_req_nomem(state->sids, req)) {
+		return tevent_req_post(req, ev);
+	}
+	for (i = 0; i < num_test_groups; i++) {
+		sid_compose(&state->sids[i],
+			    &test_wb_domain_sid,
+			    test_group_rids[i]);
+	}
+	state->num_sids = num_test_groups;
+	tevent_req_done(req);
+	return tevent_req_post(req, ev);
+}
+
+NTSTATUS wb_lookupusergroups_recv(struct tevent_req *req, TALLOC_CTX *mem_ctx,
+				  uint32_t *num_sids, struct dom_sid **sids)
+{
+	struct lookupusergroups_stub_state *state = tevent_req_data(
+		req, struct lookupusergroups_stub_state);
+	NTSTATUS status;
+
+	if (tevent_req_is_nterror(req, &status)) {
+		return status;
+	}
+	*num_sids = state->num_sids;
+	*sids = talloc_move(mem_ctx, &state->sids);
+	return NT_STATUS_OK;
+}
+
+struct lookupuseraliases_stub_state {
+	uint32_t num_aliases;
+	uint32_t *aliases;
+};
+
+struct tevent_req *wb_lookupuseraliases_send(TALLOC_CTX *mem_ctx,
+					     struct tevent_context *ev,
+					     struct winbindd_domain *domain,
+					     uint32_t num_sids,
+					     const struct dom_sid *sids)
+{
+	struct test_alias_domain *d = NULL;
+	struct tevent_req *req;
+	struct lookupuseraliases_stub_state *state;
+
+	if (domain == &test_sam.domain) {
+		d = &test_sam;
+	} else {
+		assert_ptr_equal(domain, &test_builtin.domain);
+		d = &test_builtin;
+	}
+
+	req = tevent_req_create(mem_ctx, &state,
+				struct lookupuseraliases_stub_state);
+	if (req == NULL) {
+		return NULL;
+	}
+	state->aliases = talloc_memdup(state,
+				       d->alias_rids,
+				       sizeof(d->alias_rids));
+	if (tevent_req_nomem(state->aliases, req)) {
+		return tevent_req_post(req, ev);
+	}
+	state->num_aliases = d->num_aliases;
+	tevent_req_done(req);
+	return tevent_req_post(req, ev);
+}
+
+NTSTATUS wb_lookupuseraliases_recv(struct tevent_req *req, TALLOC_CTX *mem_ctx,
+				   uint32_t *num_aliases, uint32_t **aliases)
+{
+	struct lookupuseraliases_stub_state *state = tevent_req_data(
+		req, struct lookupuseraliases_stub_state);
+	NTSTATUS status;
+
+	if (tevent_req_is_nterror(req, &status)) {
+		return status;
+	}
+	*num_aliases = state->num_aliases;
+	*aliases = talloc_move(mem_ctx, &state->aliases);
+	return NT_STATUS_OK;
+}
+
+static uint32_t gettoken(TALLOC_CTX *mem_ctx,
+			 bool expand_local_aliases,
+			 struct dom_sid **psids)
+{
+	struct tevent_context *ev;
+	struct tevent_req *req;
+	struct dom_sid user_sid;
+	uint32_t num_sids = 0;
+	NTSTATUS status;
+	bool ok;
+
+	sid_compose(&user_sid, &test_wb_domain_sid, TEST_USER_RID);
+
+	ev = samba_tevent_context_init(mem_ctx);
+	assert_non_null(ev);
+
+	req = wb_gettoken_send(mem_ctx, ev, &user_sid, expand_local_aliases);
+	assert_non_null(req);
+
+	ok = tevent_req_poll(req, ev);
+	assert_true(ok);
+
+	status = wb_gettoken_recv(req, mem_ctx, &num_sids, psids);
+	assert_true(NT_STATUS_IS_OK(status));
+	TALLOC_FREE(req);
+	TALLOC_FREE(ev);
+
+	return num_sids;
+}
+
+static bool token_has_sid(uint32_t num_sids,
+			  const struct dom_sid *sids,
+			  const struct dom_sid *domain_sid,
+			  uint32_t rid)
+{
+	struct dom_sid sid;
+	uint32_t i;
+
+	sid_compose(&sid, domain_sid, rid);
+
+	for (i = 0; i < num_sids; i++) {
+		if (dom_sid_equal(&sids[i], &sid)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool token_has_rid(uint32_t num_sids,
+			  const struct dom_sid *sids,
+			  uint32_t rid)
+{
+	return token_has_sid(num_sids, sids, &test_wb_domain_sid, rid);
+}
+
+static void setup_domain(struct winbindd_domain *domain,
+			 const char *name,
+			 const struct dom_sid *sid)
+{
+	ZERO_STRUCTP(domain);
+	domain->name = discard_const_p(char, name);
+	sid_copy(&domain->sid, sid);
+	domain->sequence_number = 1;
+}
+
+static int setup(void **state)
+{
+	bool ok;
+
+	test_wb_stubs_setup();
+
+	ok = dom_sid_parse(TEST_SAM_SID, &test_sam_sid);
+	assert_true(ok);
+
+	setup_domain(&test_domain, "TESTDOM", &test_wb_domain_sid);
+	setup_domain(&test_sam.domain, "LOCALSAM", &test_sam_sid);
+	setup_domain(&test_builtin.domain, "BUILTIN", &global_sid_Builtin);
+	test_sam.num_aliases = 0;
+	test_builtin.alias_rids[0] = 545;
+	test_builtin.num_aliases = 1;
+
+	seqnum_status = NT_STATUS_OK;
+	seqnum_calls = 0;
+	test_group_rids[0] = TEST_WB_PRIMARY_GROUP_RID;
+	test_group_rids[1] = 1200;
+	num_test_groups = 2;
+
+	wb_gettoken_flush_cache();
+
+	*state = talloc_new(NULL);
+	assert_non_null(*state);
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	wb_gettoken_flush_cache();
+	TALLOC_FREE(*state);
+	return 0;
+}
+
+static void test_cache_hit(void **state)
+{
+	TALLOC_CTX *mem_ctx = *state;
+	struct dom_sid *sids1 = NULL, *sids2 = NULL;
+	uint32_t num_sids1, num_sids2;
+
+	num_sids1 = gettoken(mem_ctx, false, &sids1);
+	assert_int_equal(num_sids1, 3);
+	assert_true(token_has_rid(num_sids1, sids1, TEST_USER_RID));
+	assert_true(token_has_rid(num_sids1, sids1,
+				  TEST_WB_PRIMARY_GROUP_RID));
+	assert_true(token_has_rid(num_sids1, sids1, 1200));
+	assert_int_equal(test_wb_queryuser_calls, 1);
+
+	/*
+	 * The second lookup only checks the sequence number and
+	 * does not build the token again.
+	 */
+	num_sids2 = gettoken(mem_ctx, false, &sids2);
+	assert_int_equal(num_sids2, num_sids1);
+	assert_memory_equal(sids1, sids2, num_sids1 * sizeof(*sids1));
+	assert_int_equal(test_wb_queryuser_calls, 1);
+	assert_int_equal(seqnum_calls, 2);
+}
+
+static void test_seqnum_change(void **state)
+{
+	TALLOC_CTX *mem_ctx = *state;
+	struct dom_sid *sids = NULL;
+	uint32_t num_sids;
+
+	num_sids = gettoken(mem_ctx, false, &sids);
+	assert_int_equal(num_sids, 3);
+	assert_int_equal(test_wb_queryuser_calls, 1);
+
+	/*
+	 * The user is added to a group, which changes the sequence
+	 * number of the domain: the cached token must not be used.
+	 */
+	test_group_rids[num_test_groups++] = 1201;
+	test_domain.sequence_number += 1;
+
+	num_sids = gettoken(mem_ctx, false, &sids);
+	assert_int_equal(num_sids, 4);
+	assert_true(token_has_rid(num_sids, sids, 1201));
+	assert_int_equal(test_wb_queryuser_calls, 2);
+
+	/* the rebuilt token is cached for the new sequence number */
+	num_sids = gettoken(mem_ctx, false, &sids);
+	assert_int_equal(num_sids, 4);
+	assert_int_equal(test_wb_queryuser_calls, 2);
+}
+
+/*
+ * With local aliases expanded the token also depends on our SAM and
+ * BUILTIN, a change there must not be hidden by the cache.
+ */
+static void test_local_alias_change(void **state)
+{
+	TALLOC_CTX *mem_ctx = *state;
+	struct dom_sid *sids = NULL;
+	uint32_t num_sids;
+
+	num_sids = gettoken(mem_ctx, true, &sids);
+	assert_int_equal(num_sids, 4);
+	assert_true(token_has_sid(num_sids, sids, &global_sid_Builtin, 545));
+	assert_int_equal(test_wb_queryuser_calls, 1);
+	assert_int_equal(seqnum_calls, 3);
+
+	num_sids = gettoken(mem_ctx, true, &sids);
+	assert_int_equal(num_sids, 4);
+	assert_int_equal(test_wb_queryuser_calls, 1);
+	assert_int_equal(seqnum_calls, 6);
+
+	/* the user is added to a local alias */
+	test_sam.alias_rids[test_sam.num_aliases++] = 1000;
+	test_sam.domain.sequence_number += 1;
+
+	num_sids = gettoken(mem_ctx, true, &sids);
+	assert_int_equal(num_sids, 5);
+	assert_true(token_has_sid(num_sids, sids, &test_sam_sid, 1000));
+	assert_int_equal(test_wb_queryuser_calls, 2);
+
+	/* and to a builtin one */
+	test_builtin.alias_rids[test_builtin.num_aliases++] = 544;
+	test_builtin.domain.sequence_number += 1;
+
+	num_sids = gettoken(mem_ctx, true, &sids);
+	assert_int_equal(num_sids, 6);
+	assert_true(token_has_sid(num_sids, sids, &global_sid_Builtin, 544));
+	assert_int_equal(test_wb_queryuser_calls, 3);
+
+	/* the token without local aliases is cached separately */
+	num_sids = gettoken(mem_ctx, false, &sids);
+	assert_int_equal(num_sids, 3);
+	assert_int_equal(test_wb_queryuser_calls, 4);
+}
+
+static void test_flush(void **state)
+{
+	TALLOC_CTX *mem_ctx = *state;
+	struct dom_sid *sids = NULL;
+	uint32_t num_sids;
+
+	num_sids = gettoken(mem_ctx, false, &sids);
+	assert_int_equal(num_sids, 3);
+	assert_int_equal(test_wb_queryuser_calls, 1);
+
+	wb_gettoken_flush_cache();
+
+	num_sids = gettoken(mem_ctx, false, &sids);
+	assert_int_equal(num_sids, 3);
+	assert_int_equal(test_wb_queryuser_calls, 2);
+}
+
+static void test_seqnum_failure(void **state)
+{
+	TALLOC_CTX *mem_ctx = *state;
+	struct dom_sid *sids = NULL;
+	uint32_t num_sids;
+
+	num_sids = gettoken(mem_ctx, false, &sids);
+	assert_int_equal(num_sids, 3);
+	assert_int_equal(test_wb_queryuser_calls, 1);
+
+	/*
+	 * Without a sequence number the cached token can't be
+	 * validated, and a new one is not stored.
+	 */
+	seqnum_status = NT_STATUS_IO_TIMEOUT;
+
+	num_sids = gettoken(mem_ctx, false, &sids);
+	assert_int_equal(num_sids, 3);
+	assert_int_equal(test_wb_queryuser_calls, 2);
+
+	seqnum_status = NT_STATUS_OK;
+
+	num_sids = gettoken(mem_ctx, false, &sids);
+	assert_int_equal(num_sids, 3);
+	assert_int_equal(test_wb_queryuser_calls, 2);
+}
+
+static void test_cache_disabled(void **state)
+{
+	TALLOC_CTX *mem_ctx = *state;
+	struct dom_sid *sids = NULL;
+
+	test_wb_use_cache = false;
+
+	gettoken(mem_ctx, false, &sids);
+	gettoken(mem_ctx, false, &sids);
+	assert_int_equal(test_wb_queryuser_calls, 2);
+	assert_int_equal(seqnum_calls, 0);
+}
+
+int main(int argc, char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(test_cache_hit,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_seqnum_change,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_local_alias_change,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_flush,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_seqnum_failure,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_cache_disabled,
+						setup, teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_SUBUNIT);
+
+	test_wb_stubs_init(argc, argv);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
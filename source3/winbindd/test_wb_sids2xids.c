@@ -0,0 +1,438 @@
+/*
+ *  Unix SMB/CIFS implementation.
+ *
+ *  Unit test for coalescing concurrent sids2xids requests
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "wb_sids2xids.c"
+#include <cmocka.h>
+#include "test_wb_stubs.h"
+
+#define TEST_SID_X TEST_WB_DOMAIN_SID "-1105"
+#define TEST_SID_Y TEST_WB_DOMAIN_SID "-1106"
+
+#define TEST_MAX_PENDING 8
+
+/*
+ * Stubs for the parts of winbindd that wb_sids2xids.c calls.  The
+ * Sids2UnixIDs calls to the idmap child are kept pending until the
+ * test answers them, so the test decides which requests are in
+ * flight when a new one comes in.
+ */
+
+static struct wb_parent_idmap_config_dom test_dom = {
+	.low_id = 10000,
+	.high_id = 19999,
+	.name = "TESTDOM",
+};
+
+static struct wb_parent_idmap_config test_cfg = {
+	.num_doms = 1,
+	.initialized = true,
+	.doms = &test_dom,
+};
+
+static struct tevent_req *sids2unix_pending[TEST_MAX_PENDING];
+static unsigned num_sids2unix_pending;
+static unsigned num_sids2unix_calls;
+
+bool winbindd_use_idmap_cache(void)
+{
+	return true;
+}
+
+struct winbindd_domain *find_our_domain(void)
+{
+	return NULL;
+}
+
+bool is_domain_online(const struct winbindd_domain *domain)
+{
+	return true;
+}
+
+struct winbindd_domain *find_domain_from_sid_noinit(const struct dom_sid *sid)
+{
+	return NULL;
+}
+
+struct dcerpc_binding_handle *idmap_child_handle(void)
+{
+	return NULL;
+}
+
+struct idmap_setup_stub_state {
+	uint8_t dummy;
+};
+
+struct tevent_req *wb_parent_idmap_setup_send(TALLOC_CTX *mem_ctx,
+					      struct tevent_context *ev)
+{
+	struct tevent_req *req;
+	struct idmap_setup_stub_state *state;
+
+	req = tevent_req_create(mem_ctx, &state,
+				struct idmap_setup_stub_state);
+	if (req == NULL) {
+		return NULL;
+	}
+	tevent_req_done(req);
+	return tevent_req_post(req, ev);
+}
+
+NTSTATUS wb_parent_idmap_setup_recv(struct tevent_req *req,
+				    const struct wb_parent_idmap_config **_cfg)
+{
+	NTSTATUS status;
+
+	status = tevent_req_simple_recv_ntstatus(req);
+	if (!NT_STATUS_IS_OK(status)) {
+		return status;
+	}
+	*_cfg = &test_cfg;
+	return NT_STATUS_OK;
+}
+
+struct sids2unix_stub_state {
+	struct wbint_TransIDArray *ids;
+	struct wbint_TransID *out;
+};
+
+struct tevent_req *dcerpc_wbint_Sids2UnixIDs_send(
+	TALLOC_CTX *mem_ctx,
+	struct tevent_context *ev,
+	struct dcerpc_binding_handle *h,
+	struct lsa_RefDomainList *_domains,
+	struct wbint_TransIDArray *_ids)
+{
+	struct tevent_req *req;
+	struct sids2unix_stub_state *state;
+
+	num_sids2unix_calls += 1;
+
+	req = tevent_req_create(mem_ctx, &state,
+				struct sids2unix_stub_state);
+	if (req == NULL) {
+		return NULL;
+	}
+	state->ids = _ids;
+
+	assert_true(num_sids2unix_pending < TEST_MAX_PENDING);
+	sids2unix_pending[num_sids2unix_pending++] = req;
+
+	return req;
+}
+
+NTSTATUS dcerpc_wbint_Sids2UnixIDs_recv(struct tevent_req *req,
+					TALLOC_CTX *mem_ctx,
+					NTSTATUS *result)
+{
+	struct sids2unix_stub_state *state = tevent_req_data(
+		req, struct sids2unix_stub_state);
+	NTSTATUS status;
+
+	if (tevent_req_is_nterror(req, &status)) {
+		return status;
+	}
+
+	/* like the generated code, return a new array */
+	state->ids->ids = talloc_move(mem_ctx, &state->out);
+	*result = NT_STATUS_OK;
+	return NT_STATUS_OK;
+}
+
+/*
+ * Map every pending SID to low_id + rid
+ */
+static void sids2unix_answer_all(void)
+{
+	struct tevent_req *pending[TEST_MAX_PENDING];
+	unsigned i, num_pending = num_sids2unix_pending;
+	uint32_t j;
+
+	/* answering may send new requests */
+	memcpy(pending, sids2unix_pending, sizeof(pending));
+	num_sids2unix_pending = 0;
+
+	for (i = 0; i < num_pending; i++) {
+		struct tevent_req *req = pending[i];
+		struct sids2unix_stub_state *state = tevent_req_data(
+			req, struct sids2unix_stub_state);
+
+		state->out = talloc_array(state,
+					  struct wbint_TransID,
+					  state->ids->num_ids);
+		assert_non_null(state->out);
+
+		for (j = 0; j < state->ids->num_ids; j++) {
+			state->out[j] = state->ids->ids[j];
+			state->out[j].xid = (struct unixid) {
+				.id = test_dom.low_id + state->out[j].rid,
+				.type = ID_TYPE_UID,
+			};
+		}
+		tevent_req_done(req);
+	}
+}
+
+struct tevent_req *wb_lookupsids_send(TALLOC_CTX *mem_ctx,
+				      struct tevent_context *ev,
+				      struct dom_sid *sids,
+				      uint32_t num_sids)
+{
+	fail();
+	return NULL;
+}
+
+NTSTATUS wb_lookupsids_recv(struct tevent_req *req, TALLOC_CTX *mem_ctx,
+			    struct lsa_RefDomainList **domains,
+			    struct lsa_TransNameArray **names)
+{
+	fail();
+	return NT_STATUS_INTERNAL_ERROR;
+}
+
+struct tevent_req *wb_dsgetdcname_send(TALLOC_CTX *mem_ctx,
+				       struct tevent_context *ev,
+				       const char *domain_name,
+				       const struct GUID *domain_guid,
+				       const char *site_name,
+				       uint32_t flags)
+{
+	fail();
+	return NULL;
+}
+
+NTSTATUS wb_dsgetdcname_recv(struct tevent_req *req, TALLOC_CTX *mem_ctx,
+			     struct netr_DsRGetDCNameInfo **pdcinfo)
+{
+	fail();
+	return NT_STATUS_INTERNAL_ERROR;
+}
+
+NTSTATUS wb_dsgetdcname_gencache_set(const char *domname,
+				     struct netr_DsRGetDCNameInfo *dcinfo)
+{
+	fail();
+	return NT_STATUS_INTERNAL_ERROR;
+}
+
+struct test_state {
+	struct tevent_context *ev;
+	struct dom_sid x;
+	struct dom_sid y;
+};
+
+static int setup(void **_state)
+{
+	struct test_state *state = NULL;
+	bool ok;
+
+	state = talloc_zero(NULL, struct test_state);
+	assert_non_null(state);
+
+	state->ev = samba_tevent_context_init(state);
+	assert_non_null(state->ev);
+
+	test_wb_stubs_setup();
+	sid_copy(&test_dom.sid, &test_wb_domain_sid);
+
+	ok = dom_sid_parse(TEST_SID_X, &state->x);
+	assert_true(ok);
+	ok = dom_sid_parse(TEST_SID_Y, &state->y);
+	assert_true(ok);
+
+	idmap_cache_del_sid(&state->x);
+	idmap_cache_del_sid(&state->y);
+
+	num_sids2unix_pending = 0;
+	num_sids2unix_calls = 0;
+	wb_sids2xids_num_issued = 0;
+	wb_sids2xids_num_coalesced = 0;
+
+	*_state = state;
+	return 0;
+}
+
+static int teardown(void **_state)
+{
+	struct test_state *state = talloc_get_type_abort(
+		*_state, struct test_state);
+
+	idmap_cache_del_sid(&state->x);
+	idmap_cache_del_sid(&state->y);
+	assert_null(wb_sids2xids_in_flight);
+	TALLOC_FREE(state);
+	return 0;
+}
+
+static void wait_for_sids2unix_calls(struct tevent_context *ev,
+				     unsigned num_calls)
+{
+	while (num_sids2unix_calls < num_calls) {
+		int ret = tevent_loop_once(ev);
+		assert_int_equal(ret, 0);
+	}
+}
+
+static void check_xid(struct tevent_context *ev,
+		      struct tevent_req *req,
+		      uint32_t num_xids,
+		      uint32_t idx,
+		      uint32_t rid)
+{
+	struct unixid xids[2];
+	NTSTATUS status;
+	bool ok;
+
+	assert_true(num_xids <= ARRAY_SIZE(xids));
+
+	ok = tevent_req_poll(req, ev);
+	assert_true(ok);
+
+	status = wb_sids2xids_recv(req, xids, num_xids);
+	assert_true(NT_STATUS_IS_OK(status));
+	assert_int_equal(xids[idx].id, test_dom.low_id + rid);
+	assert_int_equal(xids[idx].type, ID_TYPE_UID);
+}
+
+/*
+ * A request for a SID that an in-flight request is resolving waits
+ * for it and then takes the result from the idmap cache.
+ */
+static void test_coalesce_same_sid(void **_state)
+{
+	struct test_state *state = talloc_get_type_abort(
+		*_state, struct test_state);
+	struct tevent_req *leader, *waiter;
+
+	leader = wb_sids2xids_send(state, state->ev, &state->y, 1);
+	assert_non_null(leader);
+	wait_for_sids2unix_calls(state->ev, 1);
+
+	waiter = wb_sids2xids_send(state, state->ev, &state->y, 1);
+	assert_non_null(waiter);
+	assert_int_equal(wb_sids2xids_num_coalesced, 1);
+
+	sids2unix_answer_all();
+
+	check_xid(state->ev, leader, 1, 0, 1106);
+	check_xid(state->ev, waiter, 1, 0, 1106);
+
+	assert_int_equal(num_sids2unix_calls, 1);
+	assert_int_equal(wb_sids2xids_num_issued, 1);
+
+	TALLOC_FREE(leader);
+	TALLOC_FREE(waiter);
+}
+
+/*
+ * The in-flight request only resolves the SIDs that were missing
+ * from the cache.  A SID it found in the cache must not make a new
+ * request wait for it, the cache would still be empty for that SID
+ * afterwards.
+ */
+static void test_no_coalesce_cached_sid(void **_state)
+{
+	struct test_state *state = talloc_get_type_abort(
+		*_state, struct test_state);
+	struct unixid xid = {
+		.id = test_dom.low_id + 1105,
+		.type = ID_TYPE_UID,
+	};
+	struct dom_sid both[2];
+	struct tevent_req *leader, *other;
+
+	idmap_cache_set_sid2unixid(&state->x, &xid);
+
+	both[0] = state->x;
+	both[1] = state->y;
+
+	leader = wb_sids2xids_send(state, state->ev, both, 2);
+	assert_non_null(leader);
+	wait_for_sids2unix_calls(state->ev, 1);
+
+	/* x drops out of the cache while the leader is in flight */
+	idmap_cache_del_sid(&state->x);
+
+	other = wb_sids2xids_send(state, state->ev, &state->x, 1);
+	assert_non_null(other);
+	assert_int_equal(wb_sids2xids_num_coalesced, 0);
+	wait_for_sids2unix_calls(state->ev, 2);
+
+	sids2unix_answer_all();
+
+	check_xid(state->ev, leader, 2, 0, 1105);
+	check_xid(state->ev, leader, 2, 1, 1106);
+	check_xid(state->ev, other, 1, 0, 1105);
+
+	assert_int_equal(num_sids2unix_calls, 2);
+	assert_int_equal(wb_sids2xids_num_issued, 2);
+
+	TALLOC_FREE(leader);
+	TALLOC_FREE(other);
+}
+
+/*
+ * A request with one SID nobody is resolving does its own lookup.
+ */
+static void test_no_coalesce_partial(void **_state)
+{
+	struct test_state *state = talloc_get_type_abort(
+		*_state, struct test_state);
+	struct dom_sid both[2];
+	struct tevent_req *leader, *other;
+
+	leader = wb_sids2xids_send(state, state->ev, &state->y, 1);
+	assert_non_null(leader);
+	wait_for_sids2unix_calls(state->ev, 1);
+
+	both[0] = state->x;
+	both[1] = state->y;
+
+	other = wb_sids2xids_send(state, state->ev, both, 2);
+	assert_non_null(other);
+	assert_int_equal(wb_sids2xids_num_coalesced, 0);
+	wait_for_sids2unix_calls(state->ev, 2);
+
+	sids2unix_answer_all();
+
+	check_xid(state->ev, leader, 1, 0, 1106);
+	check_xid(state->ev, other, 2, 0, 1105);
+	check_xid(state->ev, other, 2, 1, 1106);
+
+	TALLOC_FREE(leader);
+	TALLOC_FREE(other);
+}
+
+int main(int argc, char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(test_coalesce_same_sid,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_no_coalesce_cached_sid,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_no_coalesce_partial,
+						setup, teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_SUBUNIT);
+
+	/* The idmap cache lives in gencache */
+	test_wb_stubs_init(argc, argv);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
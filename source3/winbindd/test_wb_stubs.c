@@ -0,0 +1,116 @@
+/*
+ *  Unix SMB/CIFS implementation.
+ *
+ *  Stubs shared by the winbindd unit tests
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "includes.h"
+#include "winbindd.h"
+#include "../libcli/security/security.h"
+#include "test_wb_stubs.h"
+
+struct dom_sid test_wb_domain_sid;
+bool test_wb_use_cache = true;
+unsigned test_wb_queryuser_calls;
+NTSTATUS test_wb_queryuser_status;
+
+bool winbindd_use_cache(void)
+{
+	return test_wb_use_cache;
+}
+
+struct queryuser_stub_state {
+	struct wbint_userinfo *info;
+};
+
+struct tevent_req *wb_queryuser_send(TALLOC_CTX *mem_ctx,
+				     struct tevent_context *ev,
+				     const struct dom_sid *user_sid)
+{
+	struct tevent_req *req;
+	struct queryuser_stub_state *state;
+
+	test_wb_queryuser_calls += 1;
+
+	req = tevent_req_create(mem_ctx, &state,
+				struct queryuser_stub_state);
+	if (req == NULL) {
+		return NULL;
+	}
+
+	if (tevent_req_nterror(req, test_wb_queryuser_status)) {
+		return tevent_req_post(req, ev);
+	}
+
+	state->info = talloc_zero(state, struct wbint_userinfo);
+	if (tevent_req_nomem(state->info, req)) {
+		return tevent_req_post(req, ev);
+	}
+	state->info->domain_name = "SAMBADOMAIN";
+	state->info->acct_name = "User1";
+	state->info->full_name = "Test User";
+	state->info->homedir = "/home/%U";
+	state->info->shell = "/bin/sh";
+	state->info->primary_group_name = "Domain Users";
+	state->info->uid = TEST_WB_UID_BASE + test_wb_queryuser_calls;
+	state->info->primary_gid = TEST_WB_UID_BASE;
+	sid_copy(&state->info->user_sid, user_sid);
+	sid_compose(&state->info->group_sid,
+		    &test_wb_domain_sid,
+		    TEST_WB_PRIMARY_GROUP_RID);
+
+	tevent_req_done(req);
+	return tevent_req_post(req, ev);
+}
+
+NTSTATUS wb_queryuser_recv(struct tevent_req *req, TALLOC_CTX *mem_ctx,
+			   struct wbint_userinfo **pinfo)
+{
+	struct queryuser_stub_state *state = tevent_req_data(
+		req, struct queryuser_stub_state);
+	NTSTATUS status;
+
+	if (tevent_req_is_nterror(req, &status)) {
+		return status;
+	}
+	*pinfo = talloc_move(mem_ctx, &state->info);
+	return NT_STATUS_OK;
+}
+
+void test_wb_stubs_setup(void)
+{
+	bool ok;
+
+	ok = dom_sid_parse(TEST_WB_DOMAIN_SID, &test_wb_domain_sid);
+	SMB_ASSERT(ok);
+
+	test_wb_use_cache = true;
+	test_wb_queryuser_calls = 0;
+	test_wb_queryuser_status = NT_STATUS_OK;
+
+	lp_do_parameter(-1, "winbind cache time", "300");
+}
+
+void test_wb_stubs_init(int argc, char **argv)
+{
+	if (argc != 2) {
+		fprintf(stderr, "Usage: %s smb.conf\n", argv[0]);
+		exit(1);
+	}
+
+	talloc_stackframe();
+	lp_load_global(argv[1]);
+}
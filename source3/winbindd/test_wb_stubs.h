@@ -0,0 +1,58 @@
+/*
+ *  Unix SMB/CIFS implementation.
+ *
+ *  Stubs shared by the winbindd unit tests
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TEST_WB_STUBS_H_
+#define _TEST_WB_STUBS_H_
+
+/*
+ * The winbindd unit tests include the module under test and replace
+ * the rest of winbindd with stubs.  The ones several tests need are
+ * here: winbindd_use_cache() and a wb_queryuser_send() that completes
+ * immediately with a user of TEST_WB_DOMAIN_SID, counting its calls.
+ */
+
+#define TEST_WB_DOMAIN_SID "S-1-5-21-1111111111-2222222222-3333333333"
+#define TEST_WB_PRIMARY_GROUP_RID 513
+#define TEST_WB_UID_BASE 3000000
+
+extern struct dom_sid test_wb_domain_sid;
+
+/* returned by winbindd_use_cache() */
+extern bool test_wb_use_cache;
+
+/*
+ * wb_queryuser_send() fails with test_wb_queryuser_status if set,
+ * the uid of the user is TEST_WB_UID_BASE + test_wb_queryuser_calls
+ */
+extern unsigned test_wb_queryuser_calls;
+extern NTSTATUS test_wb_queryuser_status;
+
+/*
+ * Reset the stubs and the cache settings for the next test, to be
+ * called from the setup function of each test
+ */
+void test_wb_stubs_setup(void);
+
+/*
+ * Load the smb.conf given as the only argument, the winbindd caches
+ * live in gencache and memcache which need it
+ */
+void test_wb_stubs_init(int argc, char **argv);
+
+#endif /* _TEST_WB_STUBS_H_ */
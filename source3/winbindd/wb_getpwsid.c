@@ -22,8 +22,87 @@
 #include "librpc/gen_ndr/ndr_winbind_c.h"
 #include "../libcli/security/security.h"
 #include "lib/util/string_wrappers.h"
+#include "lib/util/memcache.h"
 #include "source3/lib/substitute.h"
 
+/*
+ * Completed passwd entries are kept in memory for "winbind cache time"
+ * seconds, so repeated getpwnam/getpwuid calls for the same user are
+ * answered without asking the idmap child again.
+ */
+#define WB_GETPWSID_CACHE_SIZE (2*1024*1024)
+
+struct wb_getpwsid_cache_entry {
+	time_t expires;
+	struct winbindd_pw pw;
+};
+
+static struct memcache *wb_getpwsid_cache;
+
+void wb_getpwsid_flush_cache(void)
+{
+	TALLOC_FREE(wb_getpwsid_cache);
+}
+
+static bool wb_getpwsid_cache_fetch(const struct dom_sid *sid,
+				    struct winbindd_pw *pw)
+{
+	DATA_BLOB key = data_blob_const(sid, sizeof(*sid));
+	DATA_BLOB value;
+	struct wb_getpwsid_cache_entry entry;
+	bool ok;
+
+	if (wb_getpwsid_cache == NULL) {
+		return false;
+	}
+
+	ok = memcache_lookup(wb_getpwsid_cache,
+			     WINBIND_GETPWSID_CACHE,
+			     key,
+			     &value);
+	if (!ok || value.length != sizeof(entry)) {
+		return false;
+	}
+	memcpy(&entry, value.data, sizeof(entry));
+
+	if (entry.expires < time(NULL)) {
+		memcache_delete(wb_getpwsid_cache,
+				WINBIND_GETPWSID_CACHE,
+				key);
+		return false;
+	}
+
+	*pw = entry.pw;
+	return true;
+}
+
+static void wb_getpwsid_cache_store(const struct dom_sid *sid,
+				    const struct winbindd_pw *pw)
+{
+	DATA_BLOB key = data_blob_const(sid, sizeof(*sid));
+	struct wb_getpwsid_cache_entry entry = {
+		.expires = time(NULL) + lp_winbind_cache_time(),
+		.pw = *pw,
+	};
+
+	if (!winbindd_use_cache() || lp_winbind_cache_time() <= 0) {
+		return;
+	}
+
+	if (wb_getpwsid_cache == NULL) {
+		wb_getpwsid_cache = memcache_init(NULL,
+						  WB_GETPWSID_CACHE_SIZE);
+		if (wb_getpwsid_cache == NULL) {
+			return;
+		}
+	}
+
+	memcache_add(wb_getpwsid_cache,
+		     WINBIND_GETPWSID_CACHE,
+		     key,
+		     data_blob_const(&entry, sizeof(entry)));
+}
+
 struct wb_getpwsid_state {
 	struct tevent_context *ev;
 	struct dom_sid sid;
@@ -57,6 +136,13 @@ struct tevent_req *wb_getpwsid_send(TALLOC_CTX *mem_ctx,
 		return tevent_req_post(req, ev);
 	}
 
+	if (wb_getpwsid_cache_fetch(&state->sid, pw)) {
+		D_DEBUG("Found user SID %s in the passwd cache.\n",
+			dom_sid_str_buf(user_sid, &buf));
+		tevent_req_done(req);
+		return tevent_req_post(req, ev);
+	}
+
 	subreq = wb_queryuser_send(state, ev, &state->sid);
 	if (tevent_req_nomem(subreq, req)) {
 		return tevent_req_post(req, ev);
@@ -145,6 +231,8 @@ static void wb_getpwsid_queryuser_done(struct tevent_req *subreq)
 
 	strlcpy(pw->pw_passwd, "*", sizeof(pw->pw_passwd));
 
+	wb_getpwsid_cache_store(&state->sid, pw);
+
 	tevent_req_done(req);
 }
 
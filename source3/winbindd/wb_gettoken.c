@@ -23,11 +23,184 @@
 #include "librpc/gen_ndr/ndr_winbind_c.h"
 #include "../libcli/security/security.h"
 #include "passdb/machine_sid.h"
+#include "lib/util/memcache.h"
+
+/*
+ * Completed tokens are kept in memory for "winbind cache time" seconds,
+ * keyed by user SID and whether local aliases were expanded. Before a
+ * token is looked up or built, the sequence numbers of the domains it
+ * depends on are asked from their domain children: the user's domain,
+ * and with local aliases expanded also our SAM and BUILTIN. An entry is
+ * only used while they are the ones it was built with. A hit in the
+ * last quarter of its lifetime rebuilds the token in the background, so
+ * users that keep opening new sessions do not fall back to the group
+ * lookups in the domain children.
+ */
+#define WB_GETTOKEN_CACHE_SIZE (4*1024*1024)
+#define WB_GETTOKEN_MAX_SEQNUMS 3
+
+struct wb_gettoken_cache_key {
+	struct dom_sid sid;
+	uint8_t expand_local_aliases;
+};
+
+struct wb_gettoken_cache_entry {
+	time_t expires;
+	time_t refresh;
+	uint32_t seqnums[WB_GETTOKEN_MAX_SEQNUMS];
+	bool refreshing;
+	uint32_t num_sids;
+	/* followed by num_sids struct dom_sid */
+};
+
+static struct memcache *wb_gettoken_cache;
+
+void wb_gettoken_flush_cache(void)
+{
+	TALLOC_FREE(wb_gettoken_cache);
+}
+
+static DATA_BLOB wb_gettoken_cache_key(struct wb_gettoken_cache_key *key,
+				       const struct dom_sid *sid,
+				       bool expand_local_aliases)
+{
+	ZERO_STRUCTP(key);
+	sid_copy(&key->sid, sid);
+	key->expand_local_aliases = expand_local_aliases;
+	return data_blob_const(key, sizeof(*key));
+}
+
+static bool wb_gettoken_cache_fetch(TALLOC_CTX *mem_ctx,
+				    const struct dom_sid *sid,
+				    bool expand_local_aliases,
+				    const uint32_t *seqnums,
+				    uint32_t *pnum_sids,
+				    struct dom_sid **psids,
+				    bool *prefresh)
+{
+	struct wb_gettoken_cache_key keybuf;
+	DATA_BLOB key = wb_gettoken_cache_key(
+		&keybuf, sid, expand_local_aliases);
+	DATA_BLOB value;
+	struct wb_gettoken_cache_entry entry;
+	struct dom_sid *sids = NULL;
+	time_t now = time(NULL);
+	bool ok;
+
+	*prefresh = false;
+
+	if (wb_gettoken_cache == NULL) {
+		return false;
+	}
+
+	ok = memcache_lookup(wb_gettoken_cache,
+			     WINBIND_GETTOKEN_CACHE,
+			     key,
+			     &value);
+	if (!ok || value.length < sizeof(entry)) {
+		return false;
+	}
+	memcpy(&entry, value.data, sizeof(entry));
+
+	if ((value.length - sizeof(entry)) / sizeof(struct dom_sid) !=
+	    entry.num_sids) {
+		return false;
+	}
+
+	if ((entry.expires < now) ||
+	    (memcmp(entry.seqnums, seqnums, sizeof(entry.seqnums)) != 0)) {
+		memcache_delete(wb_gettoken_cache,
+				WINBIND_GETTOKEN_CACHE,
+				key);
+		return false;
+	}
+
+	sids = talloc_array(mem_ctx, struct dom_sid, entry.num_sids);
+	if (sids == NULL) {
+		return false;
+	}
+	memcpy(sids,
+	       value.data + sizeof(entry),
+	       entry.num_sids * sizeof(struct dom_sid));
+
+	if (!entry.refreshing && (entry.refresh <= now)) {
+		/*
+		 * Only one background refresh per entry, the
+		 * result of it replaces this entry.
+		 */
+		entry.refreshing = true;
+		memcpy(value.data, &entry, sizeof(entry));
+		*prefresh = true;
+	}
+
+	*pnum_sids = entry.num_sids;
+	*psids = sids;
+	return true;
+}
+
+static void wb_gettoken_cache_store(const struct dom_sid *sid,
+				    bool expand_local_aliases,
+				    const uint32_t *seqnums,
+				    uint32_t num_sids,
+				    const struct dom_sid *sids)
+{
+	struct wb_gettoken_cache_key keybuf;
+	DATA_BLOB key;
+	int cache_time = lp_winbind_cache_time();
+	time_t now = time(NULL);
+	struct wb_gettoken_cache_entry entry = {
+		.expires = now + cache_time,
+		.refresh = now + cache_time - cache_time / 4,
+		.num_sids = num_sids,
+	};
+	size_t sids_len = num_sids * sizeof(struct dom_sid);
+	uint8_t *buf = NULL;
+
+	if (!winbindd_use_cache() || cache_time <= 0) {
+		return;
+	}
+	memcpy(entry.seqnums, seqnums, sizeof(entry.seqnums));
+
+	if (sids_len > WB_GETTOKEN_CACHE_SIZE / 4) {
+		return;
+	}
+
+	if (wb_gettoken_cache == NULL) {
+		wb_gettoken_cache = memcache_init(NULL,
+						  WB_GETTOKEN_CACHE_SIZE);
+		if (wb_gettoken_cache == NULL) {
+			return;
+		}
+	}
+
+	buf = talloc_size(talloc_tos(), sizeof(entry) + sids_len);
+	if (buf == NULL) {
+		return;
+	}
+	memcpy(buf, &entry, sizeof(entry));
+	memcpy(buf + sizeof(entry), sids, sids_len);
+
+	key = wb_gettoken_cache_key(&keybuf, sid, expand_local_aliases);
+	memcache_add(wb_gettoken_cache,
+		     WINBIND_GETTOKEN_CACHE,
+		     key,
+		     data_blob_const(buf, sizeof(entry) + sids_len));
+	TALLOC_FREE(buf);
+}
 
 struct wb_gettoken_state {
 	struct tevent_context *ev;
 	struct dom_sid usersid;
 	bool expand_local_aliases;
+	bool use_cache;
+	/*
+	 * The domains the token depends on and their sequence
+	 * numbers, num_seqnums is 0 if they are not known
+	 */
+	struct winbindd_domain *seqnum_domains[WB_GETTOKEN_MAX_SEQNUMS];
+	uint32_t num_seqnum_domains;
+	uint32_t seqnums[WB_GETTOKEN_MAX_SEQNUMS];
+	uint32_t num_seqnums;
 	uint32_t num_sids;
 	struct dom_sid *sids;
 };
@@ -38,19 +211,27 @@ static NTSTATUS wb_add_rids_to_sids(TALLOC_CTX *mem_ctx,
 				    const struct dom_sid *domain_sid,
 				    uint32_t num_rids, uint32_t *rids);
 
+static void wb_gettoken_refresh(struct tevent_context *ev,
+				const struct dom_sid *sid,
+				bool expand_local_aliases);
+static bool wb_gettoken_seqnum_domains(struct wb_gettoken_state *state);
+static void wb_gettoken_gotseqnum(struct tevent_req *subreq);
 static void wb_gettoken_gotuser(struct tevent_req *subreq);
 static void wb_gettoken_gotgroups(struct tevent_req *subreq);
 static void wb_gettoken_gotlocalgroups(struct tevent_req *subreq);
 static void wb_gettoken_gotbuiltins(struct tevent_req *subreq);
 
-struct tevent_req *wb_gettoken_send(TALLOC_CTX *mem_ctx,
-				    struct tevent_context *ev,
-				    const struct dom_sid *sid,
-				    bool expand_local_aliases)
+static struct tevent_req *wb_gettoken_send_internal(
+	TALLOC_CTX *mem_ctx,
+	struct tevent_context *ev,
+	const struct dom_sid *sid,
+	bool expand_local_aliases,
+	bool use_cache)
 {
 	struct tevent_req *req, *subreq;
 	struct wb_gettoken_state *state;
 	struct dom_sid_buf buf;
+	bool ok = false;
 
 	req = tevent_req_create(mem_ctx, &state, struct wb_gettoken_state);
 	if (req == NULL) {
@@ -59,11 +240,29 @@ struct tevent_req *wb_gettoken_send(TALLOC_CTX *mem_ctx,
 	sid_copy(&state->usersid, sid);
 	state->ev = ev;
 	state->expand_local_aliases = expand_local_aliases;
+	state->use_cache = use_cache;
 
 	D_INFO("WB command gettoken start.\n"
 	       "Query user SID %s (expand local aliases is %d).\n",
 	       dom_sid_str_buf(sid, &buf),
 	       expand_local_aliases);
+
+	if (winbindd_use_cache() && lp_winbind_cache_time() > 0) {
+		ok = wb_gettoken_seqnum_domains(state);
+	}
+	if (ok) {
+		/*
+		 * A cached token is only valid for the current
+		 * sequence numbers of the domains it depends on.
+		 */
+		subreq = wb_seqnum_send(state, ev, state->seqnum_domains[0]);
+		if (tevent_req_nomem(subreq, req)) {
+			return tevent_req_post(req, ev);
+		}
+		tevent_req_set_callback(subreq, wb_gettoken_gotseqnum, req);
+		return req;
+	}
+
 	subreq = wb_queryuser_send(state, ev, &state->usersid);
 	if (tevent_req_nomem(subreq, req)) {
 		return tevent_req_post(req, ev);
@@ -72,6 +271,133 @@ struct tevent_req *wb_gettoken_send(TALLOC_CTX *mem_ctx,
 	return req;
 }
 
+/*
+ * The user's domain, and with local aliases expanded our SAM and
+ * BUILTIN, as their aliases end up in the token as well
+ */
+static bool wb_gettoken_seqnum_domains(struct wb_gettoken_state *state)
+{
+	struct winbindd_domain *domain = NULL;
+
+	domain = find_domain_from_sid_noinit(&state->usersid);
+	if (domain == NULL) {
+		return false;
+	}
+	state->seqnum_domains[0] = domain;
+
+	if (!state->expand_local_aliases) {
+		state->num_seqnum_domains = 1;
+		return true;
+	}
+
+	domain = find_domain_from_sid_noinit(get_global_sam_sid());
+	if (domain == NULL) {
+		return false;
+	}
+	state->seqnum_domains[1] = domain;
+
+	domain = find_domain_from_sid_noinit(&global_sid_Builtin);
+	if (domain == NULL) {
+		return false;
+	}
+	state->seqnum_domains[2] = domain;
+
+	state->num_seqnum_domains = 3;
+	return true;
+}
+
+static void wb_gettoken_gotseqnum(struct tevent_req *subreq)
+{
+	struct tevent_req *req = tevent_req_callback_data(
+		subreq, struct tevent_req);
+	struct wb_gettoken_state *state = tevent_req_data(
+		req, struct wb_gettoken_state);
+	uint32_t seqnum = DOM_SEQUENCE_NONE;
+	NTSTATUS status;
+	bool refresh = false;
+
+	status = wb_seqnum_recv(subreq, &seqnum);
+	TALLOC_FREE(subreq);
+	if (NT_STATUS_IS_OK(status) && seqnum == DOM_SEQUENCE_NONE) {
+		status = NT_STATUS_INVALID_SERVER_STATE;
+	}
+	if (NT_STATUS_IS_OK(status)) {
+		state->seqnums[state->num_seqnums++] = seqnum;
+	} else {
+		/*
+		 * Without all sequence numbers the token is neither
+		 * taken from nor stored in the cache.
+		 */
+		D_DEBUG("Could not get the sequence number of %s: %s\n",
+			state->seqnum_domains[state->num_seqnums]->name,
+			nt_errstr(status));
+		state->num_seqnum_domains = 0;
+		state->num_seqnums = 0;
+	}
+
+	if (state->num_seqnums < state->num_seqnum_domains) {
+		subreq = wb_seqnum_send(
+			state,
+			state->ev,
+			state->seqnum_domains[state->num_seqnums]);
+		if (tevent_req_nomem(subreq, req)) {
+			return;
+		}
+		tevent_req_set_callback(subreq, wb_gettoken_gotseqnum, req);
+		return;
+	}
+
+	if (state->use_cache &&
+	    state->num_seqnums != 0 &&
+	    wb_gettoken_cache_fetch(state,
+				    &state->usersid,
+				    state->expand_local_aliases,
+				    state->seqnums,
+				    &state->num_sids,
+				    &state->sids,
+				    &refresh)) {
+		D_DEBUG("Found %"PRIu32" SID(s) in the token cache.\n",
+			state->num_sids);
+		if (refresh) {
+			wb_gettoken_refresh(state->ev,
+					    &state->usersid,
+					    state->expand_local_aliases);
+		}
+		tevent_req_done(req);
+		return;
+	}
+
+	subreq = wb_queryuser_send(state, state->ev, &state->usersid);
+	if (tevent_req_nomem(subreq, req)) {
+		return;
+	}
+	tevent_req_set_callback(subreq, wb_gettoken_gotuser, req);
+}
+
+struct tevent_req *wb_gettoken_send(TALLOC_CTX *mem_ctx,
+				    struct tevent_context *ev,
+				    const struct dom_sid *sid,
+				    bool expand_local_aliases)
+{
+	return wb_gettoken_send_internal(
+		mem_ctx, ev, sid, expand_local_aliases, true);
+}
+
+static void wb_gettoken_done(struct tevent_req *req)
+{
+	struct wb_gettoken_state *state = tevent_req_data(
+		req, struct wb_gettoken_state);
+
+	if (state->num_seqnums != 0) {
+		wb_gettoken_cache_store(&state->usersid,
+					state->expand_local_aliases,
+					state->seqnums,
+					state->num_sids,
+					state->sids);
+	}
+	tevent_req_done(req);
+}
+
 static void wb_gettoken_gotuser(struct tevent_req *subreq)
 {
 	struct tevent_req *req = tevent_req_callback_data(
@@ -140,7 +466,7 @@ static void wb_gettoken_gotgroups(struct tevent_req *subreq)
 
 	if (!state->expand_local_aliases) {
 		D_DEBUG("Done. Not asked to expand local aliases.\n");
-		tevent_req_done(req);
+		wb_gettoken_done(req);
 		return;
 	}
 
@@ -229,7 +555,7 @@ static void wb_gettoken_gotbuiltins(struct tevent_req *subreq)
 	if (tevent_req_nterror(req, status)) {
 		return;
 	}
-	tevent_req_done(req);
+	wb_gettoken_done(req);
 }
 
 NTSTATUS wb_gettoken_recv(struct tevent_req *req, TALLOC_CTX *mem_ctx,
@@ -261,6 +587,61 @@ NTSTATUS wb_gettoken_recv(struct tevent_req *req, TALLOC_CTX *mem_ctx,
 	return NT_STATUS_OK;
 }
 
+/*
+ * Background refresh of a cached token, rebuilt bypassing the cache.
+ * The result replaces the cache entry.
+ */
+
+struct wb_gettoken_refresh_state {
+	struct dom_sid usersid;
+};
+
+static void wb_gettoken_refresh_done(struct tevent_req *subreq);
+
+static void wb_gettoken_refresh(struct tevent_context *ev,
+				const struct dom_sid *sid,
+				bool expand_local_aliases)
+{
+	struct wb_gettoken_refresh_state *state = NULL;
+	struct tevent_req *subreq = NULL;
+
+	state = talloc_zero(ev, struct wb_gettoken_refresh_state);
+	if (state == NULL) {
+		return;
+	}
+	sid_copy(&state->usersid, sid);
+
+	subreq = wb_gettoken_send_internal(state,
+					   ev,
+					   sid,
+					   expand_local_aliases,
+					   false);
+	if (subreq == NULL) {
+		TALLOC_FREE(state);
+		return;
+	}
+	tevent_req_set_callback(subreq, wb_gettoken_refresh_done, state);
+}
+
+static void wb_gettoken_refresh_done(struct tevent_req *subreq)
+{
+	struct wb_gettoken_refresh_state *state = tevent_req_callback_data(
+		subreq, struct wb_gettoken_refresh_state);
+	struct dom_sid_buf buf;
+	uint32_t num_sids = 0;
+	struct dom_sid *sids = NULL;
+	NTSTATUS status;
+
+	status = wb_gettoken_recv(subreq, state, &num_sids, &sids);
+	TALLOC_FREE(subreq);
+	if (!NT_STATUS_IS_OK(status)) {
+		D_NOTICE("Refreshing the token of %s failed: %s\n",
+			 dom_sid_str_buf(&state->usersid, &buf),
+			 nt_errstr(status));
+	}
+	TALLOC_FREE(state);
+}
+
 static NTSTATUS wb_add_rids_to_sids(TALLOC_CTX *mem_ctx,
 				    uint32_t *pnum_sids,
 				    struct dom_sid **psids,
@@ -26,7 +26,10 @@
 #include "librpc/gen_ndr/ndr_netlogon.h"
 #include "lsa.h"
 
+struct wb_sids2xids_waiter;
+
 struct wb_sids2xids_state {
+	struct wb_sids2xids_state *prev, *next;
 	struct tevent_context *ev;
 
 	const struct wb_parent_idmap_config *cfg;
@@ -61,8 +64,42 @@ struct wb_sids2xids_state {
 	uint32_t dom_index;
 	struct lsa_RefDomainList idmap_dom;
 	bool tried_dclookup;
+
+	/*
+	 * Requests waiting for us to fill the idmap cache, and the
+	 * number of in-flight requests we are waiting for.
+	 *
+	 * resolving[i] is true for the SIDs we did not find in the
+	 * cache, only those can be waited for.
+	 */
+	bool in_flight;
+	bool *resolving;
+	struct wb_sids2xids_waiter *waiters;
+	uint32_t num_waiting;
+};
+
+/*
+ * Requests that are currently resolving SIDs via the idmap child
+ * and/or lookupsids. A new request whose uncached SIDs are all being
+ * resolved by one of these waits for them to finish and then retries
+ * the idmap cache, instead of asking the idmap child and the DC again
+ * for the same SIDs.
+ */
+static struct wb_sids2xids_state *wb_sids2xids_in_flight;
+
+static uint64_t wb_sids2xids_num_issued;
+static uint64_t wb_sids2xids_num_coalesced;
+
+struct wb_sids2xids_waiter {
+	struct wb_sids2xids_waiter *prev, *next;
+	struct wb_sids2xids_state *leader;
+	struct tevent_req *req;
 };
 
+static void wb_sids2xids_start(struct tevent_req *req);
+static bool wb_sids2xids_coalesce(struct tevent_req *req);
+static void wb_sids2xids_cleanup(struct tevent_req *req,
+				 enum tevent_req_state req_state);
 static void wb_sids2xids_idmap_setup_done(struct tevent_req *subreq);
 static bool wb_sids2xids_in_cache(struct dom_sid *sid, struct id_map *map);
 static void wb_sids2xids_lookupsids_done(struct tevent_req *subreq);
@@ -124,6 +161,11 @@ struct tevent_req *wb_sids2xids_send(TALLOC_CTX *mem_ctx,
 		return tevent_req_post(req, ev);
 	}
 
+	state->resolving = talloc_zero_array(state, bool, num_sids);
+	if (tevent_req_nomem(state->resolving, req)) {
+		return tevent_req_post(req, ev);
+	}
+
 	/*
 	 * Extract those sids that can not be resolved from cache
 	 * into a separate list to be handed to id mapping, keeping
@@ -179,12 +221,221 @@ struct tevent_req *wb_sids2xids_send(TALLOC_CTX *mem_ctx,
 		return tevent_req_post(req, ev);
 	}
 
+	tevent_req_set_cleanup_fn(req, wb_sids2xids_cleanup);
+
+	if (wb_sids2xids_coalesce(req)) {
+		return req;
+	}
+
+	wb_sids2xids_start(req);
+	if (!tevent_req_is_in_progress(req)) {
+		return tevent_req_post(req, ev);
+	}
+	return req;
+}
+
+static void wb_sids2xids_start(struct tevent_req *req)
+{
+	struct wb_sids2xids_state *state = tevent_req_data(
+		req, struct wb_sids2xids_state);
+	struct tevent_req *subreq = NULL;
+	uint32_t i;
+
+	wb_sids2xids_num_issued += 1;
+
+	for (i = 0; i < state->num_sids; i++) {
+		state->resolving[i] =
+			(state->all_ids.ids[i].domain_index != UINT32_MAX);
+	}
+
+	DLIST_ADD(wb_sids2xids_in_flight, state);
+	state->in_flight = true;
+
 	subreq = wb_parent_idmap_setup_send(state, state->ev);
 	if (tevent_req_nomem(subreq, req)) {
-		return tevent_req_post(req, ev);
+		return;
 	}
 	tevent_req_set_callback(subreq, wb_sids2xids_idmap_setup_done, req);
-	return req;
+}
+
+static struct wb_sids2xids_state *wb_sids2xids_find_in_flight(
+	const struct dom_sid *sid)
+{
+	struct wb_sids2xids_state *s = NULL;
+	uint32_t i;
+
+	for (s = wb_sids2xids_in_flight; s != NULL; s = s->next) {
+		for (i = 0; i < s->num_sids; i++) {
+			if (!s->resolving[i]) {
+				/* s found it in the cache, not resolving it */
+				continue;
+			}
+			if (dom_sid_equal(&s->sids[i], sid)) {
+				return s;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+static int wb_sids2xids_waiter_destructor(struct wb_sids2xids_waiter *w)
+{
+	if (w->leader != NULL) {
+		DLIST_REMOVE(w->leader->waiters, w);
+		w->leader = NULL;
+	}
+	return 0;
+}
+
+/*
+ * Wait for in-flight requests if they are resolving all the SIDs we
+ * did not find in the cache.
+ */
+static bool wb_sids2xids_coalesce(struct tevent_req *req)
+{
+	struct wb_sids2xids_state *state = tevent_req_data(
+		req, struct wb_sids2xids_state);
+	struct wb_sids2xids_state **leaders = NULL;
+	uint32_t i, j, num_leaders = 0;
+
+	if (wb_sids2xids_in_flight == NULL || !winbindd_use_idmap_cache()) {
+		return false;
+	}
+
+	leaders = talloc_array(state,
+			       struct wb_sids2xids_state *,
+			       state->num_sids);
+	if (leaders == NULL) {
+		return false;
+	}
+
+	for (i = 0; i < state->num_sids; i++) {
+		struct wb_sids2xids_state *leader = NULL;
+
+		if (state->all_ids.ids[i].domain_index == UINT32_MAX) {
+			/* already filled from the cache */
+			continue;
+		}
+
+		leader = wb_sids2xids_find_in_flight(&state->sids[i]);
+		if (leader == NULL) {
+			TALLOC_FREE(leaders);
+			return false;
+		}
+
+		for (j = 0; j < num_leaders; j++) {
+			if (leaders[j] == leader) {
+				break;
+			}
+		}
+		if (j == num_leaders) {
+			leaders[num_leaders++] = leader;
+		}
+	}
+
+	for (i = 0; i < num_leaders; i++) {
+		struct wb_sids2xids_waiter *w = NULL;
+
+		w = talloc_zero(state, struct wb_sids2xids_waiter);
+		if (w == NULL) {
+			/*
+			 * The waiters we already added just wake us
+			 * up early, that's fine.
+			 */
+			break;
+		}
+		w->leader = leaders[i];
+		w->req = req;
+		DLIST_ADD_END(leaders[i]->waiters, w);
+		talloc_set_destructor(w, wb_sids2xids_waiter_destructor);
+		state->num_waiting += 1;
+	}
+	TALLOC_FREE(leaders);
+
+	if (state->num_waiting == 0) {
+		return false;
+	}
+
+	wb_sids2xids_num_coalesced += 1;
+
+	D_DEBUG("Waiting for %"PRIu32" in-flight request(s) "
+		"(issued %"PRIu64", coalesced %"PRIu64")\n",
+		state->num_waiting,
+		wb_sids2xids_num_issued,
+		wb_sids2xids_num_coalesced);
+
+	return true;
+}
+
+/*
+ * All the requests we waited for are gone, look at the idmap cache
+ * again and only resolve what is still missing.
+ */
+static void wb_sids2xids_coalesced(struct tevent_req *req)
+{
+	struct wb_sids2xids_state *state = tevent_req_data(
+		req, struct wb_sids2xids_state);
+	uint32_t i;
+	bool missing = false;
+
+	/*
+	 * We are called from the cleanup function of another
+	 * request, don't run our callers callback from there.
+	 */
+	tevent_req_defer_callback(req, state->ev);
+
+	for (i = 0; i < state->num_sids; i++) {
+		struct wbint_TransID *cur_id = &state->all_ids.ids[i];
+		struct id_map map = { .status = ID_UNMAPPED, };
+
+		if (cur_id->domain_index == UINT32_MAX) {
+			continue;
+		}
+
+		if (!wb_sids2xids_in_cache(&state->sids[i], &map)) {
+			missing = true;
+			continue;
+		}
+
+		cur_id->xid = map.xid;
+		cur_id->domain_index = UINT32_MAX;
+	}
+
+	if (!missing) {
+		tevent_req_done(req);
+		return;
+	}
+
+	wb_sids2xids_start(req);
+}
+
+static void wb_sids2xids_cleanup(struct tevent_req *req,
+				 enum tevent_req_state req_state)
+{
+	struct wb_sids2xids_state *state = tevent_req_data(
+		req, struct wb_sids2xids_state);
+
+	if (state->in_flight) {
+		DLIST_REMOVE(wb_sids2xids_in_flight, state);
+		state->in_flight = false;
+	}
+
+	while (state->waiters != NULL) {
+		struct wb_sids2xids_waiter *w = state->waiters;
+		struct tevent_req *wreq = w->req;
+		struct wb_sids2xids_state *wstate = tevent_req_data(
+			wreq, struct wb_sids2xids_state);
+
+		DLIST_REMOVE(state->waiters, w);
+		w->leader = NULL;
+		TALLOC_FREE(w);
+
+		wstate->num_waiting -= 1;
+		if (wstate->num_waiting == 0) {
+			wb_sids2xids_coalesced(wreq);
+		}
+	}
 }
 
 static void wb_sids2xids_idmap_setup_done(struct tevent_req *subreq)
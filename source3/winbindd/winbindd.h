@@ -175,6 +175,18 @@ struct winbindd_domain {
 	struct tevent_queue *queue;
 	struct dcerpc_binding_handle *binding_handle;
 
+	/*
+	 * Statistics about the time requests spend in the domain
+	 * queue before being handed to a child. "busy" counts the
+	 * requests that found all children busy.
+	 */
+	struct {
+		uint64_t requests;
+		uint64_t busy;
+		uint64_t wait_usec_total;
+		uint64_t wait_usec_max;
+	} queue_stats;
+
 	struct tevent_req *check_online_event;
 
 	/* Linked list info */
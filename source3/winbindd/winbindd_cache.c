@@ -95,6 +95,9 @@ void winbindd_flush_caches(void)
            otherwise cached access denied errors due to restrict anonymous
            hang around until the sequence number changes. */
 
+	wb_getpwsid_flush_cache();
+	wb_gettoken_flush_cache();
+
 	if (!wcache_invalidate_cache()) {
 		DBG_ERR("invalidating the cache failed; revalidate the cache\n");
 		if (!winbindd_cache_validate_and_initialize()) {
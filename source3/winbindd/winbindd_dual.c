@@ -463,6 +463,8 @@ struct dcerpc_binding_handle *dom_child_handle(struct winbindd_domain *domain)
 struct wb_domain_request_state {
 	struct tevent_context *ev;
 	struct tevent_queue_entry *queue_entry;
+	struct timeval queue_start;
+	bool queue_busy;
 	struct winbindd_domain *domain;
 	struct winbindd_child *child;
 	struct winbindd_request *request;
@@ -513,6 +515,7 @@ struct tevent_req *wb_domain_request_send(TALLOC_CTX *mem_ctx,
 	state->domain = domain;
 	state->ev = ev;
 	state->request = request;
+	state->queue_start = timeval_current();
 
 	tevent_req_set_cleanup_fn(req, wb_domain_request_cleanup);
 
@@ -526,6 +529,36 @@ struct tevent_req *wb_domain_request_send(TALLOC_CTX *mem_ctx,
 	return req;
 }
 
+/*
+ * Only accounting: a child still handles one request at a time,
+ * concurrency per domain is "winbind max domain connections".
+ */
+static void wb_domain_request_queue_stats(
+	struct wb_domain_request_state *state)
+{
+	struct winbindd_domain *domain = state->domain;
+	struct timeval now = timeval_current();
+	int64_t diff = usec_time_diff(&now, &state->queue_start);
+	uint64_t wait_usec = MAX(diff, 0);
+
+	domain->queue_stats.requests += 1;
+	domain->queue_stats.wait_usec_total += wait_usec;
+	domain->queue_stats.wait_usec_max =
+		MAX(domain->queue_stats.wait_usec_max, wait_usec);
+
+	if (!state->queue_busy) {
+		return;
+	}
+
+	domain->queue_stats.busy += 1;
+
+	DBG_INFO("Request for domain %s waited %"PRIu64" usec "
+		 "for an idle child (%zu still queued)\n",
+		 domain->name,
+		 wait_usec,
+		 tevent_queue_length(domain->queue) - 1);
+}
+
 static void wb_domain_request_trigger(struct tevent_req *req,
 				      void *private_data)
 {
@@ -546,11 +579,14 @@ static void wb_domain_request_trigger(struct tevent_req *req,
 		 * and we get retriggered.
 		 */
 		state->child = NULL;
+		state->queue_busy = true;
 		tevent_queue_stop(state->domain->queue);
 		tevent_queue_entry_untrigger(state->queue_entry);
 		return;
 	}
 
+	wb_domain_request_queue_stats(state);
+
 	if (domain->initialized) {
 		subreq = wb_child_request_send(state, state->ev, state->child,
 					       state->request);
@@ -2029,6 +2065,9 @@ static void flush_caches_noinit(void)
 	 * are many domains..
 	 */
 
+	wb_getpwsid_flush_cache();
+	wb_gettoken_flush_cache();
+
 	if (!wcache_invalidate_cache_noinit()) {
 		DEBUG(0, ("invalidating the cache failed; revalidate the cache\n"));
 		if (!winbindd_cache_validate_and_initialize()) {
@@ -157,6 +157,14 @@ void ndr_print_winbindd_domain(struct ndr_print *ndr,
 	for (i=0; i<talloc_array_length(r->children); i++) {
 		ndr_print_winbindd_child(ndr, "children", &r->children[i]);
 	}
+	ndr_print_hyper(ndr, "queue_stats.requests", r->queue_stats.requests);
+	ndr_print_hyper(ndr, "queue_stats.busy", r->queue_stats.busy);
+	ndr_print_hyper(ndr,
+			"queue_stats.wait_usec_total",
+			r->queue_stats.wait_usec_total);
+	ndr_print_hyper(ndr,
+			"queue_stats.wait_usec_max",
+			r->queue_stats.wait_usec_max);
 	ndr_print_ptr(ndr, "check_online_event", r->check_online_event);
 	ndr->depth--;
 }
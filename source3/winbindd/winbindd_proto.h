@@ -640,6 +640,7 @@ struct tevent_req *wb_getpwsid_send(TALLOC_CTX *mem_ctx,
 				    const struct dom_sid *user_sid,
 				    struct winbindd_pw *pw);
 NTSTATUS wb_getpwsid_recv(struct tevent_req *req);
+void wb_getpwsid_flush_cache(void);
 
 struct tevent_req *winbindd_getpwsid_send(TALLOC_CTX *mem_ctx,
 					  struct tevent_context *ev,
@@ -692,6 +693,7 @@ struct tevent_req *wb_gettoken_send(TALLOC_CTX *mem_ctx,
 				    bool expand_local_aliases);
 NTSTATUS wb_gettoken_recv(struct tevent_req *req, TALLOC_CTX *mem_ctx,
 			  uint32_t *num_sids, struct dom_sid **sids);
+void wb_gettoken_flush_cache(void);
 struct tevent_req *winbindd_getgroups_send(TALLOC_CTX *mem_ctx,
 					   struct tevent_context *ev,
 					   struct winbindd_cli_state *cli,
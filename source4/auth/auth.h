@@ -126,6 +126,20 @@ NTSTATUS authsam_make_user_info_dc(TALLOC_CTX *mem_ctx, struct ldb_context *sam_
 					   const struct ldb_message *msg,
 					   DATA_BLOB user_sess_key, DATA_BLOB lm_sess_key,
 				  struct auth_user_info_dc **_user_info_dc);
+struct db_context;
+struct db_context *authsam_group_cache_open(TALLOC_CTX *mem_ctx,
+					    struct loadparm_context *lp_ctx);
+NTSTATUS authsam_make_user_info_dc_cached(TALLOC_CTX *mem_ctx,
+					  struct ldb_context *sam_ctx,
+					  struct db_context *group_cache,
+					  const char *netbios_name,
+					  const char *domain_name,
+					  const char *dns_domain_name,
+					  struct ldb_dn *domain_dn,
+					  const struct ldb_message *msg,
+					  DATA_BLOB user_sess_key,
+					  DATA_BLOB lm_sess_key,
+					  struct auth_user_info_dc **_user_info_dc);
 NTSTATUS authsam_update_user_info_dc(TALLOC_CTX *mem_ctx,
 			struct ldb_context *sam_ctx,
 			struct auth_user_info_dc *user_info_dc);
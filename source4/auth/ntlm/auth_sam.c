@@ -42,6 +42,7 @@
 #include "auth/kerberos/kerberos.h"
 #include "kdc/authn_policy_util.h"
 #include "kdc/db-glue.h"
+#include "lib/util/memcache.h"
 
 #undef DBGC_CLASS
 #define DBGC_CLASS DBGC_AUTH
@@ -970,6 +971,261 @@ static NTSTATUS authsam_authenticate(struct auth4_context *auth_context,
 
 
 
+/*
+ * NTLM logons come in at a much higher rate than anything else and
+ * mostly for the same accounts. Each process keeps the account
+ * messages found by authsam_search_account() in a memcache, keyed by
+ * the domain and account name.
+ *
+ * The cache is flushed whenever the uSNHighest of the domain partition
+ * changes, that covers changes to the password, userAccountControl,
+ * lockoutTime and the PSOs, made locally or replicated in. The
+ * non-replicated badPwdCount is not covered, but a failed logon sets
+ * the bad password indicator and both the failure and the success
+ * accounting re-read the account in a transaction before they write.
+ * Values computed from the current time (lockout and password expiry)
+ * are bounded by "auth:account cache lifetime", accounts that are
+ * locked out or have an expired password are not cached at all.
+ */
+#define AUTHSAM_ACCOUNT_CACHE_SIZE (4*1024*1024)
+#define AUTHSAM_ACCOUNT_CACHE_LIFETIME 60
+
+struct authsam_account_cache {
+	struct memcache *msgs;
+	uint64_t usn;
+	time_t lifetime;
+};
+
+struct authsam_cached_account {
+	time_t expires;
+	struct ldb_message *msg;
+};
+
+static struct authsam_account_cache *authsam_account_cache;
+
+static const char *authsam_secret_attrs[] = {
+	DSDB_SECRET_ATTRIBUTES,
+	NULL
+};
+
+static struct authsam_account_cache *authsam_account_cache_get(
+	struct auth4_context *auth_ctx)
+{
+	struct authsam_account_cache *cache = authsam_account_cache;
+	struct ldb_dn *domain_dn = NULL;
+	uint64_t usn = 0;
+	size_t size;
+	int ret;
+
+	if (cache == NULL) {
+		size = lpcfg_parm_ulong(auth_ctx->lp_ctx, NULL, "auth",
+					"account cache size",
+					AUTHSAM_ACCOUNT_CACHE_SIZE);
+		if (size == 0) {
+			return NULL;
+		}
+
+		cache = talloc_zero(NULL, struct authsam_account_cache);
+		if (cache == NULL) {
+			return NULL;
+		}
+		cache->lifetime = lpcfg_parm_int(auth_ctx->lp_ctx, NULL,
+						 "auth",
+						 "account cache lifetime",
+						 AUTHSAM_ACCOUNT_CACHE_LIFETIME);
+		if (cache->lifetime <= 0) {
+			TALLOC_FREE(cache);
+			return NULL;
+		}
+		cache->msgs = memcache_init(cache, size);
+		if (cache->msgs == NULL) {
+			TALLOC_FREE(cache);
+			return NULL;
+		}
+		authsam_account_cache = cache;
+	}
+
+	domain_dn = ldb_get_default_basedn(auth_ctx->sam_ctx);
+	if (domain_dn == NULL) {
+		return NULL;
+	}
+
+	ret = dsdb_load_partition_usn(auth_ctx->sam_ctx, domain_dn, &usn, NULL);
+	if (ret != LDB_SUCCESS) {
+		DBG_NOTICE("Failed to load uSNHighest: %s\n",
+			   ldb_strerror(ret));
+		memcache_flush(cache->msgs, AUTHSAM_ACCOUNT_CACHE_TALLOC);
+		cache->usn = 0;
+		return NULL;
+	}
+
+	if (usn != cache->usn) {
+		memcache_flush(cache->msgs, AUTHSAM_ACCOUNT_CACHE_TALLOC);
+		cache->usn = usn;
+	}
+
+	return cache;
+}
+
+/*
+ * Deep copy of msg with the secret attributes wiped on free
+ */
+static struct ldb_message *authsam_account_cache_copy_msg(
+	TALLOC_CTX *mem_ctx, const struct ldb_message *msg)
+{
+	struct ldb_message *copy = NULL;
+	size_t i;
+
+	copy = ldb_msg_copy(mem_ctx, msg);
+	if (copy == NULL) {
+		return NULL;
+	}
+
+	for (i = 0; authsam_secret_attrs[i] != NULL; i++) {
+		struct ldb_message_element *el = NULL;
+		unsigned int j;
+
+		el = ldb_msg_find_element(copy, authsam_secret_attrs[i]);
+		if (el == NULL) {
+			continue;
+		}
+		for (j = 0; j < el->num_values; j++) {
+			if (el->values[j].data != NULL) {
+				talloc_keep_secret(el->values[j].data);
+			}
+		}
+	}
+
+	return copy;
+}
+
+/*
+ * authsam_search_account() going through the account cache
+ */
+static NTSTATUS authsam_search_account_cached(TALLOC_CTX *mem_ctx,
+					      struct auth4_context *auth_ctx,
+					      const char *account_name,
+					      struct ldb_dn *domain_dn,
+					      struct ldb_message **ret_msg)
+{
+	struct authsam_account_cache *cache = NULL;
+	struct authsam_cached_account *cached = NULL;
+	const char *casefold = NULL;
+	uint32_t uac;
+	char *key = NULL;
+	NTSTATUS status;
+
+	cache = authsam_account_cache_get(auth_ctx);
+	if (cache == NULL) {
+		return authsam_search_account(mem_ctx, auth_ctx->sam_ctx,
+					      account_name, domain_dn,
+					      ret_msg);
+	}
+
+	casefold = ldb_dn_get_casefold(domain_dn);
+	if (casefold == NULL) {
+		return NT_STATUS_NO_MEMORY;
+	}
+	/* sAMAccountName is case insensitive */
+	key = strupper_talloc(mem_ctx, account_name);
+	if (key == NULL) {
+		return NT_STATUS_NO_MEMORY;
+	}
+	key = talloc_asprintf_append_buffer(key, "/%s", casefold);
+	if (key == NULL) {
+		return NT_STATUS_NO_MEMORY;
+	}
+
+	cached = memcache_lookup_talloc(cache->msgs,
+					AUTHSAM_ACCOUNT_CACHE_TALLOC,
+					data_blob_string_const(key));
+	if (cached != NULL && cached->expires > time(NULL)) {
+		*ret_msg = authsam_account_cache_copy_msg(mem_ctx,
+							  cached->msg);
+		TALLOC_FREE(key);
+		if (*ret_msg == NULL) {
+			return NT_STATUS_NO_MEMORY;
+		}
+		return NT_STATUS_OK;
+	}
+
+	status = authsam_search_account(mem_ctx, auth_ctx->sam_ctx,
+					account_name, domain_dn, ret_msg);
+	if (!NT_STATUS_IS_OK(status)) {
+		TALLOC_FREE(key);
+		return status;
+	}
+
+	uac = ldb_msg_find_attr_as_uint(*ret_msg,
+					"msDS-User-Account-Control-Computed",
+					0);
+	if (uac & (UF_LOCKOUT | UF_PASSWORD_EXPIRED)) {
+		memcache_delete(cache->msgs,
+				AUTHSAM_ACCOUNT_CACHE_TALLOC,
+				data_blob_string_const(key));
+		TALLOC_FREE(key);
+		return NT_STATUS_OK;
+	}
+
+	cached = talloc_zero(NULL, struct authsam_cached_account);
+	if (cached == NULL) {
+		TALLOC_FREE(key);
+		return NT_STATUS_OK;
+	}
+	cached->expires = time(NULL) + cache->lifetime;
+	cached->msg = authsam_account_cache_copy_msg(cached, *ret_msg);
+	if (cached->msg == NULL) {
+		TALLOC_FREE(cached);
+		TALLOC_FREE(key);
+		return NT_STATUS_OK;
+	}
+
+	memcache_add_talloc(cache->msgs,
+			    AUTHSAM_ACCOUNT_CACHE_TALLOC,
+			    data_blob_string_const(key),
+			    &cached);
+	TALLOC_FREE(key);
+	return NT_STATUS_OK;
+}
+
+/*
+ * The group cache from authsam_group_cache_open(), opened once per
+ * process.
+ */
+static struct db_context *authsam_ntlm_group_cache(
+	struct loadparm_context *lp_ctx)
+{
+	static struct db_context *group_cache;
+	static pid_t group_cache_pid;
+	static bool disabled;
+	pid_t pid = getpid();
+
+	if (disabled) {
+		return NULL;
+	}
+
+	if (group_cache != NULL && group_cache_pid == pid) {
+		return group_cache;
+	}
+
+	/* A tdb handle must not be used across a fork */
+	TALLOC_FREE(group_cache);
+
+	if (!lpcfg_parm_bool(lp_ctx, NULL, "auth", "group cache", true)) {
+		disabled = true;
+		return NULL;
+	}
+
+	group_cache = authsam_group_cache_open(NULL, lp_ctx);
+	if (group_cache == NULL) {
+		disabled = true;
+		return NULL;
+	}
+	group_cache_pid = pid;
+
+	return group_cache;
+}
+
 static NTSTATUS authsam_check_password_internals(struct auth_method_context *ctx,
 						 TALLOC_CTX *mem_ctx,
 						 const struct auth_usersupplied_info *user_info, 
@@ -1067,20 +1323,28 @@ static NTSTATUS authsam_check_password_internals(struct auth_method_context *ctx
 		account_name = nt4_account;
 	}
 
-	nt_status = authsam_search_account(tmp_ctx, ctx->auth_ctx->sam_ctx, account_name, domain_dn, &msg);
+	nt_status = authsam_search_account_cached(tmp_ctx,
+						  ctx->auth_ctx,
+						  account_name,
+						  domain_dn,
+						  &msg);
 	if (!NT_STATUS_IS_OK(nt_status)) {
 		talloc_free(tmp_ctx);
 		return nt_status;
 	}
 
-	nt_status = authsam_make_user_info_dc(tmp_ctx, ctx->auth_ctx->sam_ctx,
-					     lpcfg_netbios_name(ctx->auth_ctx->lp_ctx),
-					     lpcfg_sam_name(ctx->auth_ctx->lp_ctx),
-					     lpcfg_sam_dnsname(ctx->auth_ctx->lp_ctx),
-					     domain_dn,
-					     msg,
-					     data_blob_null, data_blob_null,
-					     user_info_dc);
+	nt_status = authsam_make_user_info_dc_cached(
+		tmp_ctx,
+		ctx->auth_ctx->sam_ctx,
+		authsam_ntlm_group_cache(ctx->auth_ctx->lp_ctx),
+		lpcfg_netbios_name(ctx->auth_ctx->lp_ctx),
+		lpcfg_sam_name(ctx->auth_ctx->lp_ctx),
+		lpcfg_sam_dnsname(ctx->auth_ctx->lp_ctx),
+		domain_dn,
+		msg,
+		data_blob_null,
+		data_blob_null,
+		user_info_dc);
 	if (!NT_STATUS_IS_OK(nt_status)) {
 		talloc_free(tmp_ctx);
 		return nt_status;
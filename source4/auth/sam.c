@@ -32,6 +32,7 @@
 #include "param/param.h"
 #include "librpc/gen_ndr/ndr_winbind_c.h"
 #include "lib/dbwrap/dbwrap.h"
+#include "lib/util/util_tdb.h"
 #include "cluster/cluster.h"
 
 #undef DBGC_CLASS
@@ -349,25 +350,22 @@ static NTSTATUS authsam_domain_group_filter(TALLOC_CTX *mem_ctx,
 	return NT_STATUS_OK;
 }
 
-_PUBLIC_ NTSTATUS authsam_make_user_info_dc(TALLOC_CTX *mem_ctx,
-					   struct ldb_context *sam_ctx,
-					   const char *netbios_name,
-					   const char *domain_name,
-					   const char *dns_domain_name,
-					   struct ldb_dn *domain_dn,
-					   const struct ldb_message *msg,
-					   DATA_BLOB user_sess_key,
-					   DATA_BLOB lm_sess_key,
-					   struct auth_user_info_dc **_user_info_dc)
+/*
+ * Expand the domain group memberships of the account in msg: the
+ * primary group and everything reachable through memberOf, leaving
+ * out builtin groups.
+ */
+static NTSTATUS authsam_expand_domain_groups(TALLOC_CTX *mem_ctx,
+					     struct ldb_context *sam_ctx,
+					     const struct ldb_message *msg,
+					     const struct dom_sid *account_sid,
+					     const struct dom_sid *domain_sid,
+					     struct auth_SidAttr **_sids,
+					     uint32_t *_num_sids)
 {
 	NTSTATUS status;
 	int ret;
-	struct auth_user_info_dc *user_info_dc;
-	struct auth_user_info *info;
-	const char *str = NULL;
 	char *filter = NULL;
-	/* SIDs for the account and his primary group */
-	struct dom_sid *account_sid;
 	struct dom_sid_buf buf;
 	const char *primary_group_dn_str = NULL;
 	DATA_BLOB primary_group_blob;
@@ -378,21 +376,12 @@ _PUBLIC_ NTSTATUS authsam_make_user_info_dc(TALLOC_CTX *mem_ctx,
 	struct auth_SidAttr *sids = NULL;
 	uint32_t num_sids = 0;
 	unsigned int i;
-	struct dom_sid *domain_sid;
 	TALLOC_CTX *tmp_ctx;
 	struct ldb_message_element *el;
 	static const char * const group_type_attrs[] = { "groupType", NULL };
 
-	if (msg == NULL) {
-		return NT_STATUS_INVALID_PARAMETER;
-	}
-
-	user_info_dc = talloc_zero(mem_ctx, struct auth_user_info_dc);
-	NT_STATUS_HAVE_NO_MEMORY(user_info_dc);
-
-	tmp_ctx = talloc_new(user_info_dc);
+	tmp_ctx = talloc_new(mem_ctx);
 	if (tmp_ctx == NULL) {
-		TALLOC_FREE(user_info_dc);
 		return NT_STATUS_NO_MEMORY;
 	}
 
@@ -401,26 +390,14 @@ _PUBLIC_ NTSTATUS authsam_make_user_info_dc(TALLOC_CTX *mem_ctx,
 	 * primary group, and a copy of the latter if it's not a resource
 	 * group. Allocate enough memory for these three SIDs.
 	 */
-	sids = talloc_zero_array(user_info_dc, struct auth_SidAttr, 3);
+	sids = talloc_zero_array(mem_ctx, struct auth_SidAttr, 3);
 	if (sids == NULL) {
-		TALLOC_FREE(user_info_dc);
+		TALLOC_FREE(tmp_ctx);
 		return NT_STATUS_NO_MEMORY;
 	}
 
 	num_sids = 2;
 
-	account_sid = samdb_result_dom_sid(tmp_ctx, msg, "objectSid");
-	if (account_sid == NULL) {
-		TALLOC_FREE(user_info_dc);
-		return NT_STATUS_NO_MEMORY;
-	}
-
-	status = dom_sid_split_rid(tmp_ctx, account_sid, &domain_sid, NULL);
-	if (!NT_STATUS_IS_OK(status)) {
-		talloc_free(user_info_dc);
-		return status;
-	}
-
 	sids[PRIMARY_USER_SID_INDEX].sid = *account_sid;
 	sids[PRIMARY_USER_SID_INDEX].attrs = SE_GROUP_DEFAULT_FLAGS;
 	sids[PRIMARY_GROUP_SID_INDEX].sid = *domain_sid;
@@ -434,8 +411,7 @@ _PUBLIC_ NTSTATUS authsam_make_user_info_dc(TALLOC_CTX *mem_ctx,
 	 */
 	status = authsam_domain_group_filter(tmp_ctx, &filter);
 	if (!NT_STATUS_IS_OK(status)) {
-		TALLOC_FREE(user_info_dc);
-		return status;
+		goto fail;
 	}
 
 	primary_group_dn_str = talloc_asprintf(
@@ -443,15 +419,15 @@ _PUBLIC_ NTSTATUS authsam_make_user_info_dc(TALLOC_CTX *mem_ctx,
 		"<SID=%s>",
 		dom_sid_str_buf(&sids[PRIMARY_GROUP_SID_INDEX].sid, &buf));
 	if (primary_group_dn_str == NULL) {
-		TALLOC_FREE(user_info_dc);
-		return NT_STATUS_NO_MEMORY;
+		status = NT_STATUS_NO_MEMORY;
+		goto fail;
 	}
 
 	/* Get the DN of the primary group. */
 	primary_group_dn = ldb_dn_new(tmp_ctx, sam_ctx, primary_group_dn_str);
 	if (primary_group_dn == NULL) {
-		TALLOC_FREE(user_info_dc);
-		return NT_STATUS_NO_MEMORY;
+		status = NT_STATUS_NO_MEMORY;
+		goto fail;
 	}
 
 	/*
@@ -466,8 +442,8 @@ _PUBLIC_ NTSTATUS authsam_make_user_info_dc(TALLOC_CTX *mem_ctx,
 			      0,
 			      NULL);
 	if (ret != LDB_SUCCESS) {
-		talloc_free(user_info_dc);
-		return NT_STATUS_INTERNAL_DB_CORRUPTION;
+		status = NT_STATUS_INTERNAL_DB_CORRUPTION;
+		goto fail;
 	}
 
 	/* Check the type of the primary group. */
@@ -501,10 +477,9 @@ _PUBLIC_ NTSTATUS authsam_make_user_info_dc(TALLOC_CTX *mem_ctx,
 	 * 'only childs' flag to true
 	 */
 	status = dsdb_expand_nested_groups(sam_ctx, &primary_group_blob, true, filter,
-					   user_info_dc, &sids, &num_sids);
+					   mem_ctx, &sids, &num_sids);
 	if (!NT_STATUS_IS_OK(status)) {
-		talloc_free(user_info_dc);
-		return status;
+		goto fail;
 	}
 
 	/* Expands the additional groups */
@@ -514,13 +489,413 @@ _PUBLIC_ NTSTATUS authsam_make_user_info_dc(TALLOC_CTX *mem_ctx,
 		 * them, as long as they meet the filter - so only
 		 * domain groups, not builtin groups */
 		status = dsdb_expand_nested_groups(sam_ctx, &el->values[i], false, filter,
-						   user_info_dc, &sids, &num_sids);
+						   mem_ctx, &sids, &num_sids);
 		if (!NT_STATUS_IS_OK(status)) {
-			talloc_free(user_info_dc);
-			return status;
+			goto fail;
+		}
+	}
+
+	TALLOC_FREE(tmp_ctx);
+	*_sids = sids;
+	*_num_sids = num_sids;
+	return NT_STATUS_OK;
+
+fail:
+	TALLOC_FREE(sids);
+	TALLOC_FREE(tmp_ctx);
+	return status;
+}
+
+/*
+ * The group cache remembers the result of authsam_expand_domain_groups()
+ * per account SID in a tdb under the tmp directory, so that all
+ * processes (e.g. the prefork KDC workers) share it.
+ *
+ * A record is only used while the uSNHighest of the domain partition
+ * is unchanged. Any change to a group membership, whether made locally
+ * or by inbound replication, bumps it, while the logon bookkeeping
+ * (lastLogon, logonCount, badPwdCount) is not replicated and leaves it
+ * alone. As the account message may have been read before the USN,
+ * the record also holds the primaryGroupID and memberOf values the
+ * expansion started from, and is ignored if they differ.
+ *
+ * A record that is found to be stale is deleted. The cache also
+ * remembers the uSNHighest its records were stored under, and is
+ * wiped when a record for a newer one is stored, so it never holds
+ * more than the accounts seen since the last change.
+ */
+struct authsam_group_cache_record {
+	uint64_t usn;
+	uint32_t inputs_len;
+	uint32_t num_sids;
+	/*
+	 * Followed by inputs_len bytes of inputs and num_sids struct
+	 * auth_SidAttr.
+	 */
+};
+
+#define AUTHSAM_GROUP_CACHE_USN_KEY "USN"
+
+_PUBLIC_ struct db_context *authsam_group_cache_open(
+	TALLOC_CTX *mem_ctx,
+	struct loadparm_context *lp_ctx)
+{
+	struct db_context *db_ctx = NULL;
+
+	db_ctx = cluster_db_tmp_open(mem_ctx, lp_ctx, "group_cache",
+				     TDB_DEFAULT);
+	if (db_ctx == NULL) {
+		DBG_ERR("Unable to open group cache database\n");
+		return NULL;
+	}
+	return db_ctx;
+}
+
+static NTSTATUS authsam_group_cache_inputs(TALLOC_CTX *mem_ctx,
+					   const struct ldb_message *msg,
+					   DATA_BLOB *_inputs)
+{
+	struct ldb_message_element *el = NULL;
+	uint32_t primary_group_id;
+	DATA_BLOB inputs;
+	size_t len = sizeof(uint32_t);
+	size_t ofs;
+	unsigned int i;
+
+	el = ldb_msg_find_element(msg, "memberOf");
+	for (i = 0; el && i < el->num_values; i++) {
+		len += sizeof(uint32_t) + el->values[i].length;
+		if (len > UINT32_MAX) {
+			return NT_STATUS_INTEGER_OVERFLOW;
 		}
 	}
 
+	inputs = data_blob_talloc(mem_ctx, NULL, len);
+	if (inputs.data == NULL) {
+		return NT_STATUS_NO_MEMORY;
+	}
+
+	primary_group_id = ldb_msg_find_attr_as_uint(msg, "primaryGroupID", ~0);
+	memcpy(inputs.data, &primary_group_id, sizeof(uint32_t));
+	ofs = sizeof(uint32_t);
+
+	for (i = 0; el && i < el->num_values; i++) {
+		uint32_t vlen = el->values[i].length;
+
+		memcpy(inputs.data + ofs, &vlen, sizeof(uint32_t));
+		ofs += sizeof(uint32_t);
+		memcpy(inputs.data + ofs, el->values[i].data, vlen);
+		ofs += vlen;
+	}
+
+	*_inputs = inputs;
+	return NT_STATUS_OK;
+}
+
+static bool authsam_group_cache_fetch(struct db_context *db,
+				      TALLOC_CTX *mem_ctx,
+				      TDB_DATA key,
+				      uint64_t usn,
+				      DATA_BLOB inputs,
+				      struct auth_SidAttr **_sids,
+				      uint32_t *_num_sids)
+{
+	struct authsam_group_cache_record rec;
+	struct auth_SidAttr *sids = NULL;
+	TDB_DATA value = {0};
+	size_t ofs = sizeof(rec);
+	NTSTATUS status;
+
+	status = dbwrap_fetch(db, mem_ctx, key, &value);
+	if (!NT_STATUS_IS_OK(status)) {
+		return false;
+	}
+
+	if (value.dsize < sizeof(rec)) {
+		goto miss;
+	}
+	memcpy(&rec, value.dptr, sizeof(rec));
+
+	if (rec.usn > usn) {
+		/* Stored by someone who saw a newer uSNHighest */
+		TALLOC_FREE(value.dptr);
+		return false;
+	}
+	if (rec.usn != usn || rec.inputs_len != inputs.length) {
+		goto miss;
+	}
+	if (rec.num_sids < 2 ||
+	    value.dsize != sizeof(rec) + rec.inputs_len +
+			   (size_t)rec.num_sids * sizeof(struct auth_SidAttr)) {
+		goto miss;
+	}
+	if (memcmp(value.dptr + ofs, inputs.data, inputs.length) != 0) {
+		goto miss;
+	}
+	ofs += rec.inputs_len;
+
+	sids = talloc_array(mem_ctx, struct auth_SidAttr, rec.num_sids);
+	if (sids == NULL) {
+		TALLOC_FREE(value.dptr);
+		return false;
+	}
+	memcpy(sids,
+	       value.dptr + ofs,
+	       rec.num_sids * sizeof(struct auth_SidAttr));
+
+	TALLOC_FREE(value.dptr);
+	*_sids = sids;
+	*_num_sids = rec.num_sids;
+	return true;
+
+miss:
+	TALLOC_FREE(value.dptr);
+
+	/* It can't be used any more, don't let it take up space */
+	status = dbwrap_delete(db, key);
+	if (!NT_STATUS_IS_OK(status) &&
+	    !NT_STATUS_EQUAL(status, NT_STATUS_NOT_FOUND)) {
+		DBG_NOTICE("Unable to delete stale group cache record: %s\n",
+			   nt_errstr(status));
+	}
+	return false;
+}
+
+/*
+ * Make the cache hold records for usn only. Returns false if the
+ * cache already moved on to a newer usn, then a record for usn is
+ * stale before it is stored.
+ */
+static bool authsam_group_cache_set_usn(struct db_context *db,
+					uint64_t usn)
+{
+	TDB_DATA key = string_term_tdb_data(AUTHSAM_GROUP_CACHE_USN_KEY);
+	TDB_DATA value = {0};
+	uint64_t cache_usn = 0;
+	NTSTATUS status;
+	int ret;
+
+	status = dbwrap_fetch(db, NULL, key, &value);
+	if (NT_STATUS_IS_OK(status) && value.dsize == sizeof(cache_usn)) {
+		memcpy(&cache_usn, value.dptr, sizeof(cache_usn));
+	}
+	TALLOC_FREE(value.dptr);
+
+	if (cache_usn == usn) {
+		return true;
+	}
+	if (cache_usn > usn) {
+		return false;
+	}
+
+	/* All records are older than usn */
+	ret = dbwrap_wipe(db);
+	if (ret != 0) {
+		DBG_NOTICE("Unable to wipe the group cache\n");
+		return false;
+	}
+
+	value.dptr = (uint8_t *)&usn;
+	value.dsize = sizeof(usn);
+	status = dbwrap_store(db, key, value, 0);
+	if (!NT_STATUS_IS_OK(status)) {
+		DBG_NOTICE("Unable to store group cache USN: %s\n",
+			   nt_errstr(status));
+		return false;
+	}
+	return true;
+}
+
+static void authsam_group_cache_store(struct db_context *db,
+				      TDB_DATA key,
+				      uint64_t usn,
+				      DATA_BLOB inputs,
+				      const struct auth_SidAttr *sids,
+				      uint32_t num_sids)
+{
+	struct authsam_group_cache_record rec = {
+		.usn = usn,
+		.inputs_len = inputs.length,
+		.num_sids = num_sids,
+	};
+	size_t sids_len = num_sids * sizeof(struct auth_SidAttr);
+	TDB_DATA value;
+	NTSTATUS status;
+
+	if (!authsam_group_cache_set_usn(db, usn)) {
+		return;
+	}
+
+	value.dsize = sizeof(rec) + inputs.length + sids_len;
+	value.dptr = talloc_size(NULL, value.dsize);
+	if (value.dptr == NULL) {
+		return;
+	}
+	memcpy(value.dptr, &rec, sizeof(rec));
+	memcpy(value.dptr + sizeof(rec), inputs.data, inputs.length);
+	memcpy(value.dptr + sizeof(rec) + inputs.length, sids, sids_len);
+
+	status = dbwrap_store(db, key, value, 0);
+	TALLOC_FREE(value.dptr);
+	if (!NT_STATUS_IS_OK(status)) {
+		DBG_NOTICE("Unable to store group cache record: %s\n",
+			   nt_errstr(status));
+	}
+}
+
+/*
+ * authsam_expand_domain_groups() going through the group cache, if
+ * there is one.
+ */
+static NTSTATUS authsam_get_domain_groups(TALLOC_CTX *mem_ctx,
+					  struct ldb_context *sam_ctx,
+					  struct db_context *group_cache,
+					  struct ldb_dn *domain_dn,
+					  const struct ldb_message *msg,
+					  const struct dom_sid *account_sid,
+					  const struct dom_sid *domain_sid,
+					  struct auth_SidAttr **_sids,
+					  uint32_t *_num_sids)
+{
+	TALLOC_CTX *tmp_ctx = NULL;
+	struct dom_sid_buf buf;
+	DATA_BLOB inputs;
+	TDB_DATA key;
+	uint64_t usn = 0;
+	uint64_t usn_after = 0;
+	NTSTATUS status;
+	int ret;
+	bool ok;
+
+	if (group_cache == NULL || domain_dn == NULL) {
+		return authsam_expand_domain_groups(mem_ctx, sam_ctx, msg,
+						    account_sid, domain_sid,
+						    _sids, _num_sids);
+	}
+
+	ret = dsdb_load_partition_usn(sam_ctx, domain_dn, &usn, NULL);
+	if (ret != LDB_SUCCESS) {
+		DBG_NOTICE("Failed to load uSNHighest of %s: %s\n",
+			   ldb_dn_get_linearized(domain_dn),
+			   ldb_strerror(ret));
+		return authsam_expand_domain_groups(mem_ctx, sam_ctx, msg,
+						    account_sid, domain_sid,
+						    _sids, _num_sids);
+	}
+
+	tmp_ctx = talloc_new(mem_ctx);
+	if (tmp_ctx == NULL) {
+		return NT_STATUS_NO_MEMORY;
+	}
+
+	status = authsam_group_cache_inputs(tmp_ctx, msg, &inputs);
+	if (!NT_STATUS_IS_OK(status)) {
+		TALLOC_FREE(tmp_ctx);
+		return status;
+	}
+
+	dom_sid_str_buf(account_sid, &buf);
+	key.dptr = (unsigned char *)buf.buf;
+	key.dsize = strlen(buf.buf);
+
+	ok = authsam_group_cache_fetch(group_cache, mem_ctx, key, usn, inputs,
+				       _sids, _num_sids);
+	if (ok) {
+		DBG_DEBUG("Using cached groups of %s\n", buf.buf);
+		TALLOC_FREE(tmp_ctx);
+		return NT_STATUS_OK;
+	}
+
+	status = authsam_expand_domain_groups(mem_ctx, sam_ctx, msg,
+					      account_sid, domain_sid,
+					      _sids, _num_sids);
+	if (!NT_STATUS_IS_OK(status)) {
+		TALLOC_FREE(tmp_ctx);
+		return status;
+	}
+
+	/*
+	 * Only remember the result if nothing changed while we were
+	 * walking the groups.
+	 */
+	ret = dsdb_load_partition_usn(sam_ctx, domain_dn, &usn_after, NULL);
+	if (ret == LDB_SUCCESS && usn_after == usn) {
+		authsam_group_cache_store(group_cache, key, usn, inputs,
+					  *_sids, *_num_sids);
+	}
+
+	TALLOC_FREE(tmp_ctx);
+	return NT_STATUS_OK;
+}
+
+/*
+ * As authsam_make_user_info_dc(), but looking up the domain groups of
+ * the account in group_cache (from authsam_group_cache_open()) first.
+ */
+_PUBLIC_ NTSTATUS authsam_make_user_info_dc_cached(
+	TALLOC_CTX *mem_ctx,
+	struct ldb_context *sam_ctx,
+	struct db_context *group_cache,
+	const char *netbios_name,
+	const char *domain_name,
+	const char *dns_domain_name,
+	struct ldb_dn *domain_dn,
+	const struct ldb_message *msg,
+	DATA_BLOB user_sess_key,
+	DATA_BLOB lm_sess_key,
+	struct auth_user_info_dc **_user_info_dc)
+{
+	NTSTATUS status;
+	struct auth_user_info_dc *user_info_dc;
+	struct auth_user_info *info;
+	const char *str = NULL;
+	/* SIDs for the account and his primary group */
+	struct dom_sid *account_sid;
+	/* SID structures for the expanded group memberships */
+	struct auth_SidAttr *sids = NULL;
+	uint32_t num_sids = 0;
+	struct dom_sid *domain_sid;
+	TALLOC_CTX *tmp_ctx;
+
+	if (msg == NULL) {
+		return NT_STATUS_INVALID_PARAMETER;
+	}
+
+	user_info_dc = talloc_zero(mem_ctx, struct auth_user_info_dc);
+	NT_STATUS_HAVE_NO_MEMORY(user_info_dc);
+
+	tmp_ctx = talloc_new(user_info_dc);
+	if (tmp_ctx == NULL) {
+		TALLOC_FREE(user_info_dc);
+		return NT_STATUS_NO_MEMORY;
+	}
+
+	account_sid = samdb_result_dom_sid(tmp_ctx, msg, "objectSid");
+	if (account_sid == NULL) {
+		TALLOC_FREE(user_info_dc);
+		return NT_STATUS_NO_MEMORY;
+	}
+
+	status = dom_sid_split_rid(tmp_ctx, account_sid, &domain_sid, NULL);
+	if (!NT_STATUS_IS_OK(status)) {
+		talloc_free(user_info_dc);
+		return status;
+	}
+
+	status = authsam_get_domain_groups(user_info_dc,
+					   sam_ctx,
+					   group_cache,
+					   domain_dn,
+					   msg,
+					   account_sid,
+					   domain_sid,
+					   &sids,
+					   &num_sids);
+	if (!NT_STATUS_IS_OK(status)) {
+		talloc_free(user_info_dc);
+		return status;
+	}
+
 	user_info_dc->sids = sids;
 	user_info_dc->num_sids = num_sids;
 
@@ -687,6 +1062,30 @@ _PUBLIC_ NTSTATUS authsam_make_user_info_dc(TALLOC_CTX *mem_ctx,
 	return NT_STATUS_OK;
 }
 
+_PUBLIC_ NTSTATUS authsam_make_user_info_dc(TALLOC_CTX *mem_ctx,
+					   struct ldb_context *sam_ctx,
+					   const char *netbios_name,
+					   const char *domain_name,
+					   const char *dns_domain_name,
+					   struct ldb_dn *domain_dn,
+					   const struct ldb_message *msg,
+					   DATA_BLOB user_sess_key,
+					   DATA_BLOB lm_sess_key,
+					   struct auth_user_info_dc **_user_info_dc)
+{
+	return authsam_make_user_info_dc_cached(mem_ctx,
+						sam_ctx,
+						NULL,
+						netbios_name,
+						domain_name,
+						dns_domain_name,
+						domain_dn,
+						msg,
+						user_sess_key,
+						lm_sess_key,
+						_user_info_dc);
+}
+
 _PUBLIC_ NTSTATUS authsam_update_user_info_dc(TALLOC_CTX *mem_ctx,
 			struct ldb_context *sam_ctx,
 			struct auth_user_info_dc *user_info_dc)
@@ -1046,13 +1445,37 @@ NTSTATUS authsam_reread_user_logon_data(
 	return NT_STATUS_OK;
 }
 
+/*
+ * The bad password attempts database is looked at for every successful
+ * logon, so it is opened only once per process. The handle is not
+ * owned by the caller, it stays open until
+ * authsam_reset_bad_password_db() is called.
+ */
+static struct db_context *authsam_bad_password_db = NULL;
+static pid_t authsam_bad_password_db_pid;
+
+static void authsam_reset_bad_password_db(void)
+{
+	TALLOC_FREE(authsam_bad_password_db);
+	authsam_bad_password_db_pid = 0;
+}
+
 static struct db_context *authsam_get_bad_password_db(
 	TALLOC_CTX *mem_ctx,
 	struct ldb_context *sam_ctx)
 {
 	struct loadparm_context *lp_ctx = NULL;
 	const char *db_name = "bad_password";
-	struct db_context *db_ctx =  NULL;
+	struct db_context *db_ctx = NULL;
+	pid_t pid = getpid();
+
+	if (authsam_bad_password_db != NULL &&
+	    authsam_bad_password_db_pid == pid) {
+		return authsam_bad_password_db;
+	}
+
+	/* A tdb handle must not be used across a fork */
+	authsam_reset_bad_password_db();
 
 	lp_ctx = ldb_get_opaque(sam_ctx, "loadparm");
 	if (lp_ctx == NULL) {
@@ -1060,11 +1483,13 @@ static struct db_context *authsam_get_bad_password_db(
 		return NULL;
 	}
 
-	db_ctx = cluster_db_tmp_open(mem_ctx, lp_ctx, db_name, TDB_DEFAULT);
+	db_ctx = cluster_db_tmp_open(NULL, lp_ctx, db_name, TDB_DEFAULT);
 	if (db_ctx == NULL) {
 		DBG_ERR("Unable to open bad password attempts database\n");
 		return NULL;
 	}
+	authsam_bad_password_db = db_ctx;
+	authsam_bad_password_db_pid = pid;
 	return db_ctx;
 }
 
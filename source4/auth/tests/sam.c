@@ -342,12 +342,23 @@ static int setup(void **state) {
 	struct context *ctx = talloc_zero(NULL, struct context);
 	init_mock_results(ctx);
 
+	/*
+	 * authsam_get_bad_password_db() keeps the handle for the
+	 * process, every test has to start with no handle open.
+	 */
+	assert_null(authsam_bad_password_db);
+
 	*state = ctx;
 	return 0;
 }
 
 static int teardown(void **state) {
 	struct context *ctx = *state;
+	/*
+	 * The cached handle is the mock database of this test, drop
+	 * it before the test context it was allocated on is freed.
+	 */
+	authsam_reset_bad_password_db();
 	TALLOC_FREE(ctx);
 	return 0;
 }
@@ -2223,6 +2234,48 @@ static void test_get_bad_password_db_open_failed(void **state) {
 	TALLOC_FREE(ctx);
 }
 
+/*
+ * get_bad_password_db
+ *
+ * The database is opened once and the handle is kept until it is reset.
+ */
+static void test_get_bad_password_db_kept_open(void **state) {
+	struct ldb_context *ldb = NULL;
+	TALLOC_CTX *ctx = NULL;
+	struct db_context *db1 = NULL;
+	struct db_context *db2 = NULL;
+	struct db_context *mock_db = cluster_db_tmp_open_ret;
+
+	ctx = talloc_new(*state);
+	assert_non_null(ctx);
+
+	ldb = ldb_init(ctx, NULL);
+	assert_non_null(ldb);
+
+	db1 = authsam_get_bad_password_db(ctx, ldb);
+	assert_ptr_equal(mock_db, db1);
+
+	/*
+	 * Opening the database again would now fail, the kept handle
+	 * has to be returned
+	 */
+	cluster_db_tmp_open_ret = NULL;
+	db2 = authsam_get_bad_password_db(ctx, ldb);
+	assert_ptr_equal(db1, db2);
+
+	/*
+	 * Once reset, the database has to be opened again
+	 */
+	authsam_reset_bad_password_db();
+	db2 = authsam_get_bad_password_db(ctx, ldb);
+	assert_null(db2);
+
+	/*
+	 * Clean up
+	 */
+	TALLOC_FREE(ctx);
+}
+
 /*
  * set_bad_password_indicator
  *
@@ -2703,6 +2756,10 @@ int main(int argc, const char **argv)
 			test_get_bad_password_db_open_failed,
 			setup,
 			teardown),
+		cmocka_unit_test_setup_teardown(
+			test_get_bad_password_db_kept_open,
+			setup,
+			teardown),
 		cmocka_unit_test_setup_teardown(
 			test_set_bad_password_indicator_get_db_failed,
 			setup,
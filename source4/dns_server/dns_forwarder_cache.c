@@ -0,0 +1,357 @@
+/*
+   Unix SMB/CIFS implementation.
+
+   In-memory cache of replies from the DNS forwarders
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Every query we are not authoritative for used to cost a round trip
+ * to the "dns forwarder". Here we keep the replies, keyed by the
+ * lowercased name, type and class of the question.
+ *
+ * A positive reply is kept for the lowest TTL of its answers, a
+ * negative one (no answers, RFC 2308) for the lower of the TTL and the
+ * minimum field of the SOA record in the authority section. Negative
+ * replies without a SOA record are not cached. Both are capped by
+ * "dns:forwarder cache max ttl" and "dns:forwarder cache max negative
+ * ttl", the TTLs handed out are reduced by the time spent in the
+ * cache.
+ *
+ * The replies are stored NDR encoded in a memcache bounded by "dns:
+ * forwarder cache size", the least recently used ones are dropped
+ * first. An entry asked for more than once that gets close to its
+ * expiry is refreshed in the background by the caller, so that
+ * popular names never miss.
+ */
+
+#include "includes.h"
+#include "librpc/ndr/libndr.h"
+#include "librpc/gen_ndr/ndr_dns.h"
+#include "param/param.h"
+#include "samba/service_task.h"
+#include "dns_server/dns_server.h"
+#include "lib/util/memcache.h"
+
+#undef DBGC_CLASS
+#define DBGC_CLASS DBGC_DNS
+
+#define DNS_FORWARDER_CACHE_SIZE (4*1024*1024)
+#define DNS_FORWARDER_CACHE_MAX_TTL 86400
+#define DNS_FORWARDER_CACHE_MAX_NEGATIVE_TTL 10800
+
+/* An entry needs this many hits before it is prefetched */
+#define DNS_FORWARDER_CACHE_PREFETCH_HITS 2
+
+struct dns_forwarder_cache {
+	struct memcache *replies;
+	size_t size;
+	uint32_t max_ttl;
+	uint32_t max_negative_ttl;
+};
+
+/*
+ * Stored in front of the NDR encoded reply
+ */
+struct dns_forwarder_cache_entry {
+	time_t stored;
+	uint32_t ttl;
+	uint32_t hits;
+	bool prefetching;
+};
+
+NTSTATUS dns_forwarder_cache_init(struct dns_server *dns)
+{
+	struct loadparm_context *lp_ctx = dns->task->lp_ctx;
+	struct dns_forwarder_cache *cache = NULL;
+
+	TALLOC_FREE(dns->forwarder_cache);
+
+	cache = talloc_zero(dns, struct dns_forwarder_cache);
+	if (cache == NULL) {
+		return NT_STATUS_NO_MEMORY;
+	}
+
+	cache->size = lpcfg_parm_ulong(lp_ctx, NULL, "dns",
+				       "forwarder cache size",
+				       DNS_FORWARDER_CACHE_SIZE);
+	if (cache->size == 0) {
+		DBG_INFO("Caching of forwarded queries is disabled\n");
+		TALLOC_FREE(cache);
+		return NT_STATUS_OK;
+	}
+	cache->max_ttl = lpcfg_parm_ulong(lp_ctx, NULL, "dns",
+					  "forwarder cache max ttl",
+					  DNS_FORWARDER_CACHE_MAX_TTL);
+	cache->max_negative_ttl = lpcfg_parm_ulong(
+		lp_ctx, NULL, "dns", "forwarder cache max negative ttl",
+		DNS_FORWARDER_CACHE_MAX_NEGATIVE_TTL);
+
+	cache->replies = memcache_init(cache, cache->size);
+	if (cache->replies == NULL) {
+		TALLOC_FREE(cache);
+		return NT_STATUS_NO_MEMORY;
+	}
+
+	dns->forwarder_cache = cache;
+	return NT_STATUS_OK;
+}
+
+static char *dns_forwarder_cache_key(TALLOC_CTX *mem_ctx,
+				     const struct dns_name_question *question)
+{
+	size_t len = strlen(question->name);
+	char *key = NULL;
+
+	/* "example.com." and "example.com" are the same name */
+	if (len > 0 && question->name[len - 1] == '.') {
+		len -= 1;
+	}
+
+	key = talloc_asprintf(mem_ctx,
+			      "%u/%u/%.*s",
+			      (unsigned)question->question_type,
+			      (unsigned)question->question_class,
+			      (int)len,
+			      question->name);
+	if (key == NULL) {
+		return NULL;
+	}
+
+	return strlower_talloc(mem_ctx, key);
+}
+
+/*
+ * How long we may keep the reply, 0 means not at all
+ */
+static uint32_t dns_forwarder_cache_ttl(const struct dns_forwarder_cache *cache,
+					const struct dns_name_packet *reply)
+{
+	uint32_t ttl = UINT32_MAX;
+	uint16_t rcode = reply->operation & DNS_RCODE;
+	uint16_t i;
+
+	if (rcode != DNS_RCODE_OK && rcode != DNS_RCODE_NXDOMAIN) {
+		/* Don't remember failures of the forwarder */
+		return 0;
+	}
+
+	if (reply->ancount > 0) {
+		for (i = 0; i < reply->ancount; i++) {
+			ttl = MIN(ttl, reply->answers[i].ttl);
+		}
+		return MIN(ttl, cache->max_ttl);
+	}
+
+	for (i = 0; i < reply->nscount; i++) {
+		const struct dns_res_rec *rec = &reply->nsrecs[i];
+
+		if (rec->rr_type != DNS_QTYPE_SOA) {
+			continue;
+		}
+		ttl = MIN(rec->ttl, rec->rdata.soa_record.minimum);
+		return MIN(ttl, cache->max_negative_ttl);
+	}
+
+	return 0;
+}
+
+static void dns_forwarder_cache_age_records(struct dns_res_rec *recs,
+					    uint16_t count,
+					    uint32_t age,
+					    uint32_t remaining)
+{
+	uint16_t i;
+
+	for (i = 0; i < count; i++) {
+		if (recs[i].rr_type == DNS_QTYPE_OPT) {
+			/* The TTL field holds the EDNS flags */
+			continue;
+		}
+		if (recs[i].ttl > age) {
+			recs[i].ttl -= age;
+		} else {
+			recs[i].ttl = 0;
+		}
+		recs[i].ttl = MIN(recs[i].ttl, remaining);
+	}
+}
+
+/*
+ * Look for a cached reply to question. On a hit *prefetch tells the
+ * caller to ask the forwarder again, so the entry gets replaced
+ * before it expires.
+ */
+bool dns_forwarder_cache_lookup(struct dns_server *dns,
+				TALLOC_CTX *mem_ctx,
+				const struct dns_name_question *question,
+				struct dns_name_packet **_reply,
+				bool *prefetch)
+{
+	struct dns_forwarder_cache *cache = dns->forwarder_cache;
+	struct dns_forwarder_cache_entry entry;
+	struct dns_name_packet *reply = NULL;
+	enum ndr_err_code ndr_err;
+	char *key = NULL;
+	DATA_BLOB value, blob;
+	time_t now = time(NULL);
+	uint32_t age, remaining;
+	bool ok;
+
+	*_reply = NULL;
+	*prefetch = false;
+
+	if (cache == NULL) {
+		return false;
+	}
+
+	key = dns_forwarder_cache_key(mem_ctx, question);
+	if (key == NULL) {
+		return false;
+	}
+
+	ok = memcache_lookup(cache->replies,
+			     DNS_FORWARDER_CACHE,
+			     data_blob_string_const(key),
+			     &value);
+	if (!ok || value.length < sizeof(entry)) {
+		TALLOC_FREE(key);
+		return false;
+	}
+	memcpy(&entry, value.data, sizeof(entry));
+
+	if ((now < entry.stored) || (now - entry.stored >= entry.ttl)) {
+		memcache_delete(cache->replies,
+				DNS_FORWARDER_CACHE,
+				data_blob_string_const(key));
+		TALLOC_FREE(key);
+		return false;
+	}
+	age = now - entry.stored;
+	remaining = entry.ttl - age;
+
+	reply = talloc_zero(mem_ctx, struct dns_name_packet);
+	if (reply == NULL) {
+		TALLOC_FREE(key);
+		return false;
+	}
+
+	blob = data_blob_const(value.data + sizeof(entry),
+			       value.length - sizeof(entry));
+	ndr_err = ndr_pull_struct_blob(
+		&blob, reply, reply,
+		(ndr_pull_flags_fn_t)ndr_pull_dns_name_packet);
+	if (!NDR_ERR_CODE_IS_SUCCESS(ndr_err)) {
+		DBG_WARNING("Failed to parse cached reply for %s: %s\n",
+			    question->name, ndr_errstr(ndr_err));
+		memcache_delete(cache->replies,
+				DNS_FORWARDER_CACHE,
+				data_blob_string_const(key));
+		TALLOC_FREE(key);
+		TALLOC_FREE(reply);
+		return false;
+	}
+
+	dns_forwarder_cache_age_records(reply->answers, reply->ancount,
+					age, remaining);
+	dns_forwarder_cache_age_records(reply->nsrecs, reply->nscount,
+					age, remaining);
+	dns_forwarder_cache_age_records(reply->additional, reply->arcount,
+					age, remaining);
+
+	entry.hits += 1;
+	if (!entry.prefetching &&
+	    (entry.hits >= DNS_FORWARDER_CACHE_PREFETCH_HITS) &&
+	    (remaining <= entry.ttl / 10)) {
+		/*
+		 * Only one prefetch per entry, its result replaces
+		 * this entry.
+		 */
+		entry.prefetching = true;
+		*prefetch = true;
+	}
+	memcpy(value.data, &entry, sizeof(entry));
+
+	DBG_DEBUG("Answering %s from the cache, %"PRIu32"s left\n",
+		  question->name, remaining);
+
+	TALLOC_FREE(key);
+	*_reply = reply;
+	return true;
+}
+
+/*
+ * Remember the reply of a forwarder to question
+ */
+void dns_forwarder_cache_store(struct dns_server *dns,
+			       const struct dns_name_question *question,
+			       const struct dns_name_packet *reply)
+{
+	struct dns_forwarder_cache *cache = dns->forwarder_cache;
+	struct dns_forwarder_cache_entry entry = {
+		.stored = time(NULL),
+	};
+	enum ndr_err_code ndr_err;
+	TALLOC_CTX *frame = NULL;
+	char *key = NULL;
+	DATA_BLOB blob;
+	uint8_t *buf = NULL;
+
+	if (cache == NULL) {
+		return;
+	}
+
+	entry.ttl = dns_forwarder_cache_ttl(cache, reply);
+	if (entry.ttl == 0) {
+		return;
+	}
+
+	frame = talloc_stackframe();
+
+	key = dns_forwarder_cache_key(frame, question);
+	if (key == NULL) {
+		goto done;
+	}
+
+	ndr_err = ndr_push_struct_blob(
+		&blob, frame, reply,
+		(ndr_push_flags_fn_t)ndr_push_dns_name_packet);
+	if (!NDR_ERR_CODE_IS_SUCCESS(ndr_err)) {
+		DBG_NOTICE("Failed to push reply for %s: %s\n",
+			   question->name, ndr_errstr(ndr_err));
+		goto done;
+	}
+
+	if (blob.length > cache->size / 4) {
+		goto done;
+	}
+
+	buf = talloc_size(frame, sizeof(entry) + blob.length);
+	if (buf == NULL) {
+		goto done;
+	}
+	memcpy(buf, &entry, sizeof(entry));
+	memcpy(buf + sizeof(entry), blob.data, blob.length);
+
+	memcache_add(cache->replies,
+		     DNS_FORWARDER_CACHE,
+		     data_blob_string_const(key),
+		     data_blob_const(buf, sizeof(entry) + blob.length));
+
+	DBG_DEBUG("Caching reply for %s for %"PRIu32"s\n",
+		  question->name, entry.ttl);
+done:
+	TALLOC_FREE(frame);
+}
@@ -271,22 +271,41 @@ static WERROR add_dns_res_rec(struct dns_res_rec **pdst,
 }
 
 struct ask_forwarder_state {
+	struct dns_server *dns;
+	const struct dns_name_question *question;
 	struct dns_name_packet *reply;
 };
 
 static void ask_forwarder_done(struct tevent_req *subreq);
+static void ask_forwarder_prefetch(struct dns_server *dns,
+				   struct tevent_context *ev,
+				   const char *forwarder,
+				   const struct dns_name_question *question);
 
 static struct tevent_req *ask_forwarder_send(
 	TALLOC_CTX *mem_ctx, struct tevent_context *ev,
-	const char *forwarder, struct dns_name_question *question)
+	struct dns_server *dns, const char *forwarder,
+	const struct dns_name_question *question)
 {
 	struct tevent_req *req, *subreq;
 	struct ask_forwarder_state *state;
+	bool prefetch = false;
 
 	req = tevent_req_create(mem_ctx, &state, struct ask_forwarder_state);
 	if (req == NULL) {
 		return NULL;
 	}
+	state->dns = dns;
+	state->question = question;
+
+	if (dns_forwarder_cache_lookup(dns, state, question,
+				       &state->reply, &prefetch)) {
+		if (prefetch) {
+			ask_forwarder_prefetch(dns, ev, forwarder, question);
+		}
+		tevent_req_done(req);
+		return tevent_req_post(req, ev);
+	}
 
 	subreq = dns_cli_request_send(state, ev, forwarder,
 				      question->name, question->question_class,
@@ -314,9 +333,77 @@ static void ask_forwarder_done(struct tevent_req *subreq)
 		return;
 	}
 
+	dns_forwarder_cache_store(state->dns, state->question, state->reply);
+
 	tevent_req_done(req);
 }
 
+struct ask_forwarder_prefetch_state {
+	struct dns_server *dns;
+	struct dns_name_question question;
+};
+
+static void ask_forwarder_prefetch_done(struct tevent_req *subreq);
+
+/*
+ * Ask the forwarder again for a popular cached reply that is about to
+ * expire. Nobody waits for the result, it just replaces the cache
+ * entry.
+ */
+static void ask_forwarder_prefetch(struct dns_server *dns,
+				   struct tevent_context *ev,
+				   const char *forwarder,
+				   const struct dns_name_question *question)
+{
+	struct ask_forwarder_prefetch_state *state = NULL;
+	struct tevent_req *subreq = NULL;
+
+	state = talloc_zero(dns, struct ask_forwarder_prefetch_state);
+	if (state == NULL) {
+		return;
+	}
+	state->dns = dns;
+	state->question = *question;
+	state->question.name = talloc_strdup(state, question->name);
+	if (state->question.name == NULL) {
+		TALLOC_FREE(state);
+		return;
+	}
+
+	DBG_DEBUG("Prefetching %s\n", state->question.name);
+
+	subreq = dns_cli_request_send(state, ev, forwarder,
+				      state->question.name,
+				      state->question.question_class,
+				      state->question.question_type);
+	if (subreq == NULL) {
+		TALLOC_FREE(state);
+		return;
+	}
+	tevent_req_set_callback(subreq, ask_forwarder_prefetch_done, state);
+}
+
+static void ask_forwarder_prefetch_done(struct tevent_req *subreq)
+{
+	struct ask_forwarder_prefetch_state *state = tevent_req_callback_data(
+		subreq, struct ask_forwarder_prefetch_state);
+	struct dns_name_packet *reply = NULL;
+	int ret;
+
+	ret = dns_cli_request_recv(subreq, state, &reply);
+	TALLOC_FREE(subreq);
+
+	if (ret != 0) {
+		DBG_INFO("Prefetching %s failed: %s\n",
+			 state->question.name, strerror(ret));
+		TALLOC_FREE(state);
+		return;
+	}
+
+	dns_forwarder_cache_store(state->dns, &state->question, reply);
+	TALLOC_FREE(state);
+}
+
 static WERROR ask_forwarder_recv(
 	struct tevent_req *req, TALLOC_CTX *mem_ctx,
 	struct dns_res_rec **answers, uint16_t *ancount,
@@ -476,7 +563,7 @@ static struct tevent_req *handle_dnsrpcrec_send(
 		return req;
 	}
 
-	subreq = ask_forwarder_send(state, ev, forwarder, new_q);
+	subreq = ask_forwarder_send(state, ev, dns, forwarder, new_q);
 	if (tevent_req_nomem(subreq, req)) {
 		return tevent_req_post(req, ev);
 	}
@@ -1016,7 +1103,7 @@ struct tevent_req *dns_server_process_query_send(
 		DEBUG(5, ("Not authoritative for '%s', forwarding\n",
 			  in->questions[0].name));
 
-		subreq = ask_forwarder_send(state, ev,
+		subreq = ask_forwarder_send(state, ev, dns,
 					    (forwarders == NULL ? NULL : forwarders[0]),
 					    &in->questions[0]);
 		if (tevent_req_nomem(subreq, req)) {
@@ -1059,7 +1146,7 @@ static void dns_server_process_query_got_response(struct tevent_req *subreq)
 
 		DEBUG(5, ("DNS query returned %s, trying another forwarder.\n",
 			  win_errstr(werr)));
-		subreq = ask_forwarder_send(state, state->ev,
+		subreq = ask_forwarder_send(state, state->ev, state->dns,
 					    state->forwarders->forwarder,
 					    state->question);
 
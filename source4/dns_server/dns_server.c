@@ -360,6 +360,8 @@ static void dns_tcp_call_loop(struct tevent_req *subreq)
 	call->in.data += 2;
 	call->in.length -= 2;
 
+	dns->stats.tcp_requests += 1;
+
 	subreq = dns_process_send(call, dns->task->event_ctx, dns,
 				  dns_conn->conn->remote_address,
 				  dns_conn->conn->local_address,
@@ -401,6 +403,7 @@ static void dns_tcp_call_process_done(struct tevent_req *subreq)
 	TALLOC_FREE(subreq);
 	if (!W_ERROR_IS_OK(err)) {
 		DEBUG(1, ("dns_process returned %s\n", win_errstr(err)));
+		dns_conn->dns_socket->dns->stats.failed += 1;
 		dns_tcp_terminate_connection(dns_conn,
 				"dns_tcp_call_loop: process function failed");
 		return;
@@ -559,6 +562,8 @@ static void dns_udp_call_loop(struct tevent_req *subreq)
 	call->in.data = buf;
 	call->in.length = len;
 
+	dns->stats.udp_requests += 1;
+
 	DEBUG(10,("Received DNS UDP packet of length %lu from %s\n",
 		 (long)call->in.length,
 		 tsocket_address_string(call->src, call)));
@@ -598,6 +603,7 @@ static void dns_udp_call_process_done(struct tevent_req *subreq)
 	TALLOC_FREE(subreq);
 	if (!W_ERROR_IS_OK(err)) {
 		DEBUG(1, ("dns_process returned %s\n", win_errstr(err)));
+		dns->stats.failed += 1;
 		TALLOC_FREE(call);
 		return;
 	}
@@ -788,6 +794,12 @@ static NTSTATUS dns_server_reload_zones(struct dns_server *dns)
 		talloc_free(old_zone);
 	}
 
+	status = dns_zone_cache_reload(dns);
+	if (!NT_STATUS_IS_OK(status)) {
+		DBG_WARNING("Failed to set up the zone cache: %s\n",
+			    nt_errstr(status));
+	}
+
 	return NT_STATUS_OK;
 }
 
@@ -812,6 +824,39 @@ static NTSTATUS dns_reload_zones(struct irpc_message *msg,
 	return NT_STATUS_OK;
 }
 
+/*
+ * Log the request counters of this process every "dns:stats interval"
+ * seconds, so the load on the individual pre-fork workers can be
+ * compared.
+ */
+static void dns_server_stats_timer(struct tevent_context *ev,
+				   struct tevent_timer *te,
+				   struct timeval current_time,
+				   void *private_data)
+{
+	struct dns_server *dns = talloc_get_type_abort(
+		private_data, struct dns_server);
+
+	TALLOC_FREE(dns->stats.te);
+
+	DBG_NOTICE("worker %u: %"PRIu64" UDP requests, "
+		   "%"PRIu64" TCP requests, %"PRIu64" failed\n",
+		   dns->worker,
+		   dns->stats.udp_requests,
+		   dns->stats.tcp_requests,
+		   dns->stats.failed);
+
+	dns->stats.te = tevent_add_timer(
+		ev,
+		dns,
+		timeval_current_ofs(dns->stats.interval, 0),
+		dns_server_stats_timer,
+		dns);
+	if (dns->stats.te == NULL) {
+		DBG_WARNING("Failed to schedule the statistics timer\n");
+	}
+}
+
 static NTSTATUS dns_task_init(struct task_server *task)
 {
 	struct dns_server *dns;
@@ -854,6 +899,7 @@ static NTSTATUS dns_task_init(struct task_server *task)
 	}
 
 	dns->task = task;
+	task->private_data = dns;
 
 	dns->server_credentials = cli_credentials_init(dns);
 	if (!dns->server_credentials) {
@@ -923,41 +969,103 @@ static NTSTATUS dns_task_init(struct task_server *task)
 		return NT_STATUS_NO_MEMORY;
 	}
 
-	status = dns_server_reload_zones(dns);
+	status = dns_startup_interfaces(dns, ifaces, task->model_ops);
 	if (!NT_STATUS_IS_OK(status)) {
-		task_server_terminate(task, "dns: failed to load DNS zones", true);
+		task_server_terminate(task, "dns failed to setup interfaces", true);
 		return status;
 	}
 
-	status = dns_startup_interfaces(dns, ifaces, task->model_ops);
+	return NT_STATUS_OK;
+}
+
+/*
+ * Called in each pre-fork worker, and right after dns_task_init() in
+ * the other process models. The listening sockets are shared with the
+ * master, everything that talks to the database or to other processes
+ * is set up here.
+ */
+static void dns_post_fork(struct task_server *task, struct process_details *pd)
+{
+	struct dns_server *dns = NULL;
+	NTSTATUS status;
+
+	if (task == NULL || task->private_data == NULL) {
+		task_server_terminate(task, "dns: no dns_server info", true);
+		return;
+	}
+	dns = talloc_get_type_abort(task->private_data, struct dns_server);
+
+	dns->worker = pd->instances;
+
+	/*
+	 * A pre-fork worker can't use the sam.ldb handle opened by the
+	 * master, in the other models this returns the existing one.
+	 */
+	dns->samdb = samdb_connect(dns,
+				   task->event_ctx,
+				   task->lp_ctx,
+				   system_session(task->lp_ctx),
+				   NULL,
+				   0);
+	if (dns->samdb == NULL) {
+		task_server_terminate(task, "dns: samdb_connect failed", true);
+		return;
+	}
+
+	status = dns_server_reload_zones(dns);
 	if (!NT_STATUS_IS_OK(status)) {
-		task_server_terminate(task, "dns failed to setup interfaces", true);
-		return status;
+		task_server_terminate(task, "dns: failed to load DNS zones", true);
+		return;
 	}
 
-	/* Setup the IRPC interface and register handlers */
+	/*
+	 * Setup the IRPC interface and register handlers. Every worker
+	 * registers as "dnssrv", dns_notify tells all of them to reload
+	 * their zones.
+	 */
 	status = irpc_add_name(task->msg_ctx, "dnssrv");
 	if (!NT_STATUS_IS_OK(status)) {
 		task_server_terminate(task, "dns: failed to register IRPC name", true);
-		return status;
+		return;
 	}
 
 	status = IRPC_REGISTER(task->msg_ctx, irpc, DNSSRV_RELOAD_DNS_ZONES,
 			       dns_reload_zones, dns);
 	if (!NT_STATUS_IS_OK(status)) {
 		task_server_terminate(task, "dns: failed to setup reload handler", true);
-		return status;
+		return;
+	}
+
+	status = dns_forwarder_cache_init(dns);
+	if (!NT_STATUS_IS_OK(status)) {
+		DBG_WARNING("Failed to set up the forwarder cache: %s\n",
+			    nt_errstr(status));
+	}
+
+	dns->stats.interval = lpcfg_parm_int(task->lp_ctx, NULL,
+					     "dns", "stats interval", 0);
+	if (dns->stats.interval != 0) {
+		dns->stats.te = tevent_add_timer(
+			task->event_ctx,
+			dns,
+			timeval_current_ofs(dns->stats.interval, 0),
+			dns_server_stats_timer,
+			dns);
+		if (dns->stats.te == NULL) {
+			DBG_WARNING("Failed to schedule the statistics "
+				    "timer\n");
+		}
 	}
-	return NT_STATUS_OK;
 }
 
 NTSTATUS server_service_dns_init(TALLOC_CTX *ctx)
 {
 	static const struct service_details details = {
 		.inhibit_fork_on_accept = true,
-		.inhibit_pre_fork = true,
+		.inhibit_pre_fork = false,
+		.default_pre_fork_children = 1,
 		.task_init = dns_task_init,
-		.post_fork = NULL
+		.post_fork = dns_post_fork
 	};
 	return register_server_service(ctx, "dns", &details);
 }
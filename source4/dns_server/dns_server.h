@@ -44,12 +44,27 @@ struct dns_server_tkey_store {
 	uint16_t size;
 };
 
+struct dns_zone_cache;
+struct dns_forwarder_cache;
+
 struct dns_server {
 	struct task_server *task;
 	struct ldb_context *samdb;
 	struct dns_server_zone *zones;
+	struct dns_zone_cache *zone_cache;
+	struct dns_forwarder_cache *forwarder_cache;
 	struct dns_server_tkey_store *tkeys;
 	struct cli_credentials *server_credentials;
+
+	/* pre-fork worker number, 0 without pre-forking */
+	unsigned int worker;
+	struct {
+		uint64_t udp_requests;
+		uint64_t tcp_requests;
+		uint64_t failed;
+		uint32_t interval;
+		struct tevent_timer *te;
+	} stats;
 };
 
 struct dns_request_state {
@@ -102,6 +117,22 @@ WERROR dns_replace_records(struct dns_server *dns,
 			   bool needs_add,
 			   struct dnsp_DnssrvRpcRecord *records,
 			   uint16_t rec_count);
+NTSTATUS dns_zone_cache_reload(struct dns_server *dns);
+void dns_zone_cache_flush(struct dns_server *dns, struct ldb_dn *dn);
+WERROR dns_zone_cache_lookup_wildcard(struct dns_server *dns,
+				      TALLOC_CTX *mem_ctx,
+				      struct ldb_dn *dn,
+				      struct dnsp_DnssrvRpcRecord **records,
+				      uint16_t *rec_count);
+NTSTATUS dns_forwarder_cache_init(struct dns_server *dns);
+bool dns_forwarder_cache_lookup(struct dns_server *dns,
+				TALLOC_CTX *mem_ctx,
+				const struct dns_name_question *question,
+				struct dns_name_packet **_reply,
+				bool *prefetch);
+void dns_forwarder_cache_store(struct dns_server *dns,
+			       const struct dns_name_question *question,
+			       const struct dns_name_packet *reply);
 WERROR dns_name2dn(struct dns_server *dns,
 		   TALLOC_CTX *mem_ctx,
 		   const char *name,
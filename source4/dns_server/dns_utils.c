@@ -58,8 +58,8 @@ WERROR dns_lookup_records_wildcard(struct dns_server *dns,
 			  struct dnsp_DnssrvRpcRecord **records,
 			  uint16_t *rec_count)
 {
-	return dns_common_wildcard_lookup(dns->samdb, mem_ctx, dn,
-				 records, rec_count);
+	return dns_zone_cache_lookup_wildcard(dns, mem_ctx, dn,
+					      records, rec_count);
 }
 
 WERROR dns_replace_records(struct dns_server *dns,
@@ -71,6 +71,9 @@ WERROR dns_replace_records(struct dns_server *dns,
 {
 	/* TODO: Autogenerate this somehow */
 	uint32_t dwSerial = 110;
+
+	dns_zone_cache_flush(dns, dn);
+
 	return dns_common_replace(dns->samdb, mem_ctx, dn,
 				  needs_add, dwSerial, records, rec_count);
 }
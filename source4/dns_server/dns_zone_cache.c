@@ -0,0 +1,355 @@
+/*
+   Unix SMB/CIFS implementation.
+
+   In-memory cache of authoritative DNS records
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Every query used to search sam.ldb for the dnsNode (and, if that did
+ * not exist, for a matching wildcard node) and to unpack all dnsRecord
+ * values. Here we keep the result of dns_common_wildcard_lookup() per
+ * zone, keyed by the casefolded DN of the name, including negative
+ * results.
+ *
+ * The records of a zone are only valid as long as the uSNHighest of the
+ * partition holding the zone is unchanged. That catches our own updates
+ * as well as changes made over RPC, LDAP or by inbound replication in
+ * other processes. Updates through this server also drop the zone
+ * right away, and reloading the zone list starts from scratch.
+ */
+
+#include "includes.h"
+#include "librpc/ndr/libndr.h"
+#include "librpc/gen_ndr/ndr_dnsp.h"
+#include "librpc/ndr/ndr_dnsp.h"
+#include <ldb.h>
+#include "dsdb/samdb/samdb.h"
+#include "dsdb/common/util.h"
+#include "dns_server/dns_server.h"
+#include "lib/util/dlinklist.h"
+#include "lib/util/memcache.h"
+
+#undef DBGC_CLASS
+#define DBGC_CLASS DBGC_DNS
+
+#define DNS_ZONE_CACHE_SIZE (4*1024*1024)
+
+struct dns_zone_cache_zone {
+	struct dns_zone_cache_zone *prev, *next;
+	struct ldb_dn *zone_dn;
+	struct ldb_dn *nc_root;
+	uint64_t usn;
+	struct memcache *records;
+};
+
+struct dns_zone_cache {
+	struct dns_zone_cache_zone *zones;
+};
+
+struct dns_zone_cache_entry {
+	WERROR werr;
+	uint16_t rec_count;
+	struct dnsp_DnssrvRpcRecord *recs;
+};
+
+static WERROR dns_zone_cache_copy_records(
+	TALLOC_CTX *mem_ctx,
+	const struct dnsp_DnssrvRpcRecord *src,
+	uint16_t rec_count,
+	struct dnsp_DnssrvRpcRecord **_dst)
+{
+	struct dnsp_DnssrvRpcRecord *dst = NULL;
+	uint16_t i;
+
+	*_dst = NULL;
+
+	if (rec_count == 0) {
+		return WERR_OK;
+	}
+
+	dst = talloc_array(mem_ctx, struct dnsp_DnssrvRpcRecord, rec_count);
+	W_ERROR_HAVE_NO_MEMORY(dst);
+
+	for (i = 0; i < rec_count; i++) {
+		const union dnsRecordData *s = &src[i].data;
+		union dnsRecordData *d = &dst[i].data;
+		enum ndr_err_code ndr_err;
+
+		dst[i] = src[i];
+
+		switch (src[i].wType) {
+		case DNS_TYPE_TOMBSTONE:
+			break;
+		case DNS_TYPE_A:
+			d->ipv4 = talloc_strdup(dst, s->ipv4);
+			W_ERROR_HAVE_NO_MEMORY(d->ipv4);
+			break;
+		case DNS_TYPE_AAAA:
+			d->ipv6 = talloc_strdup(dst, s->ipv6);
+			W_ERROR_HAVE_NO_MEMORY(d->ipv6);
+			break;
+		case DNS_TYPE_NS:
+			d->ns = talloc_strdup(dst, s->ns);
+			W_ERROR_HAVE_NO_MEMORY(d->ns);
+			break;
+		case DNS_TYPE_CNAME:
+			d->cname = talloc_strdup(dst, s->cname);
+			W_ERROR_HAVE_NO_MEMORY(d->cname);
+			break;
+		case DNS_TYPE_PTR:
+			d->ptr = talloc_strdup(dst, s->ptr);
+			W_ERROR_HAVE_NO_MEMORY(d->ptr);
+			break;
+		case DNS_TYPE_SOA:
+			d->soa.mname = talloc_strdup(dst, s->soa.mname);
+			W_ERROR_HAVE_NO_MEMORY(d->soa.mname);
+			d->soa.rname = talloc_strdup(dst, s->soa.rname);
+			W_ERROR_HAVE_NO_MEMORY(d->soa.rname);
+			break;
+		case DNS_TYPE_MX:
+			d->mx.nameTarget = talloc_strdup(dst, s->mx.nameTarget);
+			W_ERROR_HAVE_NO_MEMORY(d->mx.nameTarget);
+			break;
+		case DNS_TYPE_SRV:
+			d->srv.nameTarget = talloc_strdup(dst, s->srv.nameTarget);
+			W_ERROR_HAVE_NO_MEMORY(d->srv.nameTarget);
+			break;
+		case DNS_TYPE_HINFO:
+			d->hinfo.cpu = talloc_strdup(dst, s->hinfo.cpu);
+			W_ERROR_HAVE_NO_MEMORY(d->hinfo.cpu);
+			d->hinfo.os = talloc_strdup(dst, s->hinfo.os);
+			W_ERROR_HAVE_NO_MEMORY(d->hinfo.os);
+			break;
+		case DNS_TYPE_TXT:
+			ndr_err = ndr_dnsp_string_list_copy(dst,
+							    &s->txt,
+							    &d->txt);
+			if (!NDR_ERR_CODE_IS_SUCCESS(ndr_err)) {
+				return WERR_NOT_ENOUGH_MEMORY;
+			}
+			break;
+		default:
+			d->data = data_blob_talloc(dst,
+						   s->data.data,
+						   s->data.length);
+			if (s->data.length != 0) {
+				W_ERROR_HAVE_NO_MEMORY(d->data.data);
+			}
+			break;
+		}
+	}
+
+	*_dst = dst;
+	return WERR_OK;
+}
+
+/*
+ * Rebuild the cache for the current zone list, throwing away all
+ * records cached so far.
+ */
+NTSTATUS dns_zone_cache_reload(struct dns_server *dns)
+{
+	struct dns_zone_cache *cache = NULL;
+	const struct dns_server_zone *z = NULL;
+
+	TALLOC_FREE(dns->zone_cache);
+
+	cache = talloc_zero(dns, struct dns_zone_cache);
+	if (cache == NULL) {
+		return NT_STATUS_NO_MEMORY;
+	}
+
+	for (z = dns->zones; z != NULL; z = z->next) {
+		struct dns_zone_cache_zone *cz = NULL;
+		int ret;
+
+		cz = talloc_zero(cache, struct dns_zone_cache_zone);
+		if (cz == NULL) {
+			TALLOC_FREE(cache);
+			return NT_STATUS_NO_MEMORY;
+		}
+
+		cz->zone_dn = ldb_dn_copy(cz, z->dn);
+		if (cz->zone_dn == NULL) {
+			TALLOC_FREE(cache);
+			return NT_STATUS_NO_MEMORY;
+		}
+
+		ret = dsdb_find_nc_root(dns->samdb, cz, cz->zone_dn,
+					&cz->nc_root);
+		if (ret != LDB_SUCCESS) {
+			DBG_NOTICE("No partition found for zone %s, "
+				   "not caching it: %s\n",
+				   z->name, ldb_strerror(ret));
+			TALLOC_FREE(cz);
+			continue;
+		}
+
+		DLIST_ADD_END(cache->zones, cz);
+	}
+
+	dns->zone_cache = cache;
+	return NT_STATUS_OK;
+}
+
+static struct dns_zone_cache_zone *dns_zone_cache_find(
+	struct dns_zone_cache *cache, struct ldb_dn *dn)
+{
+	struct dns_zone_cache_zone *cz = NULL;
+
+	if (cache == NULL) {
+		return NULL;
+	}
+
+	for (cz = cache->zones; cz != NULL; cz = cz->next) {
+		if (ldb_dn_compare_base(cz->zone_dn, dn) == 0) {
+			return cz;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Forget all records of the zone holding dn.
+ */
+void dns_zone_cache_flush(struct dns_server *dns, struct ldb_dn *dn)
+{
+	struct dns_zone_cache_zone *cz = NULL;
+
+	cz = dns_zone_cache_find(dns->zone_cache, dn);
+	if (cz == NULL) {
+		return;
+	}
+
+	TALLOC_FREE(cz->records);
+	cz->usn = 0;
+}
+
+/*
+ * Make sure the records of the zone still match the partition.
+ * Returns false if we could not find out, the caller then has to ask
+ * the database directly.
+ */
+static bool dns_zone_cache_validate(struct dns_server *dns,
+				    struct dns_zone_cache_zone *cz)
+{
+	uint64_t usn = 0;
+	int ret;
+
+	ret = dsdb_load_partition_usn(dns->samdb, cz->nc_root, &usn, NULL);
+	if (ret != LDB_SUCCESS) {
+		DBG_NOTICE("Failed to load uSNHighest of %s: %s\n",
+			   ldb_dn_get_linearized(cz->nc_root),
+			   ldb_strerror(ret));
+		TALLOC_FREE(cz->records);
+		return false;
+	}
+
+	if (cz->records != NULL && usn == cz->usn) {
+		return true;
+	}
+
+	TALLOC_FREE(cz->records);
+	cz->usn = usn;
+
+	cz->records = memcache_init(cz, DNS_ZONE_CACHE_SIZE);
+	if (cz->records == NULL) {
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Cached version of dns_common_wildcard_lookup()
+ */
+WERROR dns_zone_cache_lookup_wildcard(struct dns_server *dns,
+				      TALLOC_CTX *mem_ctx,
+				      struct ldb_dn *dn,
+				      struct dnsp_DnssrvRpcRecord **records,
+				      uint16_t *rec_count)
+{
+	struct dns_zone_cache *cache = dns->zone_cache;
+	struct dns_zone_cache_zone *cz = NULL;
+	struct dns_zone_cache_entry *entry = NULL;
+	const char *casefold = NULL;
+	DATA_BLOB key;
+	WERROR werr;
+
+	*records = NULL;
+	*rec_count = 0;
+
+	cz = dns_zone_cache_find(cache, dn);
+	if (cz == NULL || !dns_zone_cache_validate(dns, cz)) {
+		return dns_common_wildcard_lookup(dns->samdb, mem_ctx, dn,
+						  records, rec_count);
+	}
+
+	casefold = ldb_dn_get_casefold(dn);
+	if (casefold == NULL) {
+		return WERR_NOT_ENOUGH_MEMORY;
+	}
+	key = data_blob_const(casefold, strlen(casefold));
+
+	entry = memcache_lookup_talloc(cz->records, DNS_ZONE_CACHE_TALLOC, key);
+	if (entry != NULL) {
+		if (!W_ERROR_IS_OK(entry->werr)) {
+			return entry->werr;
+		}
+		werr = dns_zone_cache_copy_records(mem_ctx,
+						   entry->recs,
+						   entry->rec_count,
+						   records);
+		if (!W_ERROR_IS_OK(werr)) {
+			return werr;
+		}
+		*rec_count = entry->rec_count;
+		return WERR_OK;
+	}
+
+	werr = dns_common_wildcard_lookup(dns->samdb, mem_ctx, dn,
+					  records, rec_count);
+	if (!W_ERROR_IS_OK(werr) &&
+	    !W_ERROR_EQUAL(werr, WERR_DNS_ERROR_NAME_DOES_NOT_EXIST)) {
+		/* Don't remember transient failures */
+		return werr;
+	}
+
+	entry = talloc_zero(NULL, struct dns_zone_cache_entry);
+	if (entry == NULL) {
+		return werr;
+	}
+	entry->werr = werr;
+
+	if (W_ERROR_IS_OK(werr)) {
+		WERROR copy_werr;
+
+		copy_werr = dns_zone_cache_copy_records(entry,
+							*records,
+							*rec_count,
+							&entry->recs);
+		if (!W_ERROR_IS_OK(copy_werr)) {
+			TALLOC_FREE(entry);
+			return werr;
+		}
+		entry->rec_count = *rec_count;
+	}
+
+	memcache_add_talloc(cz->records, DNS_ZONE_CACHE_TALLOC, key, &entry);
+
+	return werr;
+}
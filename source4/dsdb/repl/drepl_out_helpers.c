@@ -261,6 +261,27 @@ struct dreplsrv_op_pull_source_state {
 	enum drsuapi_DsExtendedOperation extended_op_retry;
 	bool retry_started;
 	struct dreplsrv_op_pull_source_schema_cycle *schema_cycle;
+	/*
+	 * The outstanding GetNCChanges request, and (only while
+	 * building a pipelined request) the repsFrom to build it from
+	 */
+	struct tevent_req *get_changes_subreq;
+	const struct repsFromTo1 *prefetch_rf1;
+	/* a chunk waiting to be committed behind a pipelined request */
+	struct dreplsrv_op_pull_source_commit *pending_commit;
+};
+
+/*
+ * A converted chunk on its way to dsdb_replicated_objects_commit()
+ */
+struct dreplsrv_op_pull_source_commit {
+	struct drsuapi_DsGetNCChanges *r;
+	struct dsdb_schema *working_schema;
+	struct dsdb_extended_replicated_objects *objects;
+	struct repsFromTo1 rf1;
+	bool more_data;
+	bool prefetched;
+	struct tevent_immediate *im;
 };
 
 static void dreplsrv_op_pull_source_connect_done(struct tevent_req *subreq);
@@ -497,6 +518,10 @@ static void dreplsrv_op_pull_source_get_changes_trigger(struct tevent_req *req)
 		rf1 = &state->schema_cycle->repsFrom1;
 	}
 
+	if (state->prefetch_rf1 != NULL) {
+		rf1 = state->prefetch_rf1;
+	}
+
 	r = talloc(state, struct drsuapi_DsGetNCChanges);
 	if (tevent_req_nomem(r, req)) {
 		return;
@@ -671,6 +696,44 @@ static void dreplsrv_op_pull_source_get_changes_trigger(struct tevent_req *req)
 		return;
 	}
 	tevent_req_set_callback(subreq, dreplsrv_op_pull_source_get_changes_done, req);
+	state->get_changes_subreq = subreq;
+}
+
+/*
+ * Send the GetNCChanges request for the chunk after the one about to
+ * be applied, starting from the highwatermark it returned.
+ *
+ * The current chunk is then committed from an immediate event, see
+ * dreplsrv_op_pull_source_apply_changes_trigger(), so this overlaps the
+ * round trip and the remote side's work with our local commit.  There
+ * is only ever one chunk in flight, as each request depends on the
+ * highwatermark of the previous reply.
+ */
+static bool dreplsrv_op_pull_source_prefetch_changes(struct tevent_req *req,
+						     const struct repsFromTo1 *rf1)
+{
+	struct dreplsrv_op_pull_source_state *state = tevent_req_data(req,
+						      struct dreplsrv_op_pull_source_state);
+
+	state->prefetch_rf1 = rf1;
+	dreplsrv_op_pull_source_get_changes_trigger(req);
+	state->prefetch_rf1 = NULL;
+
+	return tevent_req_is_in_progress(req);
+}
+
+/*
+ * Drop a pipelined request, eg because the chunk before it failed to
+ * apply and will be requested again. Any late reply is discarded by the
+ * dcerpc layer as it no longer matches a pending call.
+ */
+static void dreplsrv_op_pull_source_cancel_prefetch(struct tevent_req *req)
+{
+	struct dreplsrv_op_pull_source_state *state = tevent_req_data(req,
+						      struct dreplsrv_op_pull_source_state);
+
+	TALLOC_FREE(state->get_changes_subreq);
+	TALLOC_FREE(state->ndr_struct_ptr);
 }
 
 static void dreplsrv_op_pull_source_apply_changes_trigger(struct tevent_req *req,
@@ -693,6 +756,7 @@ static void dreplsrv_op_pull_source_get_changes_done(struct tevent_req *subreq)
 	struct drsuapi_DsGetNCChangesCtr6 *ctr6 = NULL;
 	enum drsuapi_DsExtendedError extended_ret = DRSUAPI_EXOP_ERR_NONE;
 	state->ndr_struct_ptr = NULL;
+	state->get_changes_subreq = NULL;
 
 	status = dcerpc_drsuapi_DsGetNCChanges_r_recv(subreq, r);
 	TALLOC_FREE(subreq);
@@ -814,6 +878,14 @@ static NTSTATUS dreplsrv_op_pull_retry_with_flags(struct tevent_req *req,
 
 
 static void dreplsrv_update_refs_trigger(struct tevent_req *req);
+static void dreplsrv_op_pull_source_start_commit(struct tevent_req *req,
+						 struct dreplsrv_op_pull_source_commit *c,
+						 bool pipeline);
+static void dreplsrv_op_pull_source_commit_trigger(struct tevent_context *ev,
+						   struct tevent_immediate *im,
+						   void *private_data);
+static void dreplsrv_op_pull_source_commit_changes(struct tevent_req *req,
+						   struct dreplsrv_op_pull_source_commit *c);
 
 static void dreplsrv_op_pull_source_apply_changes_trigger(struct tevent_req *req,
 							  struct drsuapi_DsGetNCChanges *r,
@@ -844,6 +916,8 @@ static void dreplsrv_op_pull_source_apply_changes_trigger(struct tevent_req *req
 	uint32_t dsdb_repl_flags = 0;
 	struct ldb_dn *nc_root = NULL;
 	bool was_schema = false;
+	struct dreplsrv_op_pull_source_commit *c = NULL;
+	bool pipeline;
 	int ret;
 
 	switch (ctr_level) {
@@ -1157,14 +1231,119 @@ static void dreplsrv_op_pull_source_apply_changes_trigger(struct tevent_req *req
 		return;
 	}
 
+	c = talloc_zero(state, struct dreplsrv_op_pull_source_commit);
+	if (tevent_req_nomem(c, req)) {
+		talloc_free(objects);
+		return;
+	}
+	c->r = r;
+	c->working_schema = working_schema;
+	c->objects = talloc_steal(c, objects);
+	c->rf1 = rf1;
+	c->more_data = more_data;
+
+	/*
+	 * A plain (non-exop, non-schema) chunk with more to come can
+	 * have the next chunk requested while this one is committed.
+	 */
+	pipeline = service->pipeline_getncchanges &&
+		   more_data &&
+		   !was_schema &&
+		   state->op->extended_op == DRSUAPI_EXOP_NONE;
+
+	dreplsrv_op_pull_source_start_commit(req, c, pipeline);
+}
+
+/*
+ * Commit a converted chunk, either straight away or, when pipelining,
+ * after sending the request for the next chunk.
+ */
+static void dreplsrv_op_pull_source_start_commit(struct tevent_req *req,
+						 struct dreplsrv_op_pull_source_commit *c,
+						 bool pipeline)
+{
+	struct dreplsrv_op_pull_source_state *state = tevent_req_data(req,
+						      struct dreplsrv_op_pull_source_state);
+
+	if (!pipeline) {
+		dreplsrv_op_pull_source_commit_changes(req, c);
+		TALLOC_FREE(c);
+		return;
+	}
+
+	c->prefetched = dreplsrv_op_pull_source_prefetch_changes(req,
+								 &c->rf1);
+	if (!c->prefetched) {
+		TALLOC_FREE(c);
+		return;
+	}
+
+	/*
+	 * The request above is only queued, dcerpc ships it from an
+	 * immediate event.  The commit is synchronous, so run it from
+	 * an immediate event of our own: that is scheduled after the
+	 * dcerpc one, and immediate events run in order and before any
+	 * fd event, so the request is on the wire before the commit
+	 * starts and its reply is not looked at until the commit is
+	 * done.
+	 */
+	c->im = tevent_create_immediate(c);
+	if (tevent_req_nomem(c->im, req)) {
+		TALLOC_FREE(c);
+		return;
+	}
+	state->pending_commit = c;
+	tevent_schedule_immediate(c->im, state->ev,
+				  dreplsrv_op_pull_source_commit_trigger,
+				  req);
+}
+
+static void dreplsrv_op_pull_source_commit_trigger(struct tevent_context *ev,
+						   struct tevent_immediate *im,
+						   void *private_data)
+{
+	struct tevent_req *req = talloc_get_type_abort(private_data,
+						       struct tevent_req);
+	struct dreplsrv_op_pull_source_state *state = tevent_req_data(req,
+						      struct dreplsrv_op_pull_source_state);
+	struct dreplsrv_op_pull_source_commit *c = state->pending_commit;
+
+	state->pending_commit = NULL;
+
+	dreplsrv_op_pull_source_commit_changes(req, c);
+	TALLOC_FREE(c);
+}
+
+/*
+ * Commit a converted chunk and move on to the next step of the cycle.
+ * This frees the chunk's objects, and once it is committed its
+ * GetNCChanges reply.
+ */
+static void dreplsrv_op_pull_source_commit_changes(struct tevent_req *req,
+						   struct dreplsrv_op_pull_source_commit *c)
+{
+	struct dreplsrv_op_pull_source_state *state = tevent_req_data(req,
+						      struct dreplsrv_op_pull_source_state);
+	struct dreplsrv_service *service = state->op->service;
+	WERROR status;
+	NTSTATUS nt_status;
+
 	status = dsdb_replicated_objects_commit(service->samdb,
-						working_schema,
-						objects,
+						c->working_schema,
+						c->objects,
 						&state->op->source_dsa->notify_uSN);
-	talloc_free(objects);
+	TALLOC_FREE(c->objects);
 
 	if (!W_ERROR_IS_OK(status)) {
 
+		/*
+		 * The highwatermark is not moving forward, so the
+		 * pipelined request is for the wrong chunk.
+		 */
+		if (c->prefetched) {
+			dreplsrv_op_pull_source_cancel_prefetch(req);
+		}
+
 		/*
 		 * Check if this error can be fixed by resending the GetNCChanges
 		 * request with extra flags set (i.e. GET_ANC/GET_TGT)
@@ -1188,13 +1367,18 @@ static void dreplsrv_op_pull_source_apply_changes_trigger(struct tevent_req *req
 
 	if (state->op->extended_op == DRSUAPI_EXOP_NONE) {
 		/* if it applied fine, we need to update the highwatermark */
-		*state->op->source_dsa->repsFrom1 = rf1;
+		*state->op->source_dsa->repsFrom1 = c->rf1;
 	}
 
 	/* we don't need this maybe very large structure anymore */
-	TALLOC_FREE(r);
+	TALLOC_FREE(c->r);
+
+	if (c->prefetched) {
+		/* the next chunk is already on its way */
+		return;
+	}
 
-	if (more_data) {
+	if (c->more_data) {
 		dreplsrv_op_pull_source_get_changes_trigger(req);
 		return;
 	}
@@ -485,6 +485,7 @@ static NTSTATUS dreplsrv_task_init(struct task_server *task)
 
 	periodic_startup_interval	= lpcfg_parm_int(task->lp_ctx, NULL, "dreplsrv", "periodic_startup_interval", 15); /* in seconds */
 	service->periodic.interval	= lpcfg_parm_int(task->lp_ctx, NULL, "dreplsrv", "periodic_interval", 300); /* in seconds */
+	service->pipeline_getncchanges	= lpcfg_parm_bool(task->lp_ctx, NULL, "dreplsrv", "pipeline_getncchanges", false);
 
 	status = dreplsrv_periodic_schedule(service, periodic_startup_interval);
 	if (!W_ERROR_IS_OK(status)) {
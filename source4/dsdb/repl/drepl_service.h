@@ -242,6 +242,12 @@ struct dreplsrv_service {
 	bool rid_alloc_in_progress;
 
 	bool am_rodc;
+
+	/*
+	 * request the next GetNCChanges chunk before applying the
+	 * current one, so the round trip overlaps the local commit
+	 */
+	bool pipeline_getncchanges;
 };
 
 #include "lib/messaging/irpc.h"
@@ -0,0 +1,401 @@
+/*
+ * Unit tests for source4/dsdb/repl/drepl_out_helpers.c
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * from cmocka.c:
+ * These headers or their equivalents should be included prior to
+ * including
+ * this header file.
+ *
+ * #include <stdarg.h>
+ * #include <stddef.h>
+ * #include <setjmp.h>
+ *
+ * This allows test applications to use custom definitions of C standard
+ * library functions and types.
+ *
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#include "includes.h"
+#include "dsdb/repl/drepl_out_helpers.c"
+
+#define OLD_USN 50
+#define NEW_USN 100
+
+/*
+ * What the mocked dcerpc and dsdb layers have seen
+ */
+static struct {
+	struct dreplsrv_op_pull_source_state *state;
+	WERROR commit_result;
+	unsigned requests_queued;
+	unsigned requests_sent;
+	uint64_t last_request_usn;
+	uint32_t last_request_flags;
+	unsigned commits;
+	unsigned requests_queued_at_commit;
+	unsigned requests_sent_at_commit;
+	bool request_in_flight_at_commit;
+} mock;
+
+/*****************************************************************************
+ * wrapped functions
+ *
+ *****************************************************************************/
+
+/*
+ * Like dcerpc, only put the request on the wire from an immediate
+ * event, see dcerpc_schedule_io_trigger().  The reply never arrives.
+ */
+struct mock_get_changes_state {
+	uint8_t dummy;
+};
+
+static void mock_ship_request(struct tevent_context *ev,
+			      struct tevent_immediate *im,
+			      void *private_data)
+{
+	mock.requests_sent++;
+}
+
+struct tevent_req *__wrap_dcerpc_drsuapi_DsGetNCChanges_r_send(
+	TALLOC_CTX *mem_ctx,
+	struct tevent_context *ev,
+	struct dcerpc_binding_handle *h,
+	struct drsuapi_DsGetNCChanges *r);
+struct tevent_req *__wrap_dcerpc_drsuapi_DsGetNCChanges_r_send(
+	TALLOC_CTX *mem_ctx,
+	struct tevent_context *ev,
+	struct dcerpc_binding_handle *h,
+	struct drsuapi_DsGetNCChanges *r)
+{
+	struct tevent_req *req = NULL;
+	struct mock_get_changes_state *state = NULL;
+	struct tevent_immediate *im = NULL;
+
+	req = tevent_req_create(mem_ctx, &state,
+				struct mock_get_changes_state);
+	if (req == NULL) {
+		return NULL;
+	}
+
+	im = tevent_create_immediate(state);
+	if (im == NULL) {
+		TALLOC_FREE(req);
+		return NULL;
+	}
+	tevent_schedule_immediate(im, ev, mock_ship_request, NULL);
+
+	assert_int_equal(r->in.level, 5);
+	mock.requests_queued++;
+	mock.last_request_usn = r->in.req->req5.highwatermark.highest_usn;
+	mock.last_request_flags = r->in.req->req5.replica_flags;
+
+	return req;
+}
+
+WERROR __wrap_dsdb_replicated_objects_commit(
+	struct ldb_context *ldb,
+	struct dsdb_schema *working_schema,
+	struct dsdb_extended_replicated_objects *objects,
+	uint64_t *notify_uSN);
+WERROR __wrap_dsdb_replicated_objects_commit(
+	struct ldb_context *ldb,
+	struct dsdb_schema *working_schema,
+	struct dsdb_extended_replicated_objects *objects,
+	uint64_t *notify_uSN)
+{
+	struct tevent_req *subreq = mock.state->get_changes_subreq;
+
+	mock.commits++;
+	mock.requests_queued_at_commit = mock.requests_queued;
+	mock.requests_sent_at_commit = mock.requests_sent;
+	mock.request_in_flight_at_commit =
+		subreq != NULL && tevent_req_is_in_progress(subreq);
+
+	return mock.commit_result;
+}
+
+/*
+ * The schema retry paths are not exercised here
+ */
+WERROR dreplsrv_partition_find_for_nc(struct dreplsrv_service *s,
+				      struct GUID *nc_guid,
+				      struct dom_sid *nc_sid,
+				      const char *nc_dn_str,
+				      struct dreplsrv_partition **_p)
+{
+	fail();
+	return WERR_NOT_SUPPORTED;
+}
+
+WERROR dreplsrv_partition_source_dsa_by_guid(struct dreplsrv_partition *p,
+					     const struct GUID *dsa_guid,
+					     struct dreplsrv_partition_source_dsa **_dsa)
+{
+	fail();
+	return WERR_NOT_SUPPORTED;
+}
+
+/*****************************************************************************
+ * Test helpers
+ *****************************************************************************/
+
+struct test_ctx {
+	struct tevent_context *ev;
+	struct tevent_req *req;
+	struct dreplsrv_op_pull_source_state *state;
+	struct dreplsrv_out_operation *op;
+};
+
+static int setup(void **state)
+{
+	struct test_ctx *t = NULL;
+	struct dreplsrv_service *service = NULL;
+	struct dreplsrv_partition *partition = NULL;
+	struct dreplsrv_partition_source_dsa *source_dsa = NULL;
+	struct dreplsrv_out_connection *conn = NULL;
+
+	ZERO_STRUCT(mock);
+	mock.commit_result = WERR_OK;
+
+	t = talloc_zero(NULL, struct test_ctx);
+	assert_non_null(t);
+
+	t->ev = tevent_context_init(t);
+	assert_non_null(t->ev);
+
+	service = talloc_zero(t, struct dreplsrv_service);
+	assert_non_null(service);
+	service->pipeline_getncchanges = true;
+
+	partition = talloc_zero(service, struct dreplsrv_partition);
+	assert_non_null(partition);
+	partition->service = service;
+
+	conn = talloc_zero(service, struct dreplsrv_out_connection);
+	assert_non_null(conn);
+	conn->service = service;
+	conn->drsuapi = talloc_zero(conn, struct dreplsrv_drsuapi_connection);
+	assert_non_null(conn->drsuapi);
+
+	source_dsa = talloc_zero(partition,
+				 struct dreplsrv_partition_source_dsa);
+	assert_non_null(source_dsa);
+	source_dsa->partition = partition;
+	source_dsa->conn = conn;
+	source_dsa->repsFrom1 = &source_dsa->_repsFromBlob.ctr.ctr1;
+	source_dsa->repsFrom1->highwatermark.highest_usn = OLD_USN;
+
+	t->op = talloc_zero(t, struct dreplsrv_out_operation);
+	assert_non_null(t->op);
+	t->op->service = service;
+	t->op->source_dsa = source_dsa;
+	t->op->extended_op = DRSUAPI_EXOP_NONE;
+
+	t->req = tevent_req_create(t, &t->state,
+				   struct dreplsrv_op_pull_source_state);
+	assert_non_null(t->req);
+	t->state->ev = t->ev;
+	t->state->op = t->op;
+	mock.state = t->state;
+
+	*state = t;
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	struct test_ctx *t = talloc_get_type_abort(*state, struct test_ctx);
+
+	TALLOC_FREE(t);
+	return 0;
+}
+
+/*
+ * A converted chunk that moves the highwatermark from OLD_USN to NEW_USN
+ */
+static struct dreplsrv_op_pull_source_commit *new_chunk(struct test_ctx *t,
+							bool more_data)
+{
+	struct dreplsrv_op_pull_source_commit *c = NULL;
+
+	c = talloc_zero(t->state, struct dreplsrv_op_pull_source_commit);
+	assert_non_null(c);
+
+	c->r = talloc_zero(t->state, struct drsuapi_DsGetNCChanges);
+	assert_non_null(c->r);
+	c->objects = talloc_zero(c, struct dsdb_extended_replicated_objects);
+	assert_non_null(c->objects);
+	c->rf1 = *t->op->source_dsa->repsFrom1;
+	c->rf1.highwatermark.highest_usn = NEW_USN;
+	c->more_data = more_data;
+
+	return c;
+}
+
+static void run_until_committed(struct test_ctx *t)
+{
+	int i;
+
+	for (i = 0; i < 10 && mock.commits == 0; i++) {
+		assert_int_equal(tevent_loop_once(t->ev), 0);
+	}
+	assert_int_equal(mock.commits, 1);
+}
+
+/*****************************************************************************
+ * Tests
+ *****************************************************************************/
+
+/*
+ * Without pipelining the next chunk is only requested once the current
+ * one is committed.
+ */
+static void test_commit_then_request(void **state)
+{
+	struct test_ctx *t = talloc_get_type_abort(*state, struct test_ctx);
+
+	dreplsrv_op_pull_source_start_commit(t->req,
+					     new_chunk(t, true),
+					     false);
+
+	assert_int_equal(mock.commits, 1);
+	assert_int_equal(mock.requests_queued_at_commit, 0);
+	assert_false(mock.request_in_flight_at_commit);
+
+	assert_true(tevent_req_is_in_progress(t->req));
+	assert_int_equal(t->op->source_dsa->repsFrom1->highwatermark.highest_usn,
+			 NEW_USN);
+	assert_int_equal(mock.requests_queued, 1);
+	assert_int_equal(mock.last_request_usn, NEW_USN);
+}
+
+/*
+ * With pipelining the request for the next chunk is on the wire, and
+ * still waiting for its reply, while the current one is committed.
+ */
+static void test_request_in_flight_during_commit(void **state)
+{
+	struct test_ctx *t = talloc_get_type_abort(*state, struct test_ctx);
+
+	dreplsrv_op_pull_source_start_commit(t->req,
+					     new_chunk(t, true),
+					     true);
+
+	/* both the send and the commit wait for the event loop */
+	assert_int_equal(mock.requests_queued, 1);
+	assert_int_equal(mock.requests_sent, 0);
+	assert_int_equal(mock.commits, 0);
+	assert_non_null(t->state->pending_commit);
+
+	run_until_committed(t);
+
+	assert_int_equal(mock.requests_queued_at_commit, 1);
+	assert_int_equal(mock.requests_sent_at_commit, 1);
+	assert_true(mock.request_in_flight_at_commit);
+	assert_int_equal(mock.last_request_usn, NEW_USN);
+
+	/* the commit moved us on, and didn't ask for the chunk again */
+	assert_true(tevent_req_is_in_progress(t->req));
+	assert_null(t->state->pending_commit);
+	assert_int_equal(t->op->source_dsa->repsFrom1->highwatermark.highest_usn,
+			 NEW_USN);
+	assert_int_equal(mock.requests_queued, 1);
+	assert_non_null(t->state->get_changes_subreq);
+}
+
+/*
+ * If the commit fails the pipelined request is dropped and the chunk
+ * is asked for again from the old highwatermark.
+ */
+static void test_commit_failure_drops_request(void **state)
+{
+	struct test_ctx *t = talloc_get_type_abort(*state, struct test_ctx);
+	struct tevent_req *prefetch = NULL;
+
+	mock.commit_result = WERR_DS_DRA_MISSING_PARENT;
+
+	dreplsrv_op_pull_source_start_commit(t->req,
+					     new_chunk(t, true),
+					     true);
+	prefetch = t->state->get_changes_subreq;
+	assert_non_null(prefetch);
+
+	run_until_committed(t);
+
+	assert_true(mock.request_in_flight_at_commit);
+	assert_true(tevent_req_is_in_progress(t->req));
+	assert_int_equal(t->op->source_dsa->repsFrom1->highwatermark.highest_usn,
+			 OLD_USN);
+
+	/* the retry went out with GET_ANC and from the old highwatermark */
+	assert_int_equal(mock.requests_queued, 2);
+	assert_int_equal(mock.last_request_usn, OLD_USN);
+	assert_true(mock.last_request_flags & DRSUAPI_DRS_GET_ANC);
+	assert_non_null(t->state->get_changes_subreq);
+	assert_ptr_not_equal(t->state->get_changes_subreq, prefetch);
+}
+
+/*
+ * A commit that can't be retried fails the whole cycle, and the
+ * pipelined request with it.
+ */
+static void test_commit_error(void **state)
+{
+	struct test_ctx *t = talloc_get_type_abort(*state, struct test_ctx);
+	NTSTATUS status;
+
+	mock.commit_result = WERR_DS_DRA_INTERNAL_ERROR;
+
+	dreplsrv_op_pull_source_start_commit(t->req,
+					     new_chunk(t, true),
+					     true);
+
+	run_until_committed(t);
+
+	assert_false(tevent_req_is_in_progress(t->req));
+	assert_true(tevent_req_is_nterror(t->req, &status));
+	assert_null(t->state->get_changes_subreq);
+	assert_int_equal(mock.requests_queued, 1);
+	assert_int_equal(t->op->source_dsa->repsFrom1->highwatermark.highest_usn,
+			 OLD_USN);
+}
+
+int main(int argc, const char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(
+			test_commit_then_request, setup, teardown),
+		cmocka_unit_test_setup_teardown(
+			test_request_in_flight_during_commit, setup, teardown),
+		cmocka_unit_test_setup_teardown(
+			test_commit_failure_drops_request, setup, teardown),
+		cmocka_unit_test_setup_teardown(
+			test_commit_error, setup, teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_SUBUNIT);
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -53,34 +53,48 @@ struct dns_notify_private {
 
 struct dns_notify_dnssrv_state {
 	struct imessaging_context *msg_ctx;
-	struct dnssrv_reload_dns_zones r;
+	unsigned int num_pending;
 };
 
 static void dns_notify_dnssrv_done(struct tevent_req *req)
 {
 	NTSTATUS status;
 	struct dns_notify_dnssrv_state *state;
+	struct dnssrv_reload_dns_zones *r;
 
 	state = tevent_req_callback_data(req, struct dns_notify_dnssrv_state);
+	r = talloc_get_type_abort(talloc_parent(req),
+				  struct dnssrv_reload_dns_zones);
 
-	status = dcerpc_dnssrv_reload_dns_zones_r_recv(req, state);
+	status = dcerpc_dnssrv_reload_dns_zones_r_recv(req, r);
 	if (!NT_STATUS_IS_OK(status)) {
 		DEBUG(1, ("%s: Error notifying dns server: %s\n",
 		      __func__, nt_errstr(status)));
 	}
-	imessaging_cleanup(state->msg_ctx);
+	talloc_free(r);
 
-	talloc_free(req);
+	state->num_pending -= 1;
+	if (state->num_pending > 0) {
+		return;
+	}
+
+	imessaging_cleanup(state->msg_ctx);
 	talloc_free(state);
 }
 
+/*
+ * With pre-forking there is one DNS server per worker process, all of
+ * them registered as "dnssrv". Each of them needs to reload its zones.
+ */
 static void dns_notify_dnssrv_send(struct ldb_module *module)
 {
 	struct ldb_context *ldb;
 	struct loadparm_context *lp_ctx;
 	struct dns_notify_dnssrv_state *state;
-	struct dcerpc_binding_handle *handle;
-	struct tevent_req *req;
+	struct server_id *servers = NULL;
+	unsigned int num_servers = 0;
+	unsigned int i;
+	NTSTATUS status;
 
 	ldb = ldb_module_get_ctx(module);
 
@@ -104,27 +118,49 @@ static void dns_notify_dnssrv_send(struct ldb_module *module)
 		return;
 	}
 
-	/* Get a handle to notify the DNS server */
-	handle = irpc_binding_handle_by_name(state, state->msg_ctx,
-					     "dnssrv",
-					     &ndr_table_irpc);
-	if (handle == NULL) {
+	status = irpc_servers_byname(state->msg_ctx, state, "dnssrv",
+				     &num_servers, &servers);
+	if (!NT_STATUS_IS_OK(status)) {
 		imessaging_cleanup(state->msg_ctx);
 		talloc_free(state);
 		return;
 	}
 
 	/* Send the notifications */
-	req = dcerpc_dnssrv_reload_dns_zones_r_send(state,
-						    ldb_get_event_context(ldb),
-						    handle,
-						    &state->r);
-	if (req == NULL) {
+	for (i = 0; i < num_servers; i++) {
+		struct dcerpc_binding_handle *handle;
+		struct dnssrv_reload_dns_zones *r;
+		struct tevent_req *req;
+
+		r = talloc_zero(state, struct dnssrv_reload_dns_zones);
+		if (r == NULL) {
+			break;
+		}
+
+		handle = irpc_binding_handle(r, state->msg_ctx,
+					     servers[i],
+					     &ndr_table_irpc);
+		if (handle == NULL) {
+			talloc_free(r);
+			continue;
+		}
+
+		req = dcerpc_dnssrv_reload_dns_zones_r_send(r,
+							    ldb_get_event_context(ldb),
+							    handle,
+							    r);
+		if (req == NULL) {
+			talloc_free(r);
+			continue;
+		}
+		tevent_req_set_callback(req, dns_notify_dnssrv_done, state);
+		state->num_pending += 1;
+	}
+
+	if (state->num_pending == 0) {
 		imessaging_cleanup(state->msg_ctx);
 		talloc_free(state);
-		return;
 	}
-	tevent_req_set_callback(req, dns_notify_dnssrv_done, state);
 }
 
 static int dns_notify_add(struct ldb_module *module, struct ldb_request *req)
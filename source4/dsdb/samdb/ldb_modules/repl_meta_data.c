@@ -2556,6 +2556,13 @@ static int replmd_update_la_val(TALLOC_CTX *mem_ctx, struct ldb_val *v, struct d
 
 /*
   handle adding a linked attribute
+
+  TODO: this is linear in the number of existing links. Finding each
+  new value is a binary search, but the old values are copied into
+  new_values and the whole record is rewritten. Sublinear adds and
+  deletes on very large groups need a different storage format for
+  the links (value blocks or a link table), which replication, dbcheck
+  and the backends would all have to understand.
  */
 static int replmd_modify_la_add(struct ldb_module *module,
 				struct replmd_private *replmd_private,
@@ -3394,6 +3401,8 @@ static int replmd_modify_handle_linked_attribs(struct ldb_module *module,
 	int ret;
 	struct ldb_context *ldb = ldb_module_get_ctx(module);
 	struct ldb_message *old_msg;
+	const char **attrs = NULL;
+	unsigned int num_attrs = 0;
 
 	if (dsdb_functional_level(ldb) == DS_DOMAIN_FUNCTION_2000) {
 		/*
@@ -3410,16 +3419,33 @@ static int replmd_modify_handle_linked_attribs(struct ldb_module *module,
 	}
 
 	/*
-	 * TODO:
+	 * Only fetch the forward links being modified (the intersection
+	 * of the linked attributes in the schema and the attributes in
+	 * the request), otherwise we would allocate the entire object
+	 * value-by-value, which on a large group includes every other
+	 * multi-valued link it holds.
 	 *
-	 * We should restrict this to the intersection of the list of
-	 * linked attributes in the schema and the list of attributes
-	 * being modified.
-	 *
-	 * This will help performance a little, as otherwise we have
-	 * to allocate the entire object value-by-value.
+	 * Unknown attributes and backlinks are rejected in the loop
+	 * below and don't need the old values.
 	 */
-	ret = dsdb_module_search_dn(module, msg, &res, msg->dn, NULL,
+	attrs = talloc_array(msg, const char *, msg->num_elements + 1);
+	if (attrs == NULL) {
+		return ldb_module_oom(module);
+	}
+	for (i = 0; i < msg->num_elements; i++) {
+		const struct dsdb_attribute *schema_attr
+			= dsdb_attribute_by_lDAPDisplayName(ac->schema,
+							    msg->elements[i].name);
+		if (schema_attr == NULL ||
+		    schema_attr->linkID == 0 ||
+		    (schema_attr->linkID & 1) == 1) {
+			continue;
+		}
+		attrs[num_attrs++] = schema_attr->lDAPDisplayName;
+	}
+	attrs[num_attrs] = NULL;
+
+	ret = dsdb_module_search_dn(module, msg, &res, msg->dn, attrs,
 	                            DSDB_FLAG_NEXT_MODULE |
 	                            DSDB_SEARCH_SHOW_RECYCLED |
 				    DSDB_SEARCH_REVEAL_INTERNALS |
@@ -3534,6 +3560,7 @@ static int replmd_modify_handle_linked_attribs(struct ldb_module *module,
 	}
 
 	talloc_free(res);
+	talloc_free(attrs);
 	return ret;
 }
 
@@ -8232,6 +8259,81 @@ static int replmd_check_singleval_la_conflict(struct ldb_module *module,
 	return LDB_SUCCESS;
 }
 
+/*
+ * Insert a new (still empty) link value at offset into old_el, and the
+ * matching entry into pdn_list, so the caller can carry on
+ * binary-searching pdn_list rather than re-parsing every existing link
+ * after each add.
+ */
+static int replmd_insert_la_val(TALLOC_CTX *mem_ctx,
+				TALLOC_CTX *element_ctx,
+				struct ldb_message_element *old_el,
+				struct parsed_dn **_pdn_list,
+				unsigned int offset,
+				struct dsdb_dn *dsdb_dn,
+				const struct GUID *guid)
+{
+	struct parsed_dn *pdn_list = NULL;
+	uintptr_t old_values;
+	unsigned int i;
+
+	pdn_list = talloc_realloc(mem_ctx, *_pdn_list, struct parsed_dn,
+				  old_el->num_values+1);
+	if (pdn_list == NULL) {
+		return LDB_ERR_OPERATIONS_ERROR;
+	}
+	*_pdn_list = pdn_list;
+
+	if (offset != old_el->num_values) {
+		memmove(&pdn_list[offset + 1], &pdn_list[offset],
+			(old_el->num_values - offset) * sizeof(pdn_list[0]));
+	}
+	pdn_list[offset].dsdb_dn = dsdb_dn;
+	pdn_list[offset].guid = *guid;
+
+	/*
+	 * The realloc can move the values, remember where they
+	 * were to re-point pdn_list afterwards.
+	 */
+	old_values = (uintptr_t)old_el->values;
+
+	old_el->values = talloc_realloc(element_ctx, old_el->values,
+					struct ldb_val, old_el->num_values+1);
+	if (old_el->values == NULL) {
+		return LDB_ERR_OPERATIONS_ERROR;
+	}
+
+	if (offset != old_el->num_values) {
+		memmove(&old_el->values[offset + 1], &old_el->values[offset],
+			(old_el->num_values - offset) * sizeof(old_el->values[0]));
+	}
+	old_el->values[offset] = (struct ldb_val) { .length = 0 };
+
+	/*
+	 * pdn_list is only in the same order as old_el->values if the
+	 * links are sorted (see replmd_check_upgrade_links()), so move
+	 * every entry to where its own value went.
+	 */
+	for (i = 0; i <= old_el->num_values; i++) {
+		size_t j;
+
+		if (i == offset) {
+			continue;
+		}
+		j = ((uintptr_t)pdn_list[i].v - old_values) /
+			sizeof(old_el->values[0]);
+		if (j >= offset) {
+			j++;
+		}
+		pdn_list[i].v = &old_el->values[j];
+	}
+	pdn_list[offset].v = &old_el->values[offset];
+
+	old_el->num_values++;
+
+	return LDB_SUCCESS;
+}
+
 /**
  * Processes one linked attribute received via replication.
  * @param src_dn the DN of the source object for the link
@@ -8241,7 +8343,8 @@ static int replmd_check_singleval_la_conflict(struct ldb_module *module,
  * we need to realloc old_el->values)
  * @param old_el the corresponding msg->element[] for the linked attribute
  * @param pdn_list a (binary-searchable) parsed DN array for the existing link
- * values in the msg. E.g. for a group, this is the existing members.
+ * values in the msg. E.g. for a group, this is the existing members. When a
+ * new link value is added, the array is updated to match old_el.
  * @param change what got modified: either nothing, an existing link value was
  * modified, or a new link value was added.
  * @returns LDB_SUCCESS if OK, an error otherwise
@@ -8255,9 +8358,10 @@ static int replmd_process_linked_attribute(struct ldb_module *module,
 					   struct ldb_request *parent,
 					   TALLOC_CTX *element_ctx,
 					   struct ldb_message_element *old_el,
-					   struct parsed_dn *pdn_list,
+					   struct parsed_dn **_pdn_list,
 					   replmd_link_changed *change)
 {
+	struct parsed_dn *pdn_list = *_pdn_list;
 	struct drsuapi_DsReplicaLinkedAttribute *la = la_entry->la;
 	struct ldb_context *ldb = ldb_module_get_ctx(module);
 	const struct dsdb_schema *schema = dsdb_get_schema(ldb, mem_ctx);
@@ -8384,20 +8488,13 @@ static int replmd_process_linked_attribute(struct ldb_module *module,
 			}
 		}
 
-		old_el->values = talloc_realloc(element_ctx, old_el->values,
-						struct ldb_val, old_el->num_values+1);
-		if (!old_el->values) {
+		ret = replmd_insert_la_val(mem_ctx, element_ctx, old_el,
+					   _pdn_list, offset, dsdb_dn, &guid);
+		if (ret != LDB_SUCCESS) {
 			ldb_module_oom(module);
-			return LDB_ERR_OPERATIONS_ERROR;
-		}
-
-		if (offset != old_el->num_values) {
-			memmove(&old_el->values[offset + 1], &old_el->values[offset],
-				(old_el->num_values - offset) * sizeof(old_el->values[0]));
+			return ret;
 		}
 
-		old_el->num_values++;
-
 		val_to_update = &old_el->values[offset];
 		old_dsdb_dn = NULL;
 		*change = LINK_CHANGE_ADDED;
@@ -8588,7 +8685,8 @@ static int replmd_process_la_group(struct ldb_module *module,
 
 		/*
 		 * parse the existing links (this can be costly for a large
-		 * group, so we try to minimize the times we do it)
+		 * group, so we only do it once per group: adding a link
+		 * keeps pdn_list up to date)
 		 */
 		if (pdn_list == NULL) {
 			ret = get_parsed_dns_trusted_fallback(module,
@@ -8606,20 +8704,12 @@ static int replmd_process_la_group(struct ldb_module *module,
 						      replmd_private,
 						      msg->dn, attr, la, NULL,
 						      msg->elements, old_el,
-						      pdn_list, &change_type);
+						      &pdn_list, &change_type);
 		if (ret != LDB_SUCCESS) {
 			replmd_txn_cleanup(replmd_private);
 			return ret;
 		}
 
-		/*
-		 * Adding a link reallocs memory, and so invalidates all the
-		 * pointers in pdn_list. Reparse the PDNs on the next loop
-		 */
-		if (change_type == LINK_CHANGE_ADDED) {
-			TALLOC_FREE(pdn_list);
-		}
-
 		if (change_type != LINK_CHANGE_NONE) {
 			num_changes++;
 		}
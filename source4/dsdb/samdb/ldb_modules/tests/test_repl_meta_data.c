@@ -0,0 +1,193 @@
+/*
+   Unit tests for applying replicated links in repl_meta_data.c
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <unistd.h>
+#include <cmocka.h>
+
+int ldb_repl_meta_data_module_init(const char *version);
+#include "../repl_meta_data.c"
+
+#define NUM_OLD_LINKS 4
+
+/*
+ * The values of an unsorted (not yet upgraded) link attribute, and
+ * the order get_parsed_dns() sorts them into by GUID.
+ */
+static const char *old_links[NUM_OLD_LINKS] = {
+	"link-a", "link-b", "link-c", "link-d",
+};
+static const unsigned int sorted_order[NUM_OLD_LINKS] = { 2, 0, 3, 1 };
+
+struct links_ctx {
+	struct ldb_message_element *el;
+	struct parsed_dn *pdn_list;
+	/* the value each GUID (by time_low) has to point at */
+	const char *names[NUM_OLD_LINKS + 8];
+};
+
+static int setup(void **state)
+{
+	struct links_ctx *ctx = NULL;
+	unsigned int i;
+
+	ctx = talloc_zero(NULL, struct links_ctx);
+	assert_non_null(ctx);
+
+	ctx->el = talloc_zero(ctx, struct ldb_message_element);
+	assert_non_null(ctx->el);
+	ctx->el->values = talloc_array(ctx->el, struct ldb_val,
+				       NUM_OLD_LINKS);
+	assert_non_null(ctx->el->values);
+	ctx->el->num_values = NUM_OLD_LINKS;
+
+	ctx->pdn_list = talloc_zero_array(ctx, struct parsed_dn,
+					  NUM_OLD_LINKS);
+	assert_non_null(ctx->pdn_list);
+
+	for (i = 0; i < NUM_OLD_LINKS; i++) {
+		unsigned int v = sorted_order[i];
+
+		ctx->el->values[v] = data_blob_string_const(old_links[v]);
+		ctx->pdn_list[i].v = &ctx->el->values[v];
+		ctx->pdn_list[i].guid.time_low = i;
+		ctx->names[i] = old_links[v];
+	}
+
+	*state = ctx;
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	struct links_ctx *ctx = talloc_get_type_abort(*state,
+						      struct links_ctx);
+
+	TALLOC_FREE(ctx);
+	return 0;
+}
+
+/*
+ * Like replmd_process_linked_attribute() does for a new link:
+ * insert it, then fill in the new value.
+ */
+static void add_link(struct links_ctx *ctx,
+		     unsigned int offset,
+		     const char *name)
+{
+	unsigned int id = ctx->el->num_values;
+	struct GUID guid = { .time_low = id };
+	int ret;
+
+	assert_true(id < ARRAY_SIZE(ctx->names));
+
+	ret = replmd_insert_la_val(ctx, ctx->el, ctx->el, &ctx->pdn_list,
+				   offset, NULL, &guid);
+	assert_int_equal(ret, LDB_SUCCESS);
+
+	assert_int_equal(ctx->pdn_list[offset].guid.time_low, id);
+	*ctx->pdn_list[offset].v = data_blob_string_const(name);
+	ctx->names[id] = name;
+}
+
+/*
+ * Every parsed DN must still point at its own value, and no two at
+ * the same one.
+ */
+static void check_links(struct links_ctx *ctx)
+{
+	struct ldb_message_element *el = ctx->el;
+	bool seen[NUM_OLD_LINKS + 8] = { false, };
+	unsigned int i;
+
+	for (i = 0; i < el->num_values; i++) {
+		struct parsed_dn *pdn = &ctx->pdn_list[i];
+		const char *name = ctx->names[pdn->guid.time_low];
+		ptrdiff_t v = pdn->v - el->values;
+
+		assert_in_range(v, 0, el->num_values - 1);
+		assert_false(seen[v]);
+		seen[v] = true;
+
+		assert_int_equal(pdn->v->length, strlen(name));
+		assert_memory_equal(pdn->v->data, name, pdn->v->length);
+	}
+}
+
+static void test_add_links_unsorted(void **state)
+{
+	struct links_ctx *ctx = talloc_get_type_abort(*state,
+						      struct links_ctx);
+
+	check_links(ctx);
+
+	/* several links in one batch, against the same pdn_list */
+	add_link(ctx, 1, "link-new-1");
+	check_links(ctx);
+
+	add_link(ctx, 0, "link-new-2");
+	check_links(ctx);
+
+	add_link(ctx, ctx->el->num_values, "link-new-3");
+	check_links(ctx);
+
+	add_link(ctx, 3, "link-new-4");
+	check_links(ctx);
+
+	assert_int_equal(ctx->el->num_values, NUM_OLD_LINKS + 4);
+}
+
+static void test_add_links_sorted(void **state)
+{
+	struct links_ctx *ctx = talloc_get_type_abort(*state,
+						      struct links_ctx);
+	unsigned int i;
+
+	/* re-point the parsed DNs to the sorted layout */
+	for (i = 0; i < NUM_OLD_LINKS; i++) {
+		ctx->el->values[i] = data_blob_string_const(ctx->names[i]);
+		ctx->pdn_list[i].v = &ctx->el->values[i];
+	}
+	check_links(ctx);
+
+	add_link(ctx, 2, "link-new-1");
+	add_link(ctx, ctx->el->num_values, "link-new-2");
+	add_link(ctx, 0, "link-new-3");
+	check_links(ctx);
+
+	for (i = 0; i < ctx->el->num_values; i++) {
+		assert_ptr_equal(ctx->pdn_list[i].v, &ctx->el->values[i]);
+	}
+}
+
+int main(void) {
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(
+			test_add_links_unsorted,
+			setup,
+			teardown),
+		cmocka_unit_test_setup_teardown(
+			test_add_links_sorted,
+			setup,
+			teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_SUBUNIT);
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
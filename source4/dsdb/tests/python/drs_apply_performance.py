@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Time how long it takes to replicate (and apply) a large domain.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+import optparse
+import sys
+sys.path.insert(0, 'bin/python')
+
+import os
+import shutil
+import tempfile
+import time
+
+import samba
+import samba.getopt as options
+from samba.tests.subunitrun import SubunitOptions, TestProgram
+from samba.netcmd.main import samba_tool
+from samba.samdb import SamDB
+from samba.auth import system_session
+from ldb import Message, MessageElement, Dn, LdbError
+from ldb import FLAG_MOD_ADD
+
+parser = optparse.OptionParser("drs_apply_performance.py [options] <host>")
+sambaopts = options.SambaOptions(parser)
+parser.add_option_group(sambaopts)
+parser.add_option_group(options.VersionOptions(parser))
+parser.add_option("--objects", type="int", default=20000,
+                  help="number of objects in the generated domain")
+parser.add_option("--groups", type="int", default=20,
+                  help="number of groups the objects are spread over")
+
+subunitopts = SubunitOptions(parser)
+parser.add_option_group(subunitopts)
+
+credopts = options.CredentialsOptions(parser)
+parser.add_option_group(credopts)
+opts, args = parser.parse_args()
+
+if len(args) < 1:
+    parser.print_usage()
+    sys.exit(1)
+
+host = args[0]
+
+lp = sambaopts.get_loadparm()
+creds = credopts.get_credentials(lp)
+
+BATCH_SIZE = 1000
+
+
+class DrsApplyPerfTests(samba.tests.TestCase):
+    """Generate a large domain over LDAP and clone it with DRS.
+
+    samba-tool drs clone-dc-database pulls the whole domain with
+    GetNCChanges and applies every chunk through
+    dsdb_replicated_objects_commit(), without joining the clone, so it
+    can be repeated against the same DC.
+    """
+
+    def setUp(self):
+        super(DrsApplyPerfTests, self).setUp()
+        self.ldb = SamDB(host, credentials=creds,
+                         session_info=system_session(lp), lp=lp)
+        self.base_dn = self.ldb.domain_dn()
+        self.ou = "OU=drs_apply_perf,%s" % self.base_dn
+        self.ou_objects = "OU=objects,%s" % self.ou
+        self.ou_groups = "OU=groups,%s" % self.ou
+
+        for dn in (self.ou, self.ou_objects, self.ou_groups):
+            self.add_if_possible({
+                "dn": dn,
+                "objectclass": "organizationalUnit"})
+
+    def add_if_possible(self, *args, **kwargs):
+        """The generated domain is kept between the tests on purpose."""
+        try:
+            self.ldb.add(*args, **kwargs)
+        except LdbError:
+            pass
+
+    def _clone(self, what):
+        tmpdir = tempfile.mkdtemp()
+        if '://' in host:
+            server = host.split('://', 1)[1]
+        else:
+            server = host
+
+        t = time.time()
+        result = samba_tool('drs', 'clone-dc-database',
+                            creds.get_realm(),
+                            "-U%s%%%s" % (creds.get_username(),
+                                          creds.get_password()),
+                            '--targetdir=%s' % tmpdir,
+                            '--server=%s' % server)
+        print("cloning %s took %.2fs" % (what, time.time() - t),
+              file=sys.stderr)
+        self.assertIsNone(result)
+
+        shutil.rmtree(tmpdir)
+
+    def test_00_clone_empty(self):
+        # the overhead of a clone without the generated objects
+        self._clone("the base domain")
+
+    def test_01_add_objects(self):
+        t = time.time()
+        for i in range(opts.objects):
+            self.add_if_possible({
+                "dn": "cn=c%d,%s" % (i, self.ou_objects),
+                "objectclass": "contact"})
+        print("adding %d objects took %.2fs" %
+              (opts.objects, time.time() - t), file=sys.stderr)
+
+    def test_02_clone_unlinked(self):
+        self._clone("%d unlinked objects" % opts.objects)
+
+    def test_03_link_objects(self):
+        for g in range(opts.groups):
+            self.add_if_possible({
+                "dn": "cn=g%d,%s" % (g, self.ou_groups),
+                "objectclass": "group"})
+
+        t = time.time()
+        for g in range(opts.groups):
+            members = ["cn=c%d,%s" % (i, self.ou_objects)
+                       for i in range(g, opts.objects, opts.groups)]
+            for s in range(0, len(members), BATCH_SIZE):
+                m = Message()
+                m.dn = Dn(self.ldb, "cn=g%d,%s" % (g, self.ou_groups))
+                m["member"] = MessageElement(members[s:s + BATCH_SIZE],
+                                             FLAG_MOD_ADD, "member")
+                try:
+                    self.ldb.modify(m)
+                except LdbError:
+                    # already linked by an earlier run
+                    pass
+        print("linking %d objects into %d groups took %.2fs" %
+              (opts.objects, opts.groups, time.time() - t),
+              file=sys.stderr)
+
+    def test_04_clone_linked(self):
+        self._clone("%d objects in %d groups" % (opts.objects, opts.groups))
+
+
+if "://" not in host:
+    if os.path.isfile(host):
+        host = "tdb://%s" % host
+    else:
+        host = "ldap://%s" % host
+
+TestProgram(module=__name__, opts=subunitopts)
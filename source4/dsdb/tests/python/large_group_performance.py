@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Time adding and removing members of a single very large group.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+import optparse
+import sys
+sys.path.insert(0, 'bin/python')
+
+import os
+import time
+
+import samba
+import samba.getopt as options
+from samba.tests.subunitrun import SubunitOptions, TestProgram
+from samba.samdb import SamDB
+from samba.auth import system_session
+from ldb import Message, MessageElement, Dn, LdbError
+from ldb import FLAG_MOD_ADD, FLAG_MOD_DELETE
+
+parser = optparse.OptionParser("large_group_performance.py [options] <host>")
+sambaopts = options.SambaOptions(parser)
+parser.add_option_group(sambaopts)
+parser.add_option_group(options.VersionOptions(parser))
+parser.add_option("--members", type="int", default=200000,
+                  help="number of members to add to the group")
+
+subunitopts = SubunitOptions(parser)
+parser.add_option_group(subunitopts)
+
+credopts = options.CredentialsOptions(parser)
+parser.add_option_group(credopts)
+opts, args = parser.parse_args()
+
+if len(args) < 1:
+    parser.print_usage()
+    sys.exit(1)
+
+host = args[0]
+
+lp = sambaopts.get_loadparm()
+creds = credopts.get_credentials(lp)
+
+BATCH_SIZE = 1000
+SINGLE_ROUNDS = 100
+
+
+class LargeGroupPerfTests(samba.tests.TestCase):
+    """Fill one group with --members members.
+
+    Each member add or delete goes through replmd_modify_la_add() or
+    replmd_modify_la_delete(), which rewrite the whole member attribute,
+    so the time per batch shows how that cost grows with the group.
+
+    This measures the existing storage format, where the cost is
+    linear in the size of the group. It is the baseline for a link
+    storage format that would make it sublinear.
+    """
+
+    def setUp(self):
+        super(LargeGroupPerfTests, self).setUp()
+        self.ldb = SamDB(host, credentials=creds,
+                         session_info=system_session(lp), lp=lp)
+        self.base_dn = self.ldb.domain_dn()
+        self.ou = "OU=large_group_perf,%s" % self.base_dn
+        self.ou_members = "OU=members,%s" % self.ou
+        self.group = "CN=large_group,%s" % self.ou
+
+        for dn in (self.ou, self.ou_members):
+            self.add_if_possible({
+                "dn": dn,
+                "objectclass": "organizationalUnit"})
+        self.add_if_possible({
+            "dn": self.group,
+            "objectclass": "group"})
+
+    def add_if_possible(self, *args, **kwargs):
+        """The group is kept between the tests on purpose."""
+        try:
+            self.ldb.add(*args, **kwargs)
+        except LdbError:
+            pass
+
+    def member_dn(self, i):
+        return "cn=m%d,%s" % (i, self.ou_members)
+
+    def modify_members(self, members, flag):
+        m = Message()
+        m.dn = Dn(self.ldb, self.group)
+        m["member"] = MessageElement(members, flag, "member")
+        self.ldb.modify(m)
+
+    def test_00_add_objects(self):
+        t = time.time()
+        for s in range(0, opts.members, BATCH_SIZE):
+            ldif = "".join("dn: %s\nobjectclass: contact\n\n" %
+                           self.member_dn(i)
+                           for i in range(s, min(s + BATCH_SIZE,
+                                                 opts.members)))
+            try:
+                self.ldb.add_ldif(ldif)
+            except LdbError:
+                # already there from an earlier run
+                pass
+        print("adding %d objects took %.2fs" %
+              (opts.members, time.time() - t), file=sys.stderr)
+
+    def test_01_add_members(self):
+        # print the cost of a batch every tenth of the way, to show
+        # how it grows with the size of the group
+        step = max(opts.members // 10, BATCH_SIZE)
+        start = time.time()
+        t = start
+        last = 0
+        for s in range(0, opts.members, BATCH_SIZE):
+            members = [self.member_dn(i)
+                       for i in range(s, min(s + BATCH_SIZE,
+                                             opts.members))]
+            try:
+                self.modify_members(members, FLAG_MOD_ADD)
+            except LdbError:
+                # already linked by an earlier run
+                pass
+
+            done = s + len(members)
+            if done - last >= step or done == opts.members:
+                print("%d members: the last %d took %.2fs" %
+                      (done, done - last, time.time() - t),
+                      file=sys.stderr)
+                last = done
+                t = time.time()
+        print("adding %d members took %.2fs" %
+              (opts.members, time.time() - start), file=sys.stderr)
+
+    def test_02_remove_and_add_single_member(self):
+        # one member at a time in a full group, the common case
+        t = time.time()
+        for i in range(SINGLE_ROUNDS):
+            member = self.member_dn(i * (opts.members // SINGLE_ROUNDS))
+            self.modify_members([member], FLAG_MOD_DELETE)
+            self.modify_members([member], FLAG_MOD_ADD)
+        print("%d single member deletes and adds in a group of %d "
+              "took %.2fs" % (SINGLE_ROUNDS, opts.members, time.time() - t),
+              file=sys.stderr)
+
+    def test_03_remove_members(self):
+        t = time.time()
+        for s in range(0, opts.members, BATCH_SIZE):
+            members = [self.member_dn(i)
+                       for i in range(s, min(s + BATCH_SIZE,
+                                             opts.members))]
+            self.modify_members(members, FLAG_MOD_DELETE)
+        print("removing %d members took %.2fs" %
+              (opts.members, time.time() - t), file=sys.stderr)
+
+    def test_04_cleanup(self):
+        self.ldb.delete(self.ou, ["tree_delete:1"])
+
+
+if "://" not in host:
+    if os.path.isfile(host):
+        host = "tdb://%s" % host
+    else:
+        host = "ldap://%s" % host
+
+TestProgram(module=__name__, opts=subunitopts)
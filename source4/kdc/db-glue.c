@@ -41,6 +41,7 @@
 #include "kdc/pac-glue.h"
 #include "librpc/gen_ndr/ndr_irpc_c.h"
 #include "lib/messaging/irpc.h"
+#include "lib/util/memcache.h"
 
 #undef DBGC_CLASS
 #define DBGC_CLASS DBGC_KERBEROS
@@ -2387,6 +2388,262 @@ static krb5_error_code samba_kdc_lookup_client(krb5_context context,
 	return 0;
 }
 
+/*
+ * Every TGS-REQ looks up the krbtgt account and the service account
+ * in sam.ldb, which includes decrypting their secrets. During logon
+ * storms the same few accounts are asked for over and over, so the
+ * search results of TGS-REQ lookups are kept in memory.
+ *
+ * The cache is flushed whenever the uSNHighest of the domain
+ * partition moves, which catches password changes, group membership
+ * and account control changes, whether done locally or through
+ * replication. The non-replicated logon accounting attributes don't
+ * move it. Values computed from the current time (lockout expiry,
+ * password expiry) are bounded by "kdc:entry cache lifetime".
+ *
+ * AS-REQs always go to the database, so that password checks and
+ * lockout see the current state of the account.
+ */
+#define SAMBA_KDC_ENTRY_CACHE_SIZE (16*1024*1024)
+#define SAMBA_KDC_ENTRY_CACHE_LIFETIME 60
+
+struct samba_kdc_entry_cache {
+	struct memcache *msgs;
+	uint64_t usn;
+	time_t lifetime;
+};
+
+struct samba_kdc_cached_msg {
+	time_t expires;
+	struct ldb_dn *realm_dn;
+	struct ldb_message *msg;
+};
+
+static const char *samba_kdc_secret_attrs[] = {
+	DSDB_SECRET_ATTRIBUTES,
+	NULL
+};
+
+static struct samba_kdc_entry_cache *samba_kdc_entry_cache_init(
+	TALLOC_CTX *mem_ctx, struct loadparm_context *lp_ctx)
+{
+	struct samba_kdc_entry_cache *cache = NULL;
+	size_t size;
+
+	size = lpcfg_parm_ulong(lp_ctx, NULL, "kdc", "entry cache size",
+				SAMBA_KDC_ENTRY_CACHE_SIZE);
+	if (size == 0) {
+		return NULL;
+	}
+
+	cache = talloc_zero(mem_ctx, struct samba_kdc_entry_cache);
+	if (cache == NULL) {
+		return NULL;
+	}
+	cache->lifetime = lpcfg_parm_int(lp_ctx, NULL, "kdc",
+					 "entry cache lifetime",
+					 SAMBA_KDC_ENTRY_CACHE_LIFETIME);
+	if (cache->lifetime <= 0) {
+		TALLOC_FREE(cache);
+		return NULL;
+	}
+
+	cache->msgs = memcache_init(cache, size);
+	if (cache->msgs == NULL) {
+		TALLOC_FREE(cache);
+		return NULL;
+	}
+
+	return cache;
+}
+
+/*
+ * Throw away the cached entries if the domain partition has changed
+ * since they were stored. Returns false if the cache must not be used.
+ */
+static bool samba_kdc_entry_cache_validate(
+	struct samba_kdc_db_context *kdc_db_ctx)
+{
+	struct samba_kdc_entry_cache *cache = kdc_db_ctx->entry_cache;
+	struct ldb_context *samdb = kdc_db_ctx->samdb;
+	uint64_t usn = 0;
+	int ret;
+
+	if (cache == NULL) {
+		return false;
+	}
+
+	ret = dsdb_load_partition_usn(samdb,
+				      ldb_get_default_basedn(samdb),
+				      &usn,
+				      NULL);
+	if (ret != LDB_SUCCESS) {
+		DBG_NOTICE("Failed to load uSNHighest: %s\n",
+			   ldb_strerror(ret));
+		memcache_flush(cache->msgs, KDC_ENTRY_CACHE_TALLOC);
+		cache->usn = 0;
+		return false;
+	}
+
+	if (usn != cache->usn) {
+		memcache_flush(cache->msgs, KDC_ENTRY_CACHE_TALLOC);
+		cache->usn = usn;
+	}
+
+	return true;
+}
+
+/*
+ * Deep copy of msg with the secret attributes wiped on free
+ */
+static struct ldb_message *samba_kdc_entry_cache_copy_msg(
+	TALLOC_CTX *mem_ctx, const struct ldb_message *msg)
+{
+	struct ldb_message *copy = NULL;
+	size_t i;
+
+	copy = ldb_msg_copy(mem_ctx, msg);
+	if (copy == NULL) {
+		return NULL;
+	}
+
+	for (i = 0; samba_kdc_secret_attrs[i] != NULL; i++) {
+		struct ldb_message_element *el = NULL;
+		unsigned int j;
+
+		el = ldb_msg_find_element(copy, samba_kdc_secret_attrs[i]);
+		if (el == NULL) {
+			continue;
+		}
+		for (j = 0; j < el->num_values; j++) {
+			if (el->values[j].data != NULL) {
+				talloc_keep_secret(el->values[j].data);
+			}
+		}
+	}
+
+	return copy;
+}
+
+static bool samba_kdc_entry_cache_lookup(
+	struct samba_kdc_db_context *kdc_db_ctx,
+	TALLOC_CTX *mem_ctx,
+	const char *key,
+	struct ldb_dn **realm_dn,
+	struct ldb_message **msg)
+{
+	struct samba_kdc_entry_cache *cache = kdc_db_ctx->entry_cache;
+	struct samba_kdc_cached_msg *cached = NULL;
+	struct ldb_message *msg_copy = NULL;
+	struct ldb_dn *realm_dn_copy = NULL;
+
+	cached = memcache_lookup_talloc(cache->msgs,
+					KDC_ENTRY_CACHE_TALLOC,
+					data_blob_string_const(key));
+	if (cached == NULL) {
+		return false;
+	}
+
+	if (cached->expires <= time(NULL)) {
+		memcache_delete(cache->msgs,
+				KDC_ENTRY_CACHE_TALLOC,
+				data_blob_string_const(key));
+		return false;
+	}
+
+	msg_copy = samba_kdc_entry_cache_copy_msg(mem_ctx, cached->msg);
+	if (msg_copy == NULL) {
+		return false;
+	}
+	if (realm_dn != NULL) {
+		realm_dn_copy = ldb_dn_copy(mem_ctx, cached->realm_dn);
+		if (realm_dn_copy == NULL) {
+			TALLOC_FREE(msg_copy);
+			return false;
+		}
+		*realm_dn = realm_dn_copy;
+	}
+
+	*msg = msg_copy;
+	return true;
+}
+
+static void samba_kdc_entry_cache_store(
+	struct samba_kdc_db_context *kdc_db_ctx,
+	const char *key,
+	struct ldb_dn *realm_dn,
+	const struct ldb_message *msg)
+{
+	struct samba_kdc_entry_cache *cache = kdc_db_ctx->entry_cache;
+	struct samba_kdc_cached_msg *cached = NULL;
+
+	cached = talloc_zero(NULL, struct samba_kdc_cached_msg);
+	if (cached == NULL) {
+		return;
+	}
+	cached->expires = time(NULL) + cache->lifetime;
+
+	cached->msg = samba_kdc_entry_cache_copy_msg(cached, msg);
+	if (cached->msg == NULL) {
+		TALLOC_FREE(cached);
+		return;
+	}
+	cached->realm_dn = ldb_dn_copy(cached, realm_dn);
+	if (cached->realm_dn == NULL) {
+		TALLOC_FREE(cached);
+		return;
+	}
+
+	memcache_add_talloc(cache->msgs,
+			    KDC_ENTRY_CACHE_TALLOC,
+			    data_blob_string_const(key),
+			    &cached);
+}
+
+static bool samba_kdc_entry_cache_usable(
+	struct samba_kdc_db_context *kdc_db_ctx, unsigned flags)
+{
+	if (!(flags & SDB_F_FOR_TGS_REQ) || (flags & SDB_F_FOR_AS_REQ)) {
+		return false;
+	}
+
+	return samba_kdc_entry_cache_validate(kdc_db_ctx);
+}
+
+/*
+ * The cache key for a lookup of principal, NULL if the lookup must not
+ * be cached
+ */
+static char *samba_kdc_entry_cache_key(krb5_context context,
+				       struct samba_kdc_db_context *kdc_db_ctx,
+				       TALLOC_CTX *mem_ctx,
+				       const char *kind,
+				       krb5_const_principal principal,
+				       unsigned flags)
+{
+	char *principal_string = NULL;
+	char *key = NULL;
+	krb5_error_code ret;
+
+	if (!samba_kdc_entry_cache_usable(kdc_db_ctx, flags)) {
+		return NULL;
+	}
+
+	ret = krb5_unparse_name(context, principal, &principal_string);
+	if (ret != 0) {
+		return NULL;
+	}
+
+	key = talloc_asprintf(mem_ctx,
+			      "%s/%d/%s",
+			      kind,
+			      smb_krb5_principal_get_type(context, principal),
+			      principal_string);
+	SAFE_FREE(principal_string);
+
+	return key;
+}
+
 static krb5_error_code samba_kdc_fetch_client(krb5_context context,
 					       struct samba_kdc_db_context *kdc_db_ctx,
 					       TALLOC_CTX *mem_ctx,
@@ -2398,12 +2655,23 @@ static krb5_error_code samba_kdc_fetch_client(krb5_context context,
 	struct ldb_dn *realm_dn;
 	krb5_error_code ret;
 	struct ldb_message *msg = NULL;
-
-	ret = samba_kdc_lookup_client(context, kdc_db_ctx,
-				      mem_ctx, principal, user_attrs,
-				      &realm_dn, &msg);
-	if (ret != 0) {
-		return ret;
+	char *cache_key = NULL;
+
+	cache_key = samba_kdc_entry_cache_key(context, kdc_db_ctx, mem_ctx,
+					      "client", principal, flags);
+	if (cache_key == NULL ||
+	    !samba_kdc_entry_cache_lookup(kdc_db_ctx, mem_ctx, cache_key,
+					  &realm_dn, &msg)) {
+		ret = samba_kdc_lookup_client(context, kdc_db_ctx,
+					      mem_ctx, principal, user_attrs,
+					      &realm_dn, &msg);
+		if (ret != 0) {
+			return ret;
+		}
+		if (cache_key != NULL) {
+			samba_kdc_entry_cache_store(kdc_db_ctx, cache_key,
+						    realm_dn, msg);
+		}
 	}
 
 	ret = samba_kdc_message2entry(context, kdc_db_ctx, mem_ctx,
@@ -2463,6 +2731,8 @@ static krb5_error_code samba_kdc_fetch_krbtgt(krb5_context context,
 
 		int lret;
 		unsigned int krbtgt_number;
+		char *cache_key = NULL;
+		bool cached = false;
 		/* w2k8r2 sometimes gives us a kvno of 255 for inter-domain
 		   trust tickets. We don't yet know what this means, but we do
 		   seem to need to treat it as unspecified */
@@ -2478,7 +2748,21 @@ static krb5_error_code samba_kdc_fetch_krbtgt(krb5_context context,
 			krbtgt_number = kdc_db_ctx->my_krbtgt_number;
 		}
 
-		if (krbtgt_number == kdc_db_ctx->my_krbtgt_number) {
+		if (samba_kdc_entry_cache_usable(kdc_db_ctx, flags)) {
+			cache_key = talloc_asprintf(tmp_ctx, "krbtgt/%u",
+						    krbtgt_number);
+		}
+		if (cache_key != NULL) {
+			cached = samba_kdc_entry_cache_lookup(kdc_db_ctx,
+							      tmp_ctx,
+							      cache_key,
+							      NULL,
+							      &msg);
+		}
+
+		if (cached) {
+			lret = LDB_SUCCESS;
+		} else if (krbtgt_number == kdc_db_ctx->my_krbtgt_number) {
 			lret = dsdb_search_one(kdc_db_ctx->samdb, tmp_ctx,
 					       &msg, kdc_db_ctx->krbtgt_dn, LDB_SCOPE_BASE,
 					       krbtgt_attrs, DSDB_SEARCH_NO_GLOBAL_CATALOG,
@@ -2512,6 +2796,11 @@ static krb5_error_code samba_kdc_fetch_krbtgt(krb5_context context,
 			goto out;
 		}
 
+		if (cache_key != NULL && !cached) {
+			samba_kdc_entry_cache_store(kdc_db_ctx, cache_key,
+						    realm_dn, msg);
+		}
+
 		ret = samba_kdc_message2entry(context, kdc_db_ctx, mem_ctx,
 					      principal, SAMBA_KDC_ENT_TYPE_KRBTGT,
 					      flags, kvno, realm_dn, msg, entry);
@@ -2753,11 +3042,23 @@ static krb5_error_code samba_kdc_fetch_server(krb5_context context,
 	krb5_error_code ret;
 	struct ldb_dn *realm_dn;
 	struct ldb_message *msg;
-
-	ret = samba_kdc_lookup_server(context, kdc_db_ctx, mem_ctx, principal,
-				      flags, server_attrs, &realm_dn, &msg);
-	if (ret != 0) {
-		return ret;
+	char *cache_key = NULL;
+
+	cache_key = samba_kdc_entry_cache_key(context, kdc_db_ctx, mem_ctx,
+					      "server", principal, flags);
+	if (cache_key == NULL ||
+	    !samba_kdc_entry_cache_lookup(kdc_db_ctx, mem_ctx, cache_key,
+					  &realm_dn, &msg)) {
+		ret = samba_kdc_lookup_server(context, kdc_db_ctx, mem_ctx,
+					      principal, flags, server_attrs,
+					      &realm_dn, &msg);
+		if (ret != 0) {
+			return ret;
+		}
+		if (cache_key != NULL) {
+			samba_kdc_entry_cache_store(kdc_db_ctx, cache_key,
+						    realm_dn, msg);
+		}
 	}
 
 	ret = samba_kdc_message2entry(context, kdc_db_ctx, mem_ctx,
@@ -3685,6 +3986,15 @@ NTSTATUS samba_kdc_setup_db_ctx(TALLOC_CTX *mem_ctx, struct samba_kdc_base_conte
 		kdc_db_ctx->my_krbtgt_number = 0;
 		talloc_free(msg);
 	}
+
+	kdc_db_ctx->entry_cache = samba_kdc_entry_cache_init(kdc_db_ctx,
+							     base_ctx->lp_ctx);
+	kdc_db_ctx->group_cache_enabled = lpcfg_parm_bool(base_ctx->lp_ctx,
+							  NULL,
+							  "kdc",
+							  "group cache",
+							  true);
+
 	*kdc_db_ctx_out = kdc_db_ctx;
 	return NT_STATUS_OK;
 }
@@ -306,6 +306,10 @@ static NTSTATUS kdc_task_init(struct task_server *task)
 	kdc->task = task;
 	task->private_data = kdc;
 
+	kdc->max_queued_replies = lpcfg_parm_int(task->lp_ctx, NULL,
+						 "kdc", "max queued replies",
+						 KDC_MAX_QUEUED_REPLIES);
+
 	/* start listening on the configured network interfaces */
 	status = kdc_startup_interfaces(kdc, task->lp_ctx, ifaces,
 					task->model_ops);
@@ -339,6 +343,8 @@ static void kdc_post_fork(struct task_server *task, struct process_details *pd)
 	}
 	kdc = talloc_get_type_abort(task->private_data, struct kdc_server);
 
+	kdc->worker = pd->instances;
+
 	/* get a samdb connection */
 	kdc->samdb = samdb_connect(kdc,
 				   kdc->task->event_ctx,
@@ -534,6 +540,8 @@ static void kdc_post_fork(struct task_server *task, struct process_details *pd)
 	}
 
 	irpc_add_name(task->msg_ctx, "kdc_server");
+
+	kdc_server_stats_start(kdc);
 }
 
 
@@ -543,6 +551,7 @@ NTSTATUS server_service_kdc_init(TALLOC_CTX *ctx)
 	static const struct service_details details = {
 		.inhibit_fork_on_accept = true,
 		.inhibit_pre_fork = false,
+		.pre_fork_per_cpu = true,
 		.task_init = kdc_task_init,
 		.post_fork = kdc_post_fork
 	};
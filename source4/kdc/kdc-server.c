@@ -46,6 +46,9 @@ struct kdc_tcp_connection {
 	struct tstream_context *tstream;
 
 	struct tevent_queue *send_queue;
+
+	/* too many replies queued, we stopped reading requests */
+	bool read_paused;
 };
 
 struct kdc_tcp_call {
@@ -66,6 +69,7 @@ struct kdc_udp_call {
 static void kdc_udp_call_proxy_done(struct tevent_req *subreq);
 static void kdc_udp_call_sendto_done(struct tevent_req *subreq);
 
+static void kdc_tcp_call_loop(struct tevent_req *subreq);
 static void kdc_tcp_call_writev_done(struct tevent_req *subreq);
 static void kdc_tcp_call_proxy_done(struct tevent_req *subreq);
 
@@ -104,10 +108,125 @@ static NTSTATUS kdc_proxy_unavailable_error(struct kdc_server *kdc,
 	return NT_STATUS_OK;
 }
 
+/*
+ * Hand a request to the process function of the socket, keeping count
+ * of the requests and the time spent on them.
+ */
+static kdc_code kdc_call_process(struct kdc_socket *kdc_socket,
+				 TALLOC_CTX *mem_ctx,
+				 DATA_BLOB *in,
+				 DATA_BLOB *out,
+				 struct tsocket_address *remote_address,
+				 struct tsocket_address *local_address,
+				 int datagram)
+{
+	struct kdc_server *kdc = kdc_socket->kdc;
+	struct timespec start;
+	struct timespec end;
+	uint64_t usec;
+	kdc_code ret;
+
+	if (datagram) {
+		kdc->stats.udp_requests += 1;
+	} else {
+		kdc->stats.tcp_requests += 1;
+	}
+
+	clock_gettime_mono(&start);
+	ret = kdc_socket->process(kdc,
+				  mem_ctx,
+				  in,
+				  out,
+				  remote_address,
+				  local_address,
+				  datagram);
+	clock_gettime_mono(&end);
+
+	usec = nsec_time_diff(&end, &start) / 1000;
+	kdc->stats.total_usec += usec;
+	kdc->stats.max_usec = MAX(kdc->stats.max_usec, usec);
+
+	if (ret == KDC_ERROR) {
+		kdc->stats.failed += 1;
+	} else if (ret == KDC_PROXY_REQUEST) {
+		kdc->stats.proxied += 1;
+	}
+
+	return ret;
+}
+
+/*
+ * Log the counters of this process every "kdc:stats interval" seconds,
+ * so the load on the individual pre-fork workers can be compared.
+ */
+static void kdc_server_stats_timer(struct tevent_context *ev,
+				   struct tevent_timer *te,
+				   struct timeval current_time,
+				   void *private_data)
+{
+	struct kdc_server *kdc = talloc_get_type_abort(
+		private_data, struct kdc_server);
+	uint64_t requests = kdc->stats.udp_requests + kdc->stats.tcp_requests;
+	uint64_t avg_usec = 0;
+
+	TALLOC_FREE(kdc->stats.te);
+
+	if (requests != 0) {
+		avg_usec = kdc->stats.total_usec / requests;
+	}
+
+	DBG_NOTICE("worker %u: %"PRIu64" UDP requests, "
+		   "%"PRIu64" TCP requests, %"PRIu64" proxied, "
+		   "%"PRIu64" failed, %"PRIu64" dropped, "
+		   "%"PRIu64"us average, %"PRIu64"us max\n",
+		   kdc->worker,
+		   kdc->stats.udp_requests,
+		   kdc->stats.tcp_requests,
+		   kdc->stats.proxied,
+		   kdc->stats.failed,
+		   kdc->stats.dropped,
+		   avg_usec,
+		   kdc->stats.max_usec);
+
+	/* The maximum is per interval */
+	kdc->stats.max_usec = 0;
+
+	kdc->stats.te = tevent_add_timer(
+		ev,
+		kdc,
+		timeval_current_ofs(kdc->stats.interval, 0),
+		kdc_server_stats_timer,
+		kdc);
+	if (kdc->stats.te == NULL) {
+		DBG_WARNING("Failed to schedule the statistics timer\n");
+	}
+}
+
+void kdc_server_stats_start(struct kdc_server *kdc)
+{
+	kdc->stats.interval = lpcfg_parm_int(kdc->task->lp_ctx, NULL,
+					     "kdc", "stats interval", 0);
+	if (kdc->stats.interval == 0) {
+		return;
+	}
+
+	TALLOC_FREE(kdc->stats.te);
+	kdc->stats.te = tevent_add_timer(
+		kdc->task->event_ctx,
+		kdc,
+		timeval_current_ofs(kdc->stats.interval, 0),
+		kdc_server_stats_timer,
+		kdc);
+	if (kdc->stats.te == NULL) {
+		DBG_WARNING("Failed to schedule the statistics timer\n");
+	}
+}
+
 static void kdc_udp_call_loop(struct tevent_req *subreq)
 {
 	struct kdc_udp_socket *sock = tevent_req_callback_data(subreq,
 				      struct kdc_udp_socket);
+	struct kdc_server *kdc = sock->kdc_socket->kdc;
 	struct kdc_udp_call *call;
 	uint8_t *buf;
 	ssize_t len;
@@ -136,14 +255,31 @@ static void kdc_udp_call_loop(struct tevent_req *subreq)
 		  call->in.length,
 		  tsocket_address_string(call->src, call));
 
+	if (kdc->max_queued_replies != 0 &&
+	    tevent_queue_length(sock->send_queue) >= kdc->max_queued_replies)
+	{
+		/*
+		 * The replies don't go out as fast as the requests come
+		 * in. Drop the request rather than queue up more work,
+		 * the client will retry, possibly with another KDC.
+		 */
+		DBG_INFO("Dropping krb5 UDP packet from %s, "
+			 "%zu replies queued\n",
+			 tsocket_address_string(call->src, call),
+			 tevent_queue_length(sock->send_queue));
+		kdc->stats.dropped += 1;
+		talloc_free(call);
+		goto done;
+	}
+
 	/* Call krb5 */
-	ret = sock->kdc_socket->process(sock->kdc_socket->kdc,
-				       call,
-				       &call->in,
-				       &call->out,
-				       call->src,
-				       sock->kdc_socket->local_address,
-				       1 /* Datagram */);
+	ret = kdc_call_process(sock->kdc_socket,
+			       call,
+			       &call->in,
+			       &call->out,
+			       call->src,
+			       sock->kdc_socket->local_address,
+			       1 /* Datagram */);
 	if (ret == KDC_ERROR) {
 		talloc_free(call);
 		goto done;
@@ -247,6 +383,41 @@ static void kdc_udp_call_sendto_done(struct tevent_req *subreq)
 	talloc_free(call);
 }
 
+/*
+ * Wait for the next request on the connection, unless too many replies
+ * are still waiting to be written. kdc_tcp_call_writev_done() carries
+ * on once they are out.
+ */
+static bool kdc_tcp_read_next(struct kdc_tcp_connection *kdc_conn)
+{
+	uint32_t max_queued = kdc_conn->kdc_socket->kdc->max_queued_replies;
+	struct tevent_req *subreq = NULL;
+
+	if (max_queued != 0 &&
+	    tevent_queue_length(kdc_conn->send_queue) >= max_queued)
+	{
+		kdc_conn->read_paused = true;
+		return true;
+	}
+	kdc_conn->read_paused = false;
+
+	/*
+	 * The krb5 tcp pdu's has the length as 4 byte (initial_read_size),
+	 * packet_full_request_u32 provides the pdu length then.
+	 */
+	subreq = tstream_read_pdu_blob_send(kdc_conn,
+					    kdc_conn->conn->event.ctx,
+					    kdc_conn->tstream,
+					    4, /* initial_read_size */
+					    packet_full_request_u32,
+					    kdc_conn);
+	if (subreq == NULL) {
+		return false;
+	}
+	tevent_req_set_callback(subreq, kdc_tcp_call_loop, kdc_conn);
+	return true;
+}
+
 static void kdc_tcp_call_loop(struct tevent_req *subreq)
 {
 	struct kdc_tcp_connection *kdc_conn = tevent_req_callback_data(subreq,
@@ -290,13 +461,13 @@ static void kdc_tcp_call_loop(struct tevent_req *subreq)
 	call->in.length -= 4;
 
 	/* Call krb5 */
-	ret = kdc_conn->kdc_socket->process(kdc_conn->kdc_socket->kdc,
-					   call,
-					   &call->in,
-					   &call->out,
-					   kdc_conn->conn->remote_address,
-					   kdc_conn->conn->local_address,
-					   0 /* Stream */);
+	ret = kdc_call_process(kdc_conn->kdc_socket,
+			       call,
+			       &call->in,
+			       &call->out,
+			       kdc_conn->conn->remote_address,
+			       kdc_conn->conn->local_address,
+			       0 /* Stream */);
 	if (ret == KDC_ERROR) {
 		kdc_tcp_terminate_connection(kdc_conn,
 				"kdc_tcp_call_loop: process function failed");
@@ -347,22 +518,11 @@ static void kdc_tcp_call_loop(struct tevent_req *subreq)
 	}
 	tevent_req_set_callback(subreq, kdc_tcp_call_writev_done, call);
 
-	/*
-	 * The krb5 tcp pdu's has the length as 4 byte (initial_read_size),
-	 * packet_full_request_u32 provides the pdu length then.
-	 */
-	subreq = tstream_read_pdu_blob_send(kdc_conn,
-					    kdc_conn->conn->event.ctx,
-					    kdc_conn->tstream,
-					    4, /* initial_read_size */
-					    packet_full_request_u32,
-					    kdc_conn);
-	if (subreq == NULL) {
+	if (!kdc_tcp_read_next(kdc_conn)) {
 		kdc_tcp_terminate_connection(kdc_conn, "kdc_tcp_call_loop: "
 				"no memory for tstream_read_pdu_blob_send");
 		return;
 	}
-	tevent_req_set_callback(subreq, kdc_tcp_call_loop, kdc_conn);
 }
 
 static void kdc_tcp_call_proxy_done(struct tevent_req *subreq)
@@ -414,28 +574,18 @@ static void kdc_tcp_call_proxy_done(struct tevent_req *subreq)
 	}
 	tevent_req_set_callback(subreq, kdc_tcp_call_writev_done, call);
 
-	/*
-	 * The krb5 tcp pdu's has the length as 4 byte (initial_read_size),
-	 * packet_full_request_u32 provides the pdu length then.
-	 */
-	subreq = tstream_read_pdu_blob_send(kdc_conn,
-					    kdc_conn->conn->event.ctx,
-					    kdc_conn->tstream,
-					    4, /* initial_read_size */
-					    packet_full_request_u32,
-					    kdc_conn);
-	if (subreq == NULL) {
+	if (!kdc_tcp_read_next(kdc_conn)) {
 		kdc_tcp_terminate_connection(kdc_conn, "kdc_tcp_call_proxy_done: "
 				"no memory for tstream_read_pdu_blob_send");
 		return;
 	}
-	tevent_req_set_callback(subreq, kdc_tcp_call_loop, kdc_conn);
 }
 
 static void kdc_tcp_call_writev_done(struct tevent_req *subreq)
 {
 	struct kdc_tcp_call *call = tevent_req_callback_data(subreq,
 			struct kdc_tcp_call);
+	struct kdc_tcp_connection *kdc_conn = call->kdc_conn;
 	int sys_errno;
 	int rc;
 
@@ -458,6 +608,12 @@ static void kdc_tcp_call_writev_done(struct tevent_req *subreq)
 	/* We don't care about errors */
 
 	talloc_free(call);
+
+	if (kdc_conn->read_paused && !kdc_tcp_read_next(kdc_conn)) {
+		kdc_tcp_terminate_connection(kdc_conn, "kdc_tcp_call_writev_done: "
+				"no memory for tstream_read_pdu_blob_send");
+		return;
+	}
 }
 
 /*
@@ -30,6 +30,9 @@
 struct tsocket_address;
 struct model_ops;
 
+/* default for "kdc:max queued replies" */
+#define KDC_MAX_QUEUED_REPLIES 256
+
 /*
  * Context structure for the kdc server
  */
@@ -42,6 +45,25 @@ struct kdc_server {
 	uint32_t proxy_timeout;
 	const char *kpasswd_keytab_name;
 	void *private_data;
+
+	/* pre-fork worker number, 0 without pre-forking */
+	unsigned int worker;
+	/*
+	 * Replies we queue on a UDP socket or TCP connection before we
+	 * stop taking new requests from it, 0 means no limit.
+	 */
+	uint32_t max_queued_replies;
+	struct {
+		uint64_t udp_requests;
+		uint64_t tcp_requests;
+		uint64_t proxied;
+		uint64_t failed;
+		uint64_t dropped;
+		uint64_t total_usec;
+		uint64_t max_usec;
+		uint32_t interval;
+		struct tevent_timer *te;
+	} stats;
 };
 
 typedef enum kdc_code_e {
@@ -80,4 +102,6 @@ NTSTATUS kdc_add_socket(struct kdc_server *kdc,
 			kdc_process_fn_t process,
 			bool udp_only);
 
+void kdc_server_stats_start(struct kdc_server *kdc);
+
 #endif /* _KDC_SERVER_H */
@@ -1106,6 +1106,38 @@ NTSTATUS samba_kdc_get_claims_blob(TALLOC_CTX *mem_ctx,
 	return NT_STATUS_OK;
 }
 
+/*
+ * The group cache is a tdb shared by all KDC processes. Open it
+ * lazily, as the database context is set up before the workers are
+ * forked and a tdb handle must not be used across a fork.
+ */
+static struct db_context *samba_kdc_group_cache(
+	struct samba_kdc_db_context *kdc_db_ctx)
+{
+	pid_t pid = getpid();
+
+	if (!kdc_db_ctx->group_cache_enabled) {
+		return NULL;
+	}
+
+	if (kdc_db_ctx->group_cache != NULL &&
+	    kdc_db_ctx->group_cache_pid == pid) {
+		return kdc_db_ctx->group_cache;
+	}
+
+	TALLOC_FREE(kdc_db_ctx->group_cache);
+	kdc_db_ctx->group_cache = authsam_group_cache_open(kdc_db_ctx,
+							   kdc_db_ctx->lp_ctx);
+	if (kdc_db_ctx->group_cache == NULL) {
+		/* Don't try again for every ticket */
+		kdc_db_ctx->group_cache_enabled = false;
+		return NULL;
+	}
+	kdc_db_ctx->group_cache_pid = pid;
+
+	return kdc_db_ctx->group_cache;
+}
+
 krb5_error_code samba_kdc_get_user_info_from_db(TALLOC_CTX *mem_ctx,
 						struct ldb_context *samdb,
 						struct samba_kdc_entry *entry,
@@ -1136,16 +1168,18 @@ krb5_error_code samba_kdc_get_user_info_from_db(TALLOC_CTX *mem_ctx,
 		struct auth_user_info_dc *info_from_db = NULL;
 		struct loadparm_context *lp_ctx = entry->kdc_db_ctx->lp_ctx;
 
-		nt_status = authsam_make_user_info_dc(entry,
-						      samdb,
-						      lpcfg_netbios_name(lp_ctx),
-						      lpcfg_sam_name(lp_ctx),
-						      lpcfg_sam_dnsname(lp_ctx),
-						      entry->realm_dn,
-						      msg,
-						      data_blob_null,
-						      data_blob_null,
-						      &info_from_db);
+		nt_status = authsam_make_user_info_dc_cached(
+			entry,
+			samdb,
+			samba_kdc_group_cache(entry->kdc_db_ctx),
+			lpcfg_netbios_name(lp_ctx),
+			lpcfg_sam_name(lp_ctx),
+			lpcfg_sam_dnsname(lp_ctx),
+			entry->realm_dn,
+			msg,
+			data_blob_null,
+			data_blob_null,
+			&info_from_db);
 		if (!NT_STATUS_IS_OK(nt_status)) {
 			DBG_ERR("Getting user info for PAC failed: %s\n",
 				nt_errstr(nt_status));
@@ -41,6 +41,8 @@ struct samba_kdc_base_context {
 };
 
 struct samba_kdc_seq;
+struct samba_kdc_entry_cache;
+struct db_context;
 
 struct samba_kdc_db_context {
 	struct tevent_context *ev_ctx;
@@ -52,6 +54,10 @@ struct samba_kdc_db_context {
 	unsigned int my_krbtgt_number;
 	struct ldb_dn *krbtgt_dn;
 	struct samba_kdc_policy policy;
+	struct samba_kdc_entry_cache *entry_cache;
+	bool group_cache_enabled;
+	struct db_context *group_cache;
+	pid_t group_cache_pid;
 };
 
 struct samba_kdc_entry {
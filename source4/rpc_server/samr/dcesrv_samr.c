@@ -452,7 +452,11 @@ static NTSTATUS dcesrv_samr_OpenDomain(struct dcesrv_call_state *dce_call, TALLO
 		return NT_STATUS_NO_MEMORY;
 	}
 
-	d_state->domain_sid = talloc_steal(d_state, r->in.sid);
+	d_state->domain_sid = dom_sid_dup(d_state, r->in.sid);
+	if (d_state->domain_sid == NULL) {
+		talloc_free(d_state);
+		return NT_STATUS_NO_MEMORY;
+	}
 
 	if (dom_sid_equal(d_state->domain_sid, &global_sid_Builtin)) {
 		d_state->builtin = true;
@@ -176,6 +176,60 @@ static NTSTATUS dcesrv_task_init(struct task_server *task)
 	return NT_STATUS_OK;
 }
 
+static void dcesrv_stats_timer(struct tevent_context *ev,
+			       struct tevent_timer *te,
+			       struct timeval current_time,
+			       void *private_data)
+{
+	struct dcesrv_context *dce_ctx = talloc_get_type_abort(
+		private_data, struct dcesrv_context);
+	int interval;
+
+	dcesrv_call_stats_log(dce_ctx);
+
+	interval = lpcfg_parm_int(dce_ctx->lp_ctx, NULL,
+				  "dcesrv", "stats interval", 0);
+	if (interval <= 0) {
+		return;
+	}
+
+	te = tevent_add_timer(ev,
+			      dce_ctx,
+			      timeval_current_ofs(interval, 0),
+			      dcesrv_stats_timer,
+			      dce_ctx);
+	if (te == NULL) {
+		DBG_WARNING("Failed to schedule the statistics timer\n");
+	}
+}
+
+/*
+ * Log the latency of the calls every "dcesrv:stats interval" seconds
+ */
+static void dcesrv_stats_start(struct task_server *task,
+			       struct dcesrv_context *dce_ctx)
+{
+	struct tevent_timer *te = NULL;
+	int interval;
+
+	interval = lpcfg_parm_int(task->lp_ctx, NULL,
+				  "dcesrv", "stats interval", 0);
+	if (interval <= 0) {
+		return;
+	}
+
+	dce_ctx->call_stats.enabled = true;
+
+	te = tevent_add_timer(task->event_ctx,
+			      dce_ctx,
+			      timeval_current_ofs(interval, 0),
+			      dcesrv_stats_timer,
+			      dce_ctx);
+	if (te == NULL) {
+		DBG_WARNING("Failed to schedule the statistics timer\n");
+	}
+}
+
 /*
  * Initialise the endpoints that need to run in a single process fork.
  * The endpoint registration is only done for the first process instance.
@@ -211,6 +265,8 @@ static void dcesrv_post_fork(struct task_server *task,
 	}
 
 	irpc_add_name(task->msg_ctx, "rpc_server");
+
+	dcesrv_stats_start(task, dce_ctx);
 }
 
 NTSTATUS server_service_rpc_init(TALLOC_CTX *ctx)
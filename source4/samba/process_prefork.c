@@ -46,6 +46,9 @@
 #include "lib/messaging/irpc.h"
 #include "lib/util/util_process.h"
 #include "server_util.h"
+#include "dsdb/samdb/samdb.h"
+#include "auth/session.h"
+#include "libds/common/roles.h"
 
 #define min(a, b) (((a) < (b)) ? (a) : (b))
 
@@ -158,6 +161,59 @@ static void prefork_reload_after_fork(void)
 	force_check_log_size();
 }
 
+/*
+ * Make sure the process-global dsdb schema is current before a worker is
+ * forked.
+ *
+ * The compiled schema is held in a process-global (see
+ * dsdb_make_schema_global()), so a worker forked after it has been loaded
+ * shares it copy-on-write with the master and its siblings, and only needs
+ * to compare the schema sequence number on first use.  The master never
+ * services requests, so without this it would keep the schema primed by
+ * the top-level process and, after a schema change, every worker started
+ * or restarted would compile its own private copy.
+ */
+static void prefork_refresh_schema(struct tevent_context *ev,
+				   struct loadparm_context *lp_ctx)
+{
+	static struct ldb_context *samdb = NULL;
+	struct dsdb_schema *schema = NULL;
+
+	if (lpcfg_server_role(lp_ctx) != ROLE_ACTIVE_DIRECTORY_DC) {
+		return;
+	}
+
+	if (samdb == NULL) {
+		/*
+		 * Deliberately left open (and not parented on ev, which
+		 * the workers free) so the handle, and the sequence
+		 * number cache in schema_load, is reused for every
+		 * worker this master forks.
+		 */
+		samdb = samdb_connect(NULL,
+				      ev,
+				      lp_ctx,
+				      system_session(lp_ctx),
+				      NULL,
+				      0);
+		if (samdb == NULL) {
+			DBG_WARNING("Unable to open sam.ldb, workers will "
+				    "load the schema themselves\n");
+			return;
+		}
+	}
+
+	/* This reloads the global schema if the schema USN has changed */
+	schema = dsdb_get_schema(samdb, NULL);
+	if (schema == NULL) {
+		DBG_WARNING("Unable to load the schema, workers will "
+			    "load it themselves\n");
+		return;
+	}
+	DBG_DEBUG("Forking with schema at USN %"PRIu64"\n",
+		  schema->metadata_usn);
+}
+
 /*
  * clean up any messaging associated with the old process.
  *
@@ -374,6 +430,17 @@ static void prefork_fork_master(
 	{
 		int default_children;
 		default_children = lpcfg_prefork_children(lp_ctx);
+		if (service_details->default_pre_fork_children != 0) {
+			default_children =
+				service_details->default_pre_fork_children;
+		}
+		if (service_details->pre_fork_per_cpu &&
+		    lpcfg_parm_is_unspecified(lp_ctx, "prefork children")) {
+			long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+			if (cpus > 0) {
+				default_children = cpus;
+			}
+		}
 		num_children = lpcfg_parm_int(lp_ctx, NULL, "prefork children",
 			                      service_name, default_children);
 	}
@@ -750,6 +817,8 @@ static void prefork_fork_worker(struct task_server *task,
 	struct tfork *w = NULL;
 	pid_t pid;
 
+	prefork_refresh_schema(ev, lp_ctx);
+
 	w = tfork_create();
 	if (w == NULL) {
 		smb_panic("failure in tfork\n");
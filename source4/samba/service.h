@@ -49,6 +49,17 @@ struct service_details {
 	 * inhibit_fork_on_accept set.
 	 */
 	bool inhibit_pre_fork;
+	/*
+	 * The number of pre-fork workers to start if
+	 * "prefork children:<service>" is not set. Zero means the
+	 * value of "prefork children".
+	 */
+	unsigned int default_pre_fork_children;
+	/*
+	 * Start one pre-fork worker per online CPU if neither
+	 * "prefork children" nor "prefork children:<service>" is set.
+	 */
+	bool pre_fork_per_cpu;
 	/*
 	 * Initialise the server task.
 	 */
@@ -2082,10 +2082,14 @@ planoldpythontestsuite("ad_dc:local",
 #
 plantestsuite("samba4.dsdb.samdb.ldb_modules.unique_object_sids", "none",
               [os.path.join(bindir(), "test_unique_object_sids")])
+plantestsuite("samba4.dsdb.samdb.ldb_modules.repl_meta_data", "none",
+              [os.path.join(bindir(), "test_repl_meta_data")])
 plantestsuite("samba4.dsdb.samdb.ldb_modules.encrypted_secrets.tdb", "none",
               [os.path.join(bindir(), "test_encrypted_secrets_tdb")])
 plantestsuite("samba4.dsdb.samdb.ldb_modules.encrypted_secrets.mdb", "none",
               [os.path.join(bindir(), "test_encrypted_secrets_mdb")])
+plantestsuite("samba4.dsdb.repl.drepl_out_helpers", "none",
+              [os.path.join(bindir(), "test_drepl_out_helpers")])
 plantestsuite("lib.audit_logging.audit_logging", "none",
               [os.path.join(bindir(), "audit_logging_test")])
 plantestsuite("lib.audit_logging.audit_logging.errors", "none",
@@ -2110,8 +2114,12 @@ plantestsuite("librpc.ndr.ndr", "none",
               [os.path.join(bindir(), "test_ndr")])
 plantestsuite("librpc.ndr.ndr_macros", "none",
               [os.path.join(bindir(), "test_ndr_macros")])
+plantestsuite("librpc.ndr.ndr_pull_pool", "none",
+              [os.path.join(bindir(), "test_ndr_pull_pool")])
 plantestsuite("librpc.ndr.ndr_dns_nbt", "none",
               [os.path.join(bindir(), "test_ndr_dns_nbt")])
+plantestsuite("librpc.rpc.dcesrv_core", "none",
+              [os.path.join(bindir(), "test_dcesrv_core")])
 plantestsuite("libcli.ldap.ldap_message", "none",
               [os.path.join(bindir(), "test_ldap_message")])
 